@@ -0,0 +1,101 @@
+/**
+ * @file assembler.h
+ * @brief Header file for the XM23P assembler
+ *
+ * @author Zach Fraser
+ * @date 2024-09-11
+ */
+
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "definitions.h"
+
+#define ASSEMBLY_EXTENSION ".asm"
+#define ASSEMBLY_LINE_LENGTH 256            /* Longest source line assembled - longer lines are truncated */
+#define ASSEMBLY_OPERANDS 3                 /* Most operands of any instruction */
+#define ASSEMBLY_NAME_LENGTH 36             /* Longest symbol name including terminator */
+#define ASSEMBLY_RECORD_DATA 30             /* Data bytes per S1/S2 record */
+#define ASSEMBLY_INITIAL_LENGTH 64          /* Initial capacity of the growable arrays */
+
+/* Listing value column */
+#define LISTING_NONE 0
+#define LISTING_WORD 1
+
+/**
+ * @brief Symbol table categories - in listing order
+ */
+typedef enum symbol_type_t
+{
+    SYMBOL_EQUATE,
+    SYMBOL_CODE,
+    SYMBOL_DATA,
+    SYMBOL_REGISTER
+} symbol_type_t;
+
+/**
+ * @brief Symbol table entry
+ */
+typedef struct assembly_symbol_t
+{
+    char name[ASSEMBLY_NAME_LENGTH];
+    symbol_type_t type;
+    word_t value;
+    int line;                               /* Defining source line */
+    int defined;                            /* 0 while only referenced */
+} assembly_symbol_t;
+
+/**
+ * @brief Source line as listed
+ */
+typedef struct assembly_line_t
+{
+    int start;                              /* Offset of the line in the source */
+    int length;                             /* Length excluding the line ending */
+    int listing;                            /* LISTING_NONE or LISTING_WORD */
+    word_t address;
+    word_t value;
+    const char *error;                      /* NULL if the line assembled */
+} assembly_line_t;
+
+/**
+ * @brief Assembled program - records in load order, symbols and listing
+ *
+ * Zero initialise before the first assembly. An assembly may be reused for
+ * the next source without releasing it in between.
+ */
+typedef struct assembly_t
+{
+    char name[MAX_PATH_LENGTH];             /* Source base name - S0 record */
+    char *source;                           /* Copy of the source text */
+    s_record_t *records;
+    int record_count;
+    int record_capacity;
+    assembly_symbol_t *symbols;
+    int symbol_count;
+    int symbol_capacity;
+    assembly_line_t *lines;
+    int line_count;
+    int line_capacity;
+    int error_count;
+    int passes;                             /* 2 if a symbol was used before its definition */
+    word_t starting_address;
+} assembly_t;
+
+/* Function Prototypes */
+int assemble_source(assembly_t *assembly, const char *source, const char *name);
+int assemble_file(assembly_t *assembly, const char *path);
+int write_assembly_records(assembly_t *assembly, FILE *file);
+int write_assembly_listing(assembly_t *assembly, FILE *file, const char *records_path);
+void print_assembly_errors(assembly_t *assembly);
+void release_assembly(assembly_t *assembly);
+int is_assembly_path(const char *path);
+
+#endif /* ASSEMBLER_H */
@@ -0,0 +1,101 @@
+/**
+ * @file batch.h
+ * @brief Header file for lockstep execution of many instances of one program
+ *
+ * @author Zach Fraser
+ * @date 2024-09-15
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "definitions.h"
+#include "memory_access.h"
+#include "decode_table.h"
+#include "instruction_functions.h"
+#include "metrics.h"
+
+#define BATCH_OPTION "-b"                   /* Command line option - number of lanes and instructions per lane */
+#define SWEEP_OPTION "-bs"                  /* Command line option - initial registers and data of each lane */
+#define BATCH_BREAKPOINT_OPTION "-bb"       /* Command line option - breakpoint address stopping each lane */
+#define MAX_LANES 1024                      /* Each lane holds a 64KiB data memory */
+#define LANE_MEMORY_LENGTH (DATA_MEMORY_LENGTH + MEMORY_GUARD_LENGTH)
+#define SWEEP_LINE_LENGTH 1024
+
+/* Lane selected by a mask word */
+#define LANE_ON 0xFFFF
+#define LANE_OFF 0x0000
+/* Masked update - new value in enabled lanes, old value elsewhere */
+#define LANE_SELECT(mask, new_value, old_value) ((word_t)(((new_value) & (mask)) | ((old_value) & ~(mask))))
+
+/**
+ * @brief Lane run state - a lane stops in any state but LANE_RUNNING
+ */
+typedef enum lane_state_t
+{
+    LANE_RUNNING,
+    LANE_BREAKPOINT,        /* Breakpoint reached */
+    LANE_LIMIT,             /* Instruction limit reached */
+    LANE_UNSUPPORTED,       /* SVC or device register access - needs the pipelined core */
+    NUM_OF_LANE_STATES
+} lane_state_t;
+
+/**
+ * @brief Redirection of a lane by the instruction just executed
+ */
+typedef enum lane_flush_t
+{
+    FLUSH_NONE,
+    FLUSH_FETCH,            /* Branch, MOV or SWAP into PC - fetched instruction discarded */
+    FLUSH_LOAD              /* LD or LDR into PC - next instruction discarded */
+} lane_flush_t;
+
+/**
+ * @brief Instances of one program run in lockstep
+ *
+ * Lane state is held as structure of arrays, one entry per lane in each
+ * array, so a handler updates a register of every lane in one loop. Each
+ * step executes the instruction at the lowest next address among running
+ * lanes; lanes elsewhere, or dropped by CEX, are masked off and wait for
+ * the others to reach their address.
+ */
+typedef struct batch_t
+{
+    int lane_count;
+    int instruction_limit;                  /* Instructions run by each lane before it stops */
+    word_t breakpoint;                      /* Address compared as the pipeline does */
+    const byte_t *instruction_memory;       /* Shared program image */
+    const word_t *constants;                /* Constant table selected by RC */
+
+    word_t *registers[REGISTER_FILE_LENGTH]; /* registers[register][lane] - PC holds the fetch address */
+    word_t *psw;
+    word_t *next;                           /* Address of the next instruction of each lane */
+    word_t *selected;                       /* Lanes at the current address - LANE_ON or LANE_OFF */
+    word_t *mask;                           /* Selected lanes not dropped by CEX */
+    word_t *fetched;                        /* Address fetched while the instruction executes */
+    unsigned int *skip_mask;                /* CEX predicate for the next decodes, next in bit 0 */
+    byte_t *skip_count;                     /* Decodes covered by the predicate */
+    byte_t *flush;                          /* lane_flush_t of the current instruction */
+    byte_t *state;                          /* lane_state_t */
+    int *instructions;                      /* Instructions executed, excluding those dropped by CEX */
+    byte_t *data_memory;                    /* Private data memory of each lane - LANE_MEMORY_LENGTH apart */
+    const byte_t *page_attributes;          /* Device pages stop the lane */
+
+    long long steps;                        /* Instructions issued to the lanes */
+    long long lane_slots;                   /* Lanes enabled over all steps */
+    double seconds;                         /* Host time of the run */
+} batch_t;
+
+/* Function Prototypes */
+int create_batch(batch_t *batch, program_t *program, int lane_count, int instruction_limit);
+int load_sweep(batch_t *batch, const char *path);
+int run_batch(batch_t *batch);
+void print_batch(batch_t *batch, FILE *file);
+void release_batch(batch_t *batch);
+
+#endif /* BATCH_H */
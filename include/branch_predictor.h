@@ -0,0 +1,85 @@
+/**
+ * @file branch_predictor.h
+ * @brief Header file for the branch prediction model
+ *
+ * @author Zach Fraser
+ * @date 2024-08-26
+ */
+
+#ifndef BRANCH_PREDICTOR_H
+#define BRANCH_PREDICTOR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "statistics.h"
+
+#define PREDICTOR_TABLE_LENGTH 1024         /* Two bit counters in bimodal and gshare tables */
+#define PREDICTOR_HISTORY_MASK (PREDICTOR_TABLE_LENGTH - 1) /* Global history bits used by gshare */
+#define BTB_LENGTH 64                       /* Direct mapped branch target buffer entries */
+#define BRANCH_SITE_LENGTH (INSTRUCTION_MEMORY_LENGTH / WORD_LENGTH)   /* One site per instruction word */
+#define BRANCH_REPORT_LENGTH 10             /* Sites listed in the report */
+#define COUNTER_WEAKLY_TAKEN 2              /* Two bit counters predict taken at or above this value */
+#define COUNTER_MAX 3
+
+/**
+ * @brief Prediction schemes
+ */
+typedef enum predictor_type_t
+{
+    PREDICTOR_NONE,         /* Model disabled */
+    PREDICTOR_NOT_TAKEN,    /* Static - matches the emulated pipeline */
+    PREDICTOR_BTFN,         /* Static - unconditional and backward taken, forward not taken */
+    PREDICTOR_BIMODAL,      /* Two bit counter per address */
+    PREDICTOR_GSHARE,       /* Two bit counter indexed by address xor global history */
+    PREDICTOR_BTB,          /* Branch target buffer - predicts taken only on a hit */
+    NUM_OF_PREDICTORS
+} predictor_type_t;
+
+/**
+ * @brief Outcomes seen at one branch instruction
+ */
+typedef struct branch_site_t
+{
+    unsigned int executed;
+    unsigned int taken;
+    unsigned int mispredicted;
+} branch_site_t;
+
+/**
+ * @brief Branch target buffer entry
+ */
+typedef struct btb_entry_t
+{
+    word_t address;         /* Branch instruction address */
+    word_t target;          /* Last taken target */
+    byte_t valid;
+    byte_t counter;         /* Two bit direction counter */
+} btb_entry_t;
+
+/**
+ * @brief Predictor state and results - preserved across loads, cleared on restart
+ */
+typedef struct branch_predictor_t
+{
+    predictor_type_t type;
+    byte_t counters[PREDICTOR_TABLE_LENGTH];
+    word_t history;                         /* Global outcomes, most recent in bit 0 */
+    btb_entry_t btb[BTB_LENGTH];
+    unsigned int branches;
+    unsigned int mispredicted;
+    unsigned int baseline_penalty;          /* Cycles lost to taken branches in the emulated pipeline */
+    unsigned int predicted_penalty;         /* Cycles lost to mispredictions under the model */
+    branch_site_t sites[BRANCH_SITE_LENGTH];
+} branch_predictor_t;
+
+/* Function Prototypes */
+int set_branch_predictor(program_t *program, char *name);
+void predict_branch(program_t *program, word_t address, word_t target, int conditional, int taken);
+void reset_branch_predictor(program_t *program);
+void release_branch_predictor(program_t *program);
+void display_branch_predictor(program_t *program);
+
+#endif /* BRANCH_PREDICTOR_H */
@@ -0,0 +1,87 @@
+/**
+ * @file cache.h
+ * @brief Header file for the instruction and data cache model
+ *
+ * @author Zach Fraser
+ * @date 2024-08-28
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+
+#define CACHE_REGION_SHIFT 12                                       /* Hits and misses are reported per 4KiB region */
+#define CACHE_REGION_COUNT (INSTRUCTION_MEMORY_LENGTH >> CACHE_REGION_SHIFT)
+#define CACHE_MAX_SIZE INSTRUCTION_MEMORY_LENGTH                    /* A larger cache holds all of memory */
+
+/**
+ * @brief Line replacement policies
+ */
+typedef enum cache_policy_t
+{
+    CACHE_LRU,              /* Least recently used */
+    CACHE_FIFO,             /* Oldest allocated */
+    CACHE_RANDOM,
+    NUM_OF_CACHE_POLICIES
+} cache_policy_t;
+
+/**
+ * @brief Cache selection for configuration and reporting
+ */
+typedef enum cache_select_t
+{
+    INSTRUCTION_CACHE,
+    DATA_CACHE
+} cache_select_t;
+
+/**
+ * @brief Cache geometry and timing
+ */
+typedef struct cache_config_t
+{
+    int size;               /* Bytes - power of two */
+    int associativity;      /* Lines per set - power of two */
+    int line_size;          /* Bytes - power of two */
+    cache_policy_t policy;
+    int miss_penalty;       /* Clock cycles added to each miss */
+} cache_config_t;
+
+/**
+ * @brief Cache line tag and replacement state
+ */
+typedef struct cache_line_t
+{
+    word_t tag;             /* Address of the line start >> line bits */
+    byte_t valid;
+    unsigned int stamp;     /* Access number of last use (LRU) or allocation (FIFO) */
+} cache_line_t;
+
+/**
+ * @brief Cache model - preserved across loads, cleared on restart
+ */
+typedef struct cache_t
+{
+    cache_config_t config;
+    int line_shift;                         /* log2(line_size) */
+    int set_mask;                           /* Sets - 1 */
+    unsigned int accesses;                  /* Stamps lines for replacement */
+    unsigned int random_state;              /* Random replacement generator */
+    unsigned int hits[CACHE_REGION_COUNT];
+    unsigned int misses[CACHE_REGION_COUNT];
+    cache_line_t lines[];                   /* Sets * associativity lines, set major */
+} cache_t;
+
+/* Function Prototypes */
+int set_cache(program_t *program, cache_select_t select, cache_config_t *config);
+int parse_cache_policy(char *name);
+int cache_access(cache_t *cache, word_t address);
+void reset_caches(program_t *program);
+void release_caches(program_t *program);
+void display_caches(program_t *program);
+
+#endif /* CACHE_H */
@@ -0,0 +1,33 @@
+/**
+ * @file console.h
+ * @brief Header file for the buffered console device
+ *
+ * @author Zach Fraser
+ * @date 2024-08-15
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef WINDOWS
+#include <poll.h>
+#endif
+
+#include "definitions.h"
+#include "replay.h"
+
+#define CONSOLE_INPUT_OPTION "-ci"          /* Command line option selecting the console input - path or - for stdin */
+
+/* Function Prototypes */
+int console_write(program_t *program, byte_t character);
+int flush_console(program_t *program);
+int set_console_output(program_t *program, char *path);
+int close_console(program_t *program);
+int set_console_input(program_t *program, char *path);
+int console_receive_ready(program_t *program);
+byte_t console_read(program_t *program);
+
+#endif /* CONSOLE_H */
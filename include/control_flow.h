@@ -0,0 +1,76 @@
+/**
+ * @file control_flow.h
+ * @brief Header file for the static control flow graph
+ *
+ * @author Zach Fraser
+ * @date 2024-09-09
+ */
+
+#ifndef CONTROL_FLOW_H
+#define CONTROL_FLOW_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "decode_table.h"
+#include "execute_instructions.h"
+#include "memory_access.h"
+
+#define CONTROL_FLOW_OPTION "-cfg"          /* Command line option building the graph on load and writing it as DOT */
+#define CONTROL_FLOW_SLOTS (INSTRUCTION_MEMORY_LENGTH / WORD_LENGTH)
+#define CONTROL_FLOW_SUCCESSORS 2           /* Taken or called, and fall through */
+
+/* Instruction slot flags */
+#define FLOW_REACHABLE 0x01                 /* Decoded by the walk */
+#define FLOW_BLOCK_START 0x02               /* Entry, branch target or instruction after a branch */
+#define FLOW_BLOCK_END 0x04                 /* Branch, call or PC write */
+#define FLOW_ENTRY 0x08                     /* Starting address or vector handler */
+#define FLOW_CALL_TARGET 0x10               /* BL destination */
+#define FLOW_LOOP_HEADER 0x20               /* Destination of a back edge - hot loop candidate */
+
+/**
+ * @brief Edge kinds
+ */
+typedef enum flow_edge_t
+{
+    EDGE_FALL_THROUGH,      /* Next instruction - not taken or returned to */
+    EDGE_TAKEN,             /* Branch destination */
+    EDGE_CALL               /* BL destination */
+} flow_edge_t;
+
+/**
+ * @brief Basic block - straight line code entered only at its start
+ */
+typedef struct flow_block_t
+{
+    word_t start;                                   /* First instruction address */
+    word_t end;                                     /* Last instruction address */
+    byte_t flags;                                   /* Flags of the first instruction */
+    byte_t successor_count;
+    byte_t edges[CONTROL_FLOW_SUCCESSORS];          /* flow_edge_t */
+    int successors[CONTROL_FLOW_SUCCESSORS];        /* Block indices */
+} flow_block_t;
+
+/**
+ * @brief Control flow graph of the loaded program - rebuilt on every load
+ */
+typedef struct control_flow_t
+{
+    char dot_path[MAX_PATH_LENGTH];                 /* DOT file written on build - empty for none */
+    byte_t slots[CONTROL_FLOW_SLOTS];               /* Flags per instruction address */
+    int block_count;
+    int edge_count;
+    int loop_header_count;
+    int call_target_count;
+    flow_block_t blocks[CONTROL_FLOW_SLOTS];        /* Ascending start address */
+} control_flow_t;
+
+/* Function Prototypes */
+int set_control_flow(program_t *program, char *dot_path);
+int build_control_flow(program_t *program);
+int write_control_flow(program_t *program, char *dot_path);
+void release_control_flow(program_t *program);
+
+#endif /* CONTROL_FLOW_H */
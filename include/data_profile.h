@@ -0,0 +1,90 @@
+/**
+ * @file data_profile.h
+ * @brief Header file for the data memory access profiler
+ *
+ * @author Zach Fraser
+ * @date 2024-09-17
+ */
+
+#ifndef DATA_PROFILE_H
+#define DATA_PROFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+
+#define PROFILE_MAX_BLOCK_SIZE 256          /* Bytes - largest block counted as one */
+#define PROFILE_DEFAULT_WINDOW 1000         /* Clock cycles in each working set window */
+#define PROFILE_DEFAULT_TOP 10              /* Blocks listed by the report */
+#define PROFILE_TOP_PCS 4                   /* Instructions listed for each block */
+#define PROFILE_HEATMAP_WIDTH 256           /* Blocks in each heatmap image row */
+#define PROFILE_HEATMAP_COLUMNS 16          /* Blocks in each heatmap CSV row */
+#define PROFILE_SITES_INITIAL_LENGTH 1024   /* Block and PC pairs allocated on enable, doubled at half full */
+#define PROFILE_WINDOWS_INITIAL_LENGTH 256  /* Windows allocated when the first closes, doubled when full */
+
+/**
+ * @brief Access counts selected for a heatmap
+ */
+typedef enum profile_select_t
+{
+    PROFILE_ALL,
+    PROFILE_READS,
+    PROFILE_WRITES,
+    NUM_OF_PROFILE_SELECTS
+} profile_select_t;
+
+/**
+ * @brief Accesses of one block by one instruction
+ */
+typedef struct profile_site_t
+{
+    unsigned int key;                       /* block << 16 | PC */
+    unsigned int count;                     /* 0 marks an empty entry */
+} profile_site_t;
+
+/**
+ * @brief Working set of one window - blocks accessed at least once
+ */
+typedef struct profile_window_t
+{
+    int start_cycle;
+    int blocks;
+} profile_window_t;
+
+/**
+ * @brief Data memory access profile - preserved across loads, cleared on restart
+ */
+typedef struct data_profile_t
+{
+    int block_size;                         /* Bytes - power of two */
+    int block_shift;                        /* log2(block_size) */
+    int block_count;
+    int window_cycles;                      /* Clock cycles in each working set window */
+    int window_start;                       /* First cycle of the open window */
+    int window_blocks;                      /* Blocks accessed in the open window */
+    int window_number;                      /* Open window, plus one - stamps blocks */
+    int footprint;                          /* Blocks accessed since the restart */
+    unsigned int *reads;                    /* reads[block] */
+    unsigned int *writes;                   /* writes[block] */
+    int *stamps;                            /* Window of the last access to each block */
+    profile_site_t *sites;                  /* Open addressed table of block and PC pairs */
+    int site_count;
+    int site_capacity;
+    profile_window_t *windows;              /* Closed windows in order */
+    int window_count;
+    int window_capacity;
+} data_profile_t;
+
+/* Function Prototypes */
+int set_data_profile(program_t *program, int block_size, int window_cycles);
+int parse_profile_select(char *name);
+void profile_access(data_profile_t *profile, word_t address, int write, word_t pc, int clock_cycle);
+void reset_data_profile(program_t *program);
+void release_data_profile(program_t *program);
+void display_data_profile(program_t *program, int top_count);
+int export_profile_heatmap(program_t *program, const char *path, profile_select_t select);
+int export_working_set(program_t *program, const char *path);
+
+#endif /* DATA_PROFILE_H */
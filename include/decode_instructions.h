@@ -34,11 +34,9 @@
 #include <string.h>
 
 #include "definitions.h"
-
-/* Instruction Lookup Tables */
-extern instruction_type_t mov_table[MOV_INSTRUCTION_COUNT];
-extern instruction_type_t arithmetic_register_table[ARITHMETIC_REGISTER_INSTRUCTION_COUNT];
-extern instruction_type_t shift_register_table[SHIFT_REGISTER_INSTRUCTION_COUNT];
+#include "statistics.h"
+#include "decode_table.h"
+#include "memory_access.h"
 
 /* Function Prototypes */
 int reset_instruction_arguments(instruction_t *instruction);
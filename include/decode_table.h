@@ -0,0 +1,36 @@
+/**
+ * @file decode_table.h
+ * @brief Header file for the opcode decode table generated at build time
+ *
+ * @author Zach Fraser
+ * @date 2024-08-30
+ */
+
+#ifndef DECODE_TABLE_H
+#define DECODE_TABLE_H
+
+#include "definitions.h"
+
+#define OPCODE_COUNT 0x10000                /* One descriptor per instruction word */
+
+/**
+ * @brief Decoded opcode fields
+ *
+ * Laid out as the leading fields of instruction_t, which decode copies.
+ */
+typedef struct decoded_opcode_t
+{
+    byte_t type;            /* instruction_type_t - execute_table index */
+    byte_t source;          /* Source Register/Constant Code, or MOVx byte */
+    byte_t destination;     /* Destination Register Code */
+    byte_t flags;           /* OPERAND_ bits */
+    word_t argument;        /* Type specific field */
+} decoded_opcode_t;
+
+/* Generated table - read only, shared by every program context */
+extern const decoded_opcode_t decode_table[OPCODE_COUNT];
+
+/* Function Prototypes */
+void decode_opcode(word_t opcode, decoded_opcode_t *decoded);
+
+#endif /* DECODE_TABLE_H */
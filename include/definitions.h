@@ -9,6 +9,8 @@
 #define DEFINITIONS_H
 
 #include <ctype.h>
+#include <stdio.h>
+#include <limits.h>
 
 #define DEBUG
 
@@ -21,9 +23,25 @@
 #define MAX_RECORD_LENGTH 256
 #define INSTRUCTION_MEMORY_LENGTH (64 * KILOBYTE)
 #define DATA_MEMORY_LENGTH (64 * KILOBYTE)
+#define MEMORY_GUARD_LENGTH 8 /* Padding past the last address for word loads and stores */
 #define REGISTER_FILE_LENGTH 8
 #define MAX_PATH_LENGTH 256
-#define NUM_OF_INSTRUCTIONS 41
+#define NUM_OF_INSTRUCTIONS 44
+
+/* Interrupt and Exception Constants */
+#define VECTOR_TABLE_ADDRESS 0xFFC0     /* Base of vector table in data memory */
+#define VECTOR_COUNT 16                 /* Number of interrupt/trap vectors */
+#define VECTOR_LENGTH 4                 /* Each vector holds a PSW word and a PC word */
+#define EXCEPTION_RETURN_ADDRESS 0xFFFF /* Loading PC with this value returns from a handler */
+#define NO_EVENT INT_MAX                /* No event scheduled */
+
+/* Device Bus Constants */
+#define PAGE_SHIFT 8                                    /* 256 byte pages */
+#define PAGE_COUNT (DATA_MEMORY_LENGTH >> PAGE_SHIFT)
+#define MAX_DEVICES 8
+#define CONSOLE_BUFFER_LENGTH (16 * KILOBYTE)
+#define PAGE_RAM 0                                      /* Page holds only plain memory */
+#define PAGE_DEVICE 1                                   /* Page holds device registers */
 
 /* Special Characters */
 #define NUL '\0'
@@ -32,6 +50,7 @@
 #define INSTRUCTION_MEMORY '0'
 #define DATA_MEMORY '1'
 #define INSTRUCTION_NOOP 0x0000
+#define NO_BREAKPOINT (-1) /* Never matches PC */
 
 /* Register Identifiers */
 #define CONSTANT_SELECT 2
@@ -74,6 +93,24 @@
 #define SEVEN_BITS 0x7F
 #define EIGHT_BITS 0xFF
 
+/* PSW Bit Positions - the PSW is held in the hardware layout */
+#define PSW_CARRY_BIT 0
+#define PSW_ZERO_BIT 1
+#define PSW_NEGATIVE_BIT 2
+#define PSW_SLEEP_BIT 3
+#define PSW_OVERFLOW_BIT 4
+#define PSW_CURRENT_PRIORITY_BIT 5
+#define PSW_FAULT_BIT 8
+#define PSW_PREVIOUS_PRIORITY_BIT 13
+#define PSW_CONDITION_MASK 0x1F             /* C, Z, N, SLP and V - indexes the condition table */
+#define PSW_DEFINED_MASK 0xE1FF             /* Bits Nine through Twelve are unused */
+
+/* PSW Field Access */
+#define PSW_BIT(psw, bit) (((psw) >> (bit)) & ONE_BIT)
+#define PSW_PRIORITY(psw, bit) (((psw) >> (bit)) & THREE_BITS)
+#define SET_PSW_BIT(psw, bit, value) ((psw) = (word_t)(((psw) & ~(ONE_BIT << (bit))) | (((value) != 0) << (bit))))
+#define SET_PSW_PRIORITY(psw, bit, value) ((psw) = (word_t)(((psw) & ~(THREE_BITS << (bit))) | (((value) & THREE_BITS) << (bit))))
+
 /* Bit Masks */
 #define BIT_0   0x0001
 #define BIT_1   0x0002
@@ -173,7 +210,7 @@ typedef enum instruction_type_t
     SETPRI, SVC, SETCC, CLRCC,
     CEX, LD, ST, MOVL,
     MOVLZ, MOVLS, MOVH, LDR,
-    STR
+    STR, SKIPPED, FUSED_CMP_BRANCH, FUSED_MOVE
 } instruction_type_t;
 
 /* Available states for ICTRL and DCTRL registers */
@@ -224,55 +261,157 @@ typedef struct s_record_t
     byte_t data[MAX_RECORD_LENGTH];
 } s_record_t;
 
-typedef struct status_register
-{
-    byte_t carry;           /* Carry Flag */
-    byte_t zero;            /* Zero Flag */
-    byte_t negative;        /* Negative Flag */
-    byte_t overflow;        /* Overflow Flag */
-    byte_t sleep;
-} status_register_t;
+
+/* Instruction Flag Bits */
+#define OPERAND_RC          0x01            /* [0 = Register, 1 = Constant] */
+#define OPERAND_WB          0x02            /* [0 = Word, 1 = Byte] */
+#define OPERAND_PRPO        0x04            /* Pre Increment/Decrement */
+#define OPERAND_DECREMENT   0x08
+#define OPERAND_INCREMENT   0x10
+#define OPERAND_DATA        0x20            /* Instruction accesses data memory - set at execute */
+#define OPERAND_NOOP        0x40            /* Slot replaced with a NOOP at decode - bubble or restart */
+
+/* Instruction Flag Accessors - [0, 1] */
+#define INSTRUCTION_RC(instruction)         ((instruction)->flags & OPERAND_RC)
+#define INSTRUCTION_WB(instruction)         (((instruction)->flags & OPERAND_WB) >> 1)
+#define INSTRUCTION_PRPO(instruction)       (((instruction)->flags & OPERAND_PRPO) >> 2)
+#define INSTRUCTION_DECREMENT(instruction)  (((instruction)->flags & OPERAND_DECREMENT) >> 3)
+#define INSTRUCTION_INCREMENT(instruction)  (((instruction)->flags & OPERAND_INCREMENT) >> 4)
+#define INSTRUCTION_DATA(instruction)       (((instruction)->flags & OPERAND_DATA) >> 5)
+#define INSTRUCTION_REPLACED(instruction)   (((instruction)->flags & OPERAND_NOOP) >> 6)
+
+/* Instruction Argument Fields */
+#define BRANCH_OFFSET(instruction)          ((instruction)->argument & 0x03FF)
+#define FUSED_CONDITION_SHIFT               10      /* Fused CMP+branch condition above the offset */
+#define FUSED_CONDITION(instruction)        (((instruction)->argument >> FUSED_CONDITION_SHIFT) & 0x0F)
+#define CEX_CONDITION(instruction)          (((instruction)->argument >> 6) & 0x0F)
+#define CEX_TRUE_COUNT(instruction)         (((instruction)->argument >> 3) & 0x07)
+#define CEX_FALSE_COUNT(instruction)        ((instruction)->argument & 0x07)
+#define SETPRI_PRIORITY(instruction)        ((instruction)->argument & 0x07)
+#define SVC_ADDRESS(instruction)            ((instruction)->argument & 0x0F)
 
 /**
  * @brief Structure representing an instruction.
  * 
- * Contains instruction type and arguments
+ * Contains instruction type and arguments. Packed into eight bytes so the
+ * pipeline copies it as a single register move. The argument holds the
+ * field the opcode encodes after its operands: branch and relative offsets,
+ * CEX condition (bits 6-9) and counts (bits 3-5, 0-2), SVC service address,
+ * SETPRI priority, or SETCC/CLRCC status bits (V, SLP, N, Z, C in bits 4-0).
  */
 typedef struct instruction
 {
-    word_t opcode;          /* Instruction Opcode */
+    byte_t type;            /* Instruction Type - instruction_type_t */
+    byte_t source;          /* Source Register/Constant Code, or MOVx byte */
+    byte_t destination;     /* Destination Register Code */
+    byte_t flags;           /* OPERAND_ bits */
+    word_t argument;        /* Type specific field */
     word_t address;         /* Program Counter */
+} instruction_t;
 
-    word_t offset;          /* Data Memory Address Offset */
+struct program_t;
 
-    byte_t priority;        /* Priority Level */
+/**
+ * @brief Device register access handler
+ * 
+ * Reads place the register value in value, writes take it from value.
+ * Returns [0 = SUCCESS, < 0 = FAILURE]
+ */
+typedef int (*device_access_t)(struct program_t *program, word_t address, control_state_t control, word_t *value);
 
-    byte_t sa;              /* Service Address */
-    byte_t decrement;       /* Decrement Flag */
-    byte_t increment;       /* Increment Flag */
-    byte_t prpo;            /* Pre/Post Increment Flag */
+/**
+ * @brief Peripheral registered on the data memory bus
+ * 
+ */
+typedef struct device_t
+{
+    word_t start_address;   /* First address decoded by device */
+    word_t end_address;     /* Last address decoded by device */
+    device_access_t access; /* Register access handler */
+} device_t;
 
-    byte_t condition_code;  /* Condition Code*/
-    byte_t t_count;         /* True-Count */
-    byte_t f_count;         /* False-Count */
+/**
+ * @brief Interval timer state
+ * 
+ */
+typedef struct timer_device_t
+{
+    word_t control;         /* Enable, Interrupt Enable and Expired bits */
+    word_t period;          /* Cycles between expiries */
+    int deadline;           /* Clock cycle of next expiry */
+} timer_device_t;
 
-    instruction_type_t type;/* Instruction Type */
-    byte_t source;          /* Source Register/Constant Code */
-    byte_t destination;     /* Destination Register Code */
-    byte_t rc;              /* [0 = Register, 1 = Constant] */
-    byte_t wb;              /* [0 = Word, 1 = Byte ] */
-    status_register_t status;/* Status bits */
+/**
+ * @brief Console output batched until newline, full buffer or exit
+ * 
+ */
+typedef struct console_device_t
+{
+    char buffer[CONSOLE_BUFFER_LENGTH]; /* Pending output */
+    int length;                         /* Number of pending bytes */
+    byte_t receive_data;                /* Byte received, not yet read by the guest */
+    int receive_pending;                /* Receive ready */
+} console_device_t;
 
-    byte_t data_flag;       /* Indicates if instruction accesses data memory */
-} instruction_t;
+/**
+ * @brief Session settings preserved when a program is loaded
+ * 
+ */
+typedef struct emulator_settings_t
+{
+    FILE *console_output;   /* Console device output file - NULL for stdout */
+    FILE *console_input;    /* Console device input file - NULL for no input */
+    struct input_log_t *input_log;          /* Input record or replay log - NULL when disabled */
+    unsigned int *stall_counts; /* Bubbles caused by each instruction word - NULL until first bubble */
+    struct branch_predictor_t *predictor;   /* Branch prediction model - NULL when disabled */
+    struct cache_t *instruction_cache;      /* Fetch cache model - NULL when disabled */
+    struct cache_t *data_cache;             /* Data memory cache model - NULL when disabled */
+    struct data_profile_t *data_profile;    /* Data memory access profile - NULL when disabled */
+    int fusion_disabled;                    /* Execute instruction pairs separately */
+    struct metrics_t *metrics;              /* Metrics export - NULL when disabled */
+    struct trace_t *trace;                  /* Execution trace - NULL when disabled */
+    struct control_flow_t *control_flow;    /* Static control flow graph - NULL when disabled */
+    struct multicore_t *multicore;          /* System the core belongs to - NULL for a single core */
+    int core_number;                        /* Position of the core in its system */
+    byte_t *shared_data_memory;             /* Data memory of the system's first core - NULL for private memory */
+} emulator_settings_t;
+
+/**
+ * @brief Reason a bubble replaced an instruction
+ * 
+ */
+typedef enum bubble_cause_t
+{
+    BUBBLE_BRANCH,          /* Taken branch or BL */
+    BUBBLE_LOAD_PC,         /* LD or LDR into PC */
+    BUBBLE_REGISTER_PC,     /* MOV or SWAP into PC */
+    BUBBLE_CEX,             /* Instruction skipped by CEX */
+    BUBBLE_EXCEPTION,       /* Exception entry or return */
+    BUBBLE_RESTART,         /* NOOP restarting the pipeline after a stop */
+    NUM_OF_BUBBLE_CAUSES
+} bubble_cause_t;
+
+/**
+ * @brief Pipeline counters since the program was restarted
+ * 
+ */
+typedef struct pipeline_statistics_t
+{
+    int instructions_retired;               /* Instructions decoded and executed, excluding bubbles */
+    int memory_cycles;                      /* E1 cycles accessing data memory */
+    int bubbles[NUM_OF_BUBBLE_CAUSES];      /* Bubbles by cause */
+} pipeline_statistics_t;
 
 /* Queue for Flushing Pipeline with Bubbles */
 typedef struct bubble_queue_t
 {
-    /* 1 Bits indicate bubbles, 0 bits indicate non_bubbles */
-    int bubble_flag;
+    /* Predicate mask for the next size decodes, next in bit 0 - 1 bits are skipped */
+    unsigned int skip_mask;
     /* Number of elements in the queue */
     int size;
+    /* Cause and address of the instruction that queued the bubbles */
+    bubble_cause_t cause;
+    word_t source_address;
 } bubble_queue_t;
 
 /**
@@ -283,8 +422,8 @@ typedef struct bubble_queue_t
 typedef struct program_t
 {
     /* Memory Space */
-    byte_t instruction_memory[INSTRUCTION_MEMORY_LENGTH];           /* 64KiB Instruction Memory */
-    byte_t data_memory[DATA_MEMORY_LENGTH];                         /* 64KiB Data Memory */
+    byte_t instruction_memory[INSTRUCTION_MEMORY_LENGTH + MEMORY_GUARD_LENGTH];  /* 64KiB Instruction Memory */
+    byte_t data_memory[DATA_MEMORY_LENGTH + MEMORY_GUARD_LENGTH];                /* 64KiB Data Memory */
 
     word_t register_file[CONSTANT_SELECT][REGISTER_FILE_LENGTH];    /* 8 CPU Registers */
     word_t instruction_memory_address_register;                     /* Holds the address of the instruction to be fetched */
@@ -296,16 +435,34 @@ typedef struct program_t
     word_t data_memory_buffer_register;                             /* Holds the data read from or to be written to the address in DMAR */
     control_state_t data_control_register;                          /* Indicates if data is to be read or written from/to address in DMAR */
 
-    status_register_t program_status_word;                          /* Status Indicators */
+    word_t program_status_word;                                     /* Status Indicators - hardware PSW layout */
 
     cycle_state_t cycle_state;                                      /* Current State of the CPU Cycle */
     instruction_t instruction;                                      /* Current Instruction */
     instruction_t previous_instruction;                             /* Copy of Previous Instruction */
+    word_t instruction_opcode;                                      /* Opcode of the Current Instruction - debug trace */
+    word_t previous_opcode;                                         /* Opcode of the Previous Instruction - debug trace */
     int breakpoint;                                                 /* Address of the Breakpoint */
     int starting_address;                                           /* Starting Address of the Program */
     int clock_cycles;                                               /* Number of Clock Cycles */
     int debug_mode;                                                 /* Debug Mode Flag */
     bubble_queue_t bubble_queue;                                                /* Indicates if bubble should be used to avoid Data Hazard */
+    instruction_t fused_instruction;                                /* Pair decoded with its first instruction, executed in the second slot */
+    int fusion_pending;                                             /* Next decode completes a fused pair */
+    int cycle_limit;                                                /* Clock cycle at which the current run stops */
+    pipeline_statistics_t statistics;                               /* Pipeline counters since restart */
+
+    word_t pending_interrupts;                                      /* One bit per vector awaiting service */
+    int exception_depth;                                            /* Number of nested active exception handlers */
+    int next_event_cycle;                                           /* Clock cycle at which events must next be serviced */
+
+    byte_t page_attributes[PAGE_COUNT];                             /* [PAGE_RAM | PAGE_DEVICE] for each data memory page */
+    device_t devices[MAX_DEVICES];                                  /* Devices registered on the data memory bus */
+    int device_count;                                               /* Number of registered devices */
+    int device_event_cycle;                                         /* Clock cycle of next device event */
+    timer_device_t timer;                                           /* Interval timer device */
+    console_device_t console;                                       /* Console output device */
+    emulator_settings_t settings;                                   /* Settings preserved across loads */
 
     char instruction_fetch[MAX_STAGE_LENGTH];
     char instruction_decode[MAX_STAGE_LENGTH];
@@ -314,8 +471,10 @@ typedef struct program_t
 } program_t;
 
 /* Global Function Prototypes */
-void insert_bubble(bubble_queue_t *bubble_queue, int bubble_flag);
+void predicate_pipeline(bubble_queue_t *bubble_queue, unsigned int skip_mask, int length);
 int remove_bubble(bubble_queue_t *bubble_queue);
 void clear_bubble_queue(bubble_queue_t *bubble_queue);
+void flush_pipeline(program_t *program, bubble_cause_t cause, word_t source_address);
+int pipeline_drained(program_t *program);
 
 #endif /* DEFINITIONS_H */
\ No newline at end of file
@@ -0,0 +1,62 @@
+/**
+ * @file device_bus.h
+ * @brief Header file for the memory-mapped device bus
+ *
+ * @author Zach Fraser
+ * @date 2024-08-14
+ */
+
+#ifndef DEVICE_BUS_H
+#define DEVICE_BUS_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "interrupts.h"
+#include "console.h"
+
+/* Console UART Registers */
+#define CONSOLE_DATA_ADDRESS 0xFF00         /* Write transmits a byte, read receives a byte */
+#define CONSOLE_STATUS_ADDRESS 0xFF02       /* Transmit/Receive ready bits */
+#define CONSOLE_END_ADDRESS 0xFF03
+#define CONSOLE_TX_READY BIT_0
+#define CONSOLE_RX_READY BIT_1
+
+/* Interval Timer Registers */
+#define TIMER_CONTROL_ADDRESS 0xFF10        /* Enable, Interrupt Enable, Expired */
+#define TIMER_PERIOD_ADDRESS 0xFF12         /* Cycles between expiries */
+#define TIMER_COUNT_ADDRESS 0xFF14          /* Cycles until next expiry */
+#define TIMER_END_ADDRESS 0xFF15
+#define TIMER_ENABLE BIT_0
+#define TIMER_INTERRUPT_ENABLE BIT_1
+#define TIMER_EXPIRED BIT_2
+#define TIMER_VECTOR 8
+
+/* Cycle Counter Registers */
+#define CYCLE_COUNTER_LOW_ADDRESS 0xFF20    /* Low word of clock_cycles */
+#define CYCLE_COUNTER_HIGH_ADDRESS 0xFF22   /* High word of clock_cycles */
+#define CYCLE_COUNTER_END_ADDRESS 0xFF23
+
+/* Inter-Core Registers - multi-core systems only */
+#define INTERCORE_ID_ADDRESS 0xFF30         /* Core number in the low byte, core count in the high byte */
+#define INTERCORE_SEND_ADDRESS 0xFF32       /* Write interrupts the cores with 1 bits */
+#define INTERCORE_PENDING_ADDRESS 0xFF34    /* Cores that interrupted this core - write 1 bits to clear */
+#define INTERCORE_LOCK_ADDRESS 0xFF36       /* Read acquires, 0 = Acquired, 1 = Held by another core - write releases */
+#define INTERCORE_HALT_ADDRESS 0xFF38       /* Write halts the core until an inter-core interrupt */
+#define INTERCORE_END_ADDRESS 0xFF39
+#define INTERCORE_VECTOR 9
+
+/* Function Prototypes */
+word_t read_lane(word_t register_value, word_t address, control_state_t control);
+word_t write_lane(word_t register_value, word_t address, control_state_t control, word_t value);
+int register_device(program_t *program, word_t start_address, word_t end_address, device_access_t access);
+int initialize_devices(program_t *program);
+int bus_access(program_t *program);
+int update_devices(program_t *program);
+int console_access(program_t *program, word_t address, control_state_t control, word_t *value);
+int timer_access(program_t *program, word_t address, control_state_t control, word_t *value);
+int cycle_counter_access(program_t *program, word_t address, control_state_t control, word_t *value);
+int intercore_access(program_t *program, word_t address, control_state_t control, word_t *value);
+
+#endif /* DEVICE_BUS_H */
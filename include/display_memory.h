@@ -14,6 +14,7 @@
 #include "definitions.h"
 
 #define BYTES_PER_LINE 16
+#define MAX_LINE_LENGTH 80
 
 /* Function Prototypes */
 int convert_word_to_int(byte_t *word, int *integer);
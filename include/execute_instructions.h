@@ -14,6 +14,11 @@
 
 #include "definitions.h"
 #include "instruction_functions.h"
+#include "device_bus.h"
+#include "cache.h"
+#include "data_profile.h"
+#include "memory_access.h"
+#include "trace.h"
 
 /* Function Pointer Type for Instruction Execution */
 typedef int (*execute_instruction_t)(instruction_t *instruction, program_t *program);
@@ -12,6 +12,8 @@
 #include <stdio.h>
 
 #include "definitions.h"
+#include "cache.h"
+#include "memory_access.h"
 
 /* Function Prototypes */
 int fetch_instruction(program_t *program, int stage);
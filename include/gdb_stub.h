@@ -0,0 +1,70 @@
+/**
+ * @file gdb_stub.h
+ * @brief Header file for the GDB remote serial protocol stub
+ *
+ * @author Zach Fraser
+ * @date 2024-08-20
+ */
+
+#ifndef GDB_STUB_H
+#define GDB_STUB_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET socket_t;
+#define close_socket closesocket
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int socket_t;
+#define close_socket close
+#define INVALID_SOCKET (-1)
+#endif
+
+#include "definitions.h"
+#include "utilities.h"
+
+#define GDB_OPTION "-g"                     /* Command line option selecting the stub - port or socket path */
+#define GDB_PACKET_SIZE 0x4000              /* Largest packet exchanged - batches memory transfers */
+#define GDB_RECEIVE_LENGTH 4096
+#define GDB_DATA_BASE 0x10000               /* Data memory appears above instruction memory */
+#define GDB_REGISTER_COUNT (REGISTER_FILE_LENGTH + 1) /* R0 - R7, PSW */
+#define GDB_PSW_REGISTER REGISTER_FILE_LENGTH
+#define GDB_POLL_CYCLES (1 << 16)           /* Cycles between checks for an interrupt from the debugger */
+#define GDB_INTERRUPT 0x03                  /* Ctrl-C sent while running */
+#define GDB_ESCAPE 0x7D                     /* Binary data escape */
+#define GDB_SIGINT 2
+#define GDB_SIGTRAP 5
+#define BREAKPOINT_MAP_LENGTH (INSTRUCTION_MEMORY_LENGTH / WORD_LENGTH / 8)
+
+/**
+ * @brief Debugger connection state
+ */
+typedef struct gdb_stub_t
+{
+    socket_t connection;                            /* Connected debugger */
+    int acknowledge;                                /* Send and expect +/- acknowledgements */
+    int attached;                                   /* Cleared by detach or kill */
+    char receive_buffer[GDB_RECEIVE_LENGTH];        /* Bytes received, not yet consumed */
+    int receive_length;
+    int receive_position;
+    char packet[GDB_PACKET_SIZE + 1];               /* Packet being received */
+    char reply[GDB_PACKET_SIZE + 4];                /* Framed reply being sent */
+    byte_t breakpoints[BREAKPOINT_MAP_LENGTH];      /* One bit per instruction word */
+} gdb_stub_t;
+
+/* Function Prototypes */
+int run_gdb_stub(program_t *program, char *endpoint);
+
+#endif /* GDB_STUB_H */
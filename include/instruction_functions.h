@@ -12,6 +12,8 @@
 #include <stdio.h>
 
 #include "definitions.h"
+#include "interrupts.h"
+#include "branch_predictor.h"
 
 #define READ_WRITE 2
 #define WORD_BYTE 2
@@ -23,9 +25,14 @@
 
 /* Branch Offset Calculation */
 signed short restore_offset(word_t offset, int number_of_bits);
+/* Condition Code Evaluation */
+int check_condition(condition_code_t condition_code, word_t program_status_word);
 
 /* Undefined Instruction Handling */
 int execute_undefined(instruction_t *instruction, program_t *program);
+int execute_skipped(instruction_t *instruction, program_t *program);
+int execute_fused_cmp_branch(instruction_t *instruction, program_t *program);
+int execute_fused_move(instruction_t *instruction, program_t *program);
 /* Branch Instructions */
 int execute_bl(instruction_t *instruction, program_t *program);
 int execute_beq(instruction_t *instruction, program_t *program);
@@ -0,0 +1,28 @@
+/**
+ * @file interrupts.h
+ * @brief Header file for the XM23P interrupt and exception model
+ *
+ * @author Zach Fraser
+ * @date 2024-08-12
+ */
+
+#ifndef INTERRUPTS_H
+#define INTERRUPTS_H
+
+#include <stdio.h>
+
+#include "definitions.h"
+#include "device_bus.h"
+#include "memory_access.h"
+
+/* Function Prototypes */
+int push_word(program_t *program, word_t value);
+int pull_word(program_t *program, word_t *value);
+int raise_interrupt(program_t *program, int vector);
+int enter_exception(program_t *program, int vector, word_t return_address);
+int return_from_exception(program_t *program);
+int service_events(program_t *program);
+void update_event_cycle(program_t *program);
+void reset_interrupts(program_t *program);
+
+#endif /* INTERRUPTS_H */
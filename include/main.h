@@ -12,9 +12,18 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "definitions.h"
 #include "operating_system.h"
 #include "utilities.h"
+#include "script.h"
+#include "gdb_stub.h"
+#include "server.h"
+#include "metrics.h"
+#include "replay.h"
+#include "trace.h"
+#include "multicore.h"
+#include "batch.h"
 
 #endif
\ No newline at end of file
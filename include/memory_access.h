@@ -0,0 +1,86 @@
+/**
+ * @file memory_access.h
+ * @brief Little-endian word access to instruction and data memory
+ *
+ * Each memory array carries guard bytes past its last address, so a word
+ * access at #FFFF is a single in-bounds load or store on little-endian
+ * hosts. The high byte of that word belongs to address #0000 and is
+ * wrapped explicitly. Other hosts assemble the word from its two bytes.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-01
+ */
+
+#ifndef MEMORY_ACCESS_H
+#define MEMORY_ACCESS_H
+
+#include <string.h>
+
+#include "definitions.h"
+
+/* Host byte order - words are stored low byte first */
+#if defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM64) \
+    || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MEMORY_LITTLE_ENDIAN 1
+#else
+#define MEMORY_LITTLE_ENDIAN 0
+#endif
+
+#define LAST_MEMORY_ADDRESS 0xFFFF      /* Word accesses here wrap to #0000 */
+
+/**
+ * @brief Read a little-endian word
+ *
+ * @param memory Instruction or data memory - MEMORY_GUARD_LENGTH bytes of padding
+ * @param address Address of the low byte
+ * @return word_t Word read
+ */
+static inline word_t read_memory_word(const byte_t *memory, word_t address)
+{
+#if MEMORY_LITTLE_ENDIAN
+    word_t value;
+    /* Guard padding keeps the top address in bounds */
+    memcpy(&value, &memory[address], WORD_LENGTH);
+    if(address == LAST_MEMORY_ADDRESS)
+    {
+        value = (word_t)((value & EIGHT_BITS) | (memory[0] << 8));
+    }
+    return value;
+#else
+    return (word_t)(memory[address] | (memory[(word_t)(address + BYTE_LENGTH)] << 8));
+#endif
+}
+
+/**
+ * @brief Write a little-endian word
+ *
+ * @param memory Instruction or data memory - MEMORY_GUARD_LENGTH bytes of padding
+ * @param address Address of the low byte
+ * @param value Word to write
+ */
+static inline void write_memory_word(byte_t *memory, word_t address, word_t value)
+{
+#if MEMORY_LITTLE_ENDIAN
+    memcpy(&memory[address], &value, WORD_LENGTH);
+    if(address == LAST_MEMORY_ADDRESS)
+    {
+        memory[0] = (byte_t)(value >> 8);
+    }
+#else
+    memory[address] = (byte_t)(value & EIGHT_BITS);
+    memory[(word_t)(address + BYTE_LENGTH)] = (byte_t)(value >> 8);
+#endif
+}
+
+/**
+ * @brief Data memory accessed by a core
+ *
+ * @param program Program context
+ * @return byte_t* Shared data memory of a multi-core system, private data memory otherwise
+ */
+static inline byte_t *data_memory_of(program_t *program)
+{
+    return (program->settings.shared_data_memory != NULL) ? program->settings.shared_data_memory : program->data_memory;
+}
+
+#endif /* MEMORY_ACCESS_H */
@@ -0,0 +1,47 @@
+/**
+ * @file memory_export.h
+ * @brief Header file for bulk memory export and import
+ *
+ * @author Zach Fraser
+ * @date 2024-08-16
+ */
+
+#ifndef MEMORY_EXPORT_H
+#define MEMORY_EXPORT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "load_memory.h"
+
+#define EXPORT_BYTES_PER_RECORD 16
+#define INTEL_HEX_DATA_TYPE 0x00
+#define INTEL_HEX_EOF_TYPE 0x01
+#define EXPORT_FILE_ERROR (-16)     /* Input, output or baseline file could not be opened */
+#define IMPORT_RECORD_ERROR (-17)   /* Malformed record, bad checksum or unsupported record type */
+
+/**
+ * @brief Available export/import formats
+ */
+typedef enum export_format_t
+{
+    FORMAT_BINARY       = 'b',  /* Raw bytes */
+    FORMAT_INTEL_HEX    = 'i',  /* Intel HEX data and EOF records - 16-bit addresses only */
+    FORMAT_S_RECORD     = 's',  /* S1 (instruction) or S2 (data) records */
+    FORMAT_DIFF         = 'd'   /* Changed ranges against a baseline image */
+} export_format_t;
+
+/* Function Prototypes */
+int export_memory(byte_t *memory, int start_address, int end_address,
+    export_format_t format, record_type_t record_type, byte_t *baseline, FILE *file);
+int import_memory(byte_t *memory, int start_address, int end_address,
+    export_format_t format, FILE *file);
+int read_baseline(char *path, byte_t *baseline);
+int export_memory_file(byte_t *memory, int start_address, int end_address,
+    export_format_t format, record_type_t record_type, char *path, char *baseline_path);
+int import_memory_file(byte_t *memory, int start_address, int end_address,
+    export_format_t format, char *path);
+
+#endif /* MEMORY_EXPORT_H */
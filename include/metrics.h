@@ -0,0 +1,90 @@
+/**
+ * @file metrics.h
+ * @brief Header file for the run metrics export
+ *
+ * @author Zach Fraser
+ * @date 2024-09-03
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+#ifdef WINDOWS
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+#include "definitions.h"
+
+#define METRICS_OPTION "-m"                 /* Command line option selecting the destination - file, port or unix:path */
+#define METRICS_FORMAT_OPTION "-mf"         /* Command line option selecting prometheus or json */
+#define METRICS_INTERVAL_OPTION "-mi"       /* Command line option selecting seconds between exports while running */
+#define METRICS_SOCKET_PREFIX "unix:"
+#define METRICS_DEFAULT_INTERVAL 10.0       /* Seconds */
+#define METRICS_CHECK_CYCLES (1 << 20)      /* Cycles between checks of the host clock */
+#define METRICS_BUFFER_LENGTH 4096
+
+/**
+ * @brief Text formats
+ */
+typedef enum metrics_format_t
+{
+    METRICS_PROMETHEUS,     /* Prometheus text exposition format */
+    METRICS_JSON,
+    NUM_OF_METRICS_FORMATS
+} metrics_format_t;
+
+/**
+ * @brief Reason the last run stopped
+ */
+typedef enum exit_reason_t
+{
+    EXIT_REASON_NONE,       /* Not run since restart */
+    EXIT_REASON_RUNNING,    /* Exported during a run */
+    EXIT_REASON_BREAKPOINT,
+    EXIT_REASON_CYCLE_LIMIT,
+    EXIT_REASON_EXIT,       /* Emulator exited during a run */
+    NUM_OF_EXIT_REASONS
+} exit_reason_t;
+
+/**
+ * @brief Export destination and host timing - preserved across loads
+ */
+typedef struct metrics_t
+{
+    char destination[MAX_PATH_LENGTH];      /* File path, TCP port on loopback, or unix:socket path */
+    metrics_format_t format;
+    double interval;                        /* Seconds between exports while running - 0 exports only at exit */
+    double run_seconds;                     /* Host time spent running since restart */
+    double run_start;                       /* Host time the current run started */
+    double load_seconds;                    /* Host time taken by the last load */
+    double last_export;                     /* Host time of the last export */
+    int next_check_cycle;                   /* Clock cycle at which the host clock is next checked */
+    exit_reason_t exit_reason;
+} metrics_t;
+
+/* Function Prototypes */
+double host_seconds(void);
+int set_metrics(program_t *program, char *destination, char *format, double interval);
+void begin_run_metrics(program_t *program);
+void check_metrics(program_t *program);
+void end_run_metrics(program_t *program, exit_reason_t exit_reason);
+void reset_metrics(program_t *program);
+int export_metrics(program_t *program);
+void close_metrics(program_t *program);
+void release_metrics(program_t *program);
+
+#endif /* METRICS_H */
@@ -0,0 +1,86 @@
+/**
+ * @file multicore.h
+ * @brief Header file for multi-core systems sharing data memory
+ *
+ * @author Zach Fraser
+ * @date 2024-09-13
+ */
+
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <threads.h>
+#include <stdatomic.h>
+
+#include "definitions.h"
+#include "utilities.h"
+#include "metrics.h"
+
+#define MULTICORE_OPTION "-mc"              /* Command line option - number of cores and clock cycles to run */
+#define QUANTUM_OPTION "-mq"                /* Command line option - clock cycles between core synchronizations */
+#define DETERMINISTIC_OPTION "-md"          /* Command line option - run the cores in turn on one host thread */
+#define MAX_CORES 16                        /* One bit per core in the inter-core registers */
+#define DEFAULT_QUANTUM 1000
+
+/**
+ * @brief Core run state
+ */
+typedef enum core_state_t
+{
+    CORE_RUNNING,
+    CORE_WAITING,           /* Halted by the guest until an inter-core interrupt */
+    CORE_STOPPED,           /* Breakpoint reached */
+    NUM_OF_CORE_STATES
+} core_state_t;
+
+/**
+ * @brief One XM23P core - registers, PSW and pipeline are held in its program context
+ */
+typedef struct core_t
+{
+    program_t *program;                     /* First core is the loaded program */
+    struct multicore_t *system;
+    thrd_t thread;                          /* Host thread - parallel runs only */
+    atomic_uint incoming;                   /* Cores that interrupted this core during the quantum */
+    word_t pending;                         /* Interrupting cores not yet cleared by the guest */
+    core_state_t state;
+} core_t;
+
+/**
+ * @brief Cores sharing the data memory of the first core
+ *
+ * Cores run a quantum of clock cycles, in parallel on host threads or in
+ * turn when deterministic, then synchronize. Inter-core interrupts are
+ * delivered, and console output flushed in core order, at the quantum
+ * boundary, so they are deterministic in both modes. Shared memory
+ * accesses within a quantum are ordered by the host in parallel runs.
+ */
+typedef struct multicore_t
+{
+    int core_count;
+    int cycle_budget;                       /* Clock cycle at which the run ends */
+    int quantum;                            /* Clock cycles between synchronizations */
+    int deterministic;                      /* Run the cores in turn on the calling thread */
+    int quantum_end;                        /* Clock cycle ending the current quantum */
+    int quantum_count;
+    atomic_int lock_owner;                  /* Core holding the lock register + 1 - 0 when free */
+    core_t cores[MAX_CORES];
+
+    /* Quantum barrier - parallel runs only */
+    mtx_t mutex;
+    cnd_t start;                            /* Signalled when a quantum starts */
+    cnd_t finished;                         /* Signalled when the last worker finishes */
+    int generation;                         /* Quantum number seen by the workers */
+    int running;                            /* Workers still running the quantum */
+    int stopping;                           /* Workers exit at the next start */
+} multicore_t;
+
+/* Function Prototypes */
+int set_multicore(program_t *program, int core_count, int cycle_budget, int quantum, int deterministic);
+int run_multicore(program_t *program);
+void release_multicore(program_t *program);
+
+#endif /* MULTICORE_H */
@@ -20,12 +20,19 @@ enum utilities
     LOAD            = 'l',
     MEMORY_DUMP     = 'm',
     MEMORY_WRITE    = 'w',
+    MEMORY_EXPORT   = 'e',
+    MEMORY_IMPORT   = 'i',
     REGISTER_DUMP   = 'r',
     DEBUG_TOGGLE    = 'd',
     REGISTER_SET    = 's',
     SET_BREAKPOINT  = 'b',
     RUN             = 'g',
     RESTART         = 'v',
+    CONSOLE_OUTPUT  = 'c',
+    PIPELINE_STATISTICS = 'p',
+    BRANCH_PREDICTOR = 'n',
+    CACHE_CONFIGURATION = 'k',
+    DATA_PROFILE    = 'f',
     EXIT            = 'x',
     HELP            = 'h'
 };
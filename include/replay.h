@@ -0,0 +1,69 @@
+/**
+ * @file replay.h
+ * @brief Header file for recording and replaying external inputs
+ *
+ * @author Zach Fraser
+ * @date 2024-09-05
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+
+#define RECORD_OPTION "-rr"                 /* Command line option recording inputs to a log */
+#define REPLAY_OPTION "-rp"                 /* Command line option replaying inputs from a log */
+#define INPUT_LOG_MAGIC "XMIL"              /* Log header, followed by the version byte */
+#define INPUT_LOG_MAGIC_LENGTH 4
+#define INPUT_LOG_VERSION 1
+#define VARINT_SHIFT 7                      /* Cycle deltas are stored seven bits per byte, low first */
+#define VARINT_CONTINUE 0x80
+
+/**
+ * @brief Input log modes
+ */
+typedef enum replay_mode_t
+{
+    REPLAY_RECORD,          /* Host inputs are used and logged */
+    REPLAY_PLAYBACK         /* Inputs come only from the log */
+} replay_mode_t;
+
+/**
+ * @brief External input sources - one byte in each entry
+ */
+typedef enum input_source_t
+{
+    INPUT_CONSOLE,          /* Byte received by the console UART */
+    INPUT_RESTART,          /* Program restarted - clock cycles return to 0 */
+    NUM_OF_INPUT_SOURCES
+} input_source_t;
+
+/**
+ * @brief Open input log - preserved across loads
+ *
+ * Entries are the clock cycle difference from the previous entry, the
+ * source and the value.
+ */
+typedef struct input_log_t
+{
+    replay_mode_t mode;
+    FILE *file;
+    int last_cycle;                         /* Clock cycle of the previous entry */
+    int next_cycle;                         /* Playback - clock cycle of the next entry, NO_EVENT at end of log */
+    input_source_t next_source;
+    byte_t next_value;
+    unsigned int entries;                   /* Entries written or replayed */
+} input_log_t;
+
+/* Function Prototypes */
+int open_input_log(program_t *program, char *path, replay_mode_t mode);
+int record_input(program_t *program, input_source_t source, byte_t value);
+int replay_input(program_t *program, input_source_t source, byte_t *value);
+void restart_input_log(program_t *program);
+void close_input_log(program_t *program);
+
+#endif /* REPLAY_H */
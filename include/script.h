@@ -0,0 +1,57 @@
+/**
+ * @file script.h
+ * @brief Header file for the line-oriented command script interpreter
+ *
+ * @author Zach Fraser
+ * @date 2024-08-18
+ */
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "utilities.h"
+#include "memory_export.h"
+
+#define MAX_SCRIPT_LINE_LENGTH 512
+#define MAX_SCRIPT_ARGUMENTS 8
+#define SCRIPT_OPTION "-s"              /* Command line option selecting a script */
+#define SCRIPT_STDIN "-"                /* Script path to read commands from stdin */
+#define SCRIPT_COMMENT '#'
+
+/**
+ * @brief Results accumulated over a script
+ */
+typedef struct script_result_t
+{
+    int line_number;                    /* Line currently executing */
+    int passed;                         /* Expectations met */
+    int failed;                         /* Expectations not met */
+    int errors;                         /* Invalid commands or arguments */
+    int exit;                           /* Stop reading commands */
+} script_result_t;
+
+/**
+ * @brief Script command handler - argument_values[0] is the command name
+ */
+typedef int (*script_command_t)(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+
+/**
+ * @brief Script command table entry
+ */
+typedef struct script_command_entry_t
+{
+    const char *name;
+    script_command_t handler;
+    const char *usage;
+} script_command_entry_t;
+
+/* Function Prototypes */
+int run_script(program_t *program, char *path);
+int run_script_line(program_t *program, char *line, script_result_t *result);
+
+#endif /* SCRIPT_H */
@@ -0,0 +1,127 @@
+/**
+ * @file server.h
+ * @brief Header file for the emulator daemon serving warm contexts over a Unix socket
+ *
+ * @author Zach Fraser
+ * @date 2024-08-22
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef WINDOWS
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+#include "definitions.h"
+#include "utilities.h"
+
+#define SERVER_OPTION "-d"                      /* Command line option selecting daemon mode - socket path */
+#define SERVER_MAX_CONTEXTS 64
+#define SERVER_MAX_CLIENTS 16
+#define SERVER_RECEIVE_LENGTH (64 * KILOBYTE)   /* Bytes read per receive */
+#define SERVER_MAX_FRAME (DATA_MEMORY_LENGTH + 64) /* Largest request payload - a full memory poke */
+#define FRAME_HEADER_LENGTH 8
+
+/*
+ * Frame Layout - Little Endian
+ *   [0 - 3] Payload Length
+ *   [4]     Operation (Request) / Status (Reply)
+ *   [5]     Context
+ *   [6 - 7] Tag - Echoed in the reply
+ *   [8 - ]  Payload
+ *
+ * Requests are processed in order and replies are sent in the same order,
+ * so clients may pipeline any number of requests.
+ */
+
+/**
+ * @brief Request operations
+ */
+typedef enum server_operation_t
+{
+    OPERATION_CREATE    = 0x00,     /* Allocate a context - reply context holds its id */
+    OPERATION_DESTROY   = 0x01,     /* Free a context and its snapshot */
+    OPERATION_LOAD      = 0x02,     /* Payload: xme path */
+    OPERATION_RESET     = 0x03,     /* Restart the loaded program */
+    OPERATION_RUN       = 0x04,     /* Payload: u32 cycle count - reply: stop state */
+    OPERATION_STEP      = 0x05,     /* Payload: u32 instruction count - reply: stop state */
+    OPERATION_BREAK     = 0x06,     /* Payload: u32 address, 0xFFFFFFFF clears */
+    OPERATION_SNAPSHOT  = 0x07,     /* Save the context */
+    OPERATION_RESTORE   = 0x08,     /* Return the context to its snapshot */
+    OPERATION_DUMP      = 0x09,     /* Payload: u8 space, u16 address, u32 length - reply: bytes */
+    OPERATION_POKE      = 0x0A,     /* Payload: u8 space, u16 address, bytes */
+    OPERATION_SHUTDOWN  = 0x0B      /* Stop the daemon once replies are sent */
+} server_operation_t;
+
+/**
+ * @brief Reply status
+ */
+typedef enum server_status_t
+{
+    STATUS_OK           = 0x00,
+    STATUS_BAD_REQUEST  = 0x01,     /* Unknown operation or malformed payload */
+    STATUS_NO_CONTEXT   = 0x02,     /* Context not created */
+    STATUS_FAILED       = 0x03,     /* Operation failed, e.g. file not opened */
+    STATUS_FULL         = 0x04      /* No free contexts */
+} server_status_t;
+
+/**
+ * @brief Address spaces for dump and poke
+ */
+typedef enum server_space_t
+{
+    SPACE_INSTRUCTION   = 0x00,
+    SPACE_DATA          = 0x01,
+    SPACE_REGISTERS     = 0x02      /* R0 - R7, PSW, clock cycles (read only) */
+} server_space_t;
+
+#define REGISTER_SPACE_LENGTH (REGISTER_FILE_LENGTH * WORD_LENGTH + WORD_LENGTH + 4)
+#define STOP_REPLY_LENGTH 7         /* u8 cycle status, u16 PC, u32 clock cycles */
+
+/**
+ * @brief Growable byte buffer
+ */
+typedef struct server_buffer_t
+{
+    byte_t *data;
+    size_t length;
+    size_t capacity;
+} server_buffer_t;
+
+/**
+ * @brief Connected client
+ */
+typedef struct server_client_t
+{
+    int connection;                 /* Socket - < 0 if unused */
+    server_buffer_t input;          /* Received bytes not yet processed */
+    server_buffer_t output;         /* Replies not yet sent */
+    size_t output_position;         /* Bytes of output already sent */
+} server_client_t;
+
+/**
+ * @brief Daemon state
+ */
+typedef struct server_t
+{
+    program_t *contexts[SERVER_MAX_CONTEXTS];
+    program_t *snapshots[SERVER_MAX_CONTEXTS];
+    server_client_t clients[SERVER_MAX_CLIENTS];
+    int shutdown;
+} server_t;
+
+/* Function Prototypes */
+int run_server(char *socket_path);
+
+#endif /* SERVER_H */
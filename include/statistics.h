@@ -0,0 +1,28 @@
+/**
+ * @file statistics.h
+ * @brief Header file for pipeline hazard and stall accounting
+ *
+ * @author Zach Fraser
+ * @date 2024-08-24
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+
+#define STALL_TABLE_LENGTH (INSTRUCTION_MEMORY_LENGTH / WORD_LENGTH)   /* One counter per instruction word */
+#define STALL_REPORT_LENGTH 10                                          /* Addresses listed in the report */
+#define CYCLES_PER_INSTRUCTION 2                                        /* Cycles each pipeline slot occupies */
+
+/* Function Prototypes */
+void record_bubble(program_t *program, bubble_cause_t cause, word_t source_address);
+void reset_statistics(program_t *program);
+void release_statistics(program_t *program);
+void display_statistics(program_t *program);
+
+#endif /* STATISTICS_H */
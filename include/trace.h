@@ -0,0 +1,48 @@
+/**
+ * @file trace.h
+ * @brief Header file for writing compressed execution traces
+ *
+ * @author Zach Fraser
+ * @date 2024-09-07
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "trace_format.h"
+
+#define TRACE_OPTION "-t"                   /* Command line option writing a trace file */
+#define TRACE_INDEX_INITIAL_LENGTH 64       /* Index entries allocated on open, doubled when full */
+
+/**
+ * @brief Trace writer - one block is encoded in memory at a time
+ */
+typedef struct trace_t
+{
+    FILE *file;
+    uint64_t offset;                        /* File offset of the next block */
+    trace_state_t state;                    /* Delta state of the block being encoded */
+    trace_block_t block;                    /* Index entry of the block being encoded */
+    int length;                             /* Encoded bytes in the block */
+    trace_block_t *index;                   /* Entries of the blocks written */
+    int index_length;
+    int index_capacity;
+    word_t registers[TRACE_REGISTER_COUNT]; /* Register values last traced */
+    word_t psw;                             /* PSW last traced */
+    unsigned int records;
+    byte_t buffer[TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX];
+    byte_t compressed[TRACE_COMPRESSED_MAX(TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX)];
+} trace_t;
+
+/* Function Prototypes */
+int open_trace(program_t *program, char *path);
+void trace_execute(program_t *program, instruction_t *instruction);
+void trace_memory(program_t *program);
+int close_trace(program_t *program);
+
+#endif /* TRACE_H */
@@ -0,0 +1,107 @@
+/**
+ * @file trace_format.h
+ * @brief Header file for the compressed execution trace format
+ *
+ * Shared by the emulator, which writes traces, and the trace query tool.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-07
+ */
+
+#ifndef TRACE_FORMAT_H
+#define TRACE_FORMAT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "definitions.h"
+
+#define TRACE_MAGIC "XMTR"                  /* File header and trailer */
+#define TRACE_MAGIC_LENGTH 4
+#define TRACE_VERSION 1
+#define TRACE_HEADER_LENGTH (TRACE_MAGIC_LENGTH + 1)
+
+#define TRACE_BLOCK_LENGTH (64 * KILOBYTE)  /* Encoded records per block before compression */
+#define TRACE_RECORD_MAX 32                 /* Longest encoded record */
+#define TRACE_COMPRESSED_MAX(length) ((length) + (length) / 255 + 16)
+#define TRACE_REGISTER_COUNT 7              /* R0 - R6 - the PC is in every execute record */
+
+/* Block summaries - one bit per 256 byte region of the address space */
+#define TRACE_REGION_SHIFT 8
+#define TRACE_REGION_COUNT (0x10000 >> TRACE_REGION_SHIFT)
+#define TRACE_BITMAP_LENGTH (TRACE_REGION_COUNT / 8)
+#define TRACE_INDEX_ENTRY_LENGTH (8 + 5 * 4 + 3 * TRACE_BITMAP_LENGTH)
+#define TRACE_TRAILER_LENGTH (8 + 4 + TRACE_MAGIC_LENGTH)
+
+/* Record header - type in bits 0 and 1 */
+#define TRACE_TYPE_MASK 0x03
+#define TRACE_EXECUTE 0x00                  /* Instruction executed (E0) */
+#define TRACE_MEMORY 0x01                   /* Data memory access (E1) */
+/* Execute record flags */
+#define TRACE_PC_SEQUENTIAL 0x04            /* PC follows the previous execute record - no PC field */
+#define TRACE_PSW_CHANGED 0x08              /* PSW word follows */
+/* Memory record flags */
+#define TRACE_CONTROL_SHIFT 2               /* control_state_t in bits 2 and 3 */
+#define TRACE_CONTROL_MASK 0x0C
+/* Either record */
+#define TRACE_REGISTERS_WRITTEN 0x10        /* Mask of written registers and their values follow */
+
+/**
+ * @brief Decoded trace record
+ */
+typedef struct trace_record_t
+{
+    int type;                               /* TRACE_EXECUTE or TRACE_MEMORY */
+    uint32_t cycle;                         /* Clock cycle */
+    word_t address;                         /* Instruction or data address */
+    word_t value;                           /* Opcode, or data read or written */
+    control_state_t control;                /* Memory access type */
+    int psw_changed;
+    word_t psw;
+    byte_t register_mask;                   /* Bit per register written */
+    word_t registers[TRACE_REGISTER_COUNT];
+} trace_record_t;
+
+/**
+ * @brief Delta state - cleared at the start of each block so blocks decode independently
+ */
+typedef struct trace_state_t
+{
+    uint32_t cycle;
+    word_t pc;                              /* Address following the last execute record */
+    word_t data_address;                    /* Address of the last memory record */
+} trace_state_t;
+
+/**
+ * @brief Index entry for one compressed block
+ */
+typedef struct trace_block_t
+{
+    uint64_t offset;                        /* File offset of the compressed block */
+    uint32_t compressed_length;
+    uint32_t length;                        /* Encoded record bytes */
+    uint32_t records;
+    uint32_t first_cycle;
+    uint32_t last_cycle;
+    byte_t pc_regions[TRACE_BITMAP_LENGTH];     /* Regions executed */
+    byte_t read_regions[TRACE_BITMAP_LENGTH];   /* Regions read */
+    byte_t write_regions[TRACE_BITMAP_LENGTH];  /* Regions written */
+} trace_block_t;
+
+#define TRACE_REGION_SET(bitmap, address) ((bitmap)[((address) & 0xFFFF) >> (TRACE_REGION_SHIFT + 3)] |= (byte_t)(1 << ((((address) & 0xFFFF) >> TRACE_REGION_SHIFT) & 7)))
+#define TRACE_REGION_TEST(bitmap, address) (((bitmap)[((address) & 0xFFFF) >> (TRACE_REGION_SHIFT + 3)] >> ((((address) & 0xFFFF) >> TRACE_REGION_SHIFT) & 7)) & 1)
+
+/* Function Prototypes */
+int encode_trace_record(trace_state_t *state, trace_record_t *record, byte_t *buffer);
+int decode_trace_record(trace_state_t *state, const byte_t *buffer, int length, trace_record_t *record);
+int compress_trace_block(const byte_t *input, int length, byte_t *output);
+int decompress_trace_block(const byte_t *input, int length, byte_t *output, int capacity);
+void write_trace_index_entry(trace_block_t *block, byte_t *buffer);
+void read_trace_index_entry(const byte_t *buffer, trace_block_t *block);
+void write_trace_u32(byte_t *buffer, uint32_t value);
+uint32_t read_trace_u32(const byte_t *buffer);
+void write_trace_u64(byte_t *buffer, uint64_t value);
+uint64_t read_trace_u64(const byte_t *buffer);
+
+#endif /* TRACE_FORMAT_H */
@@ -10,6 +10,7 @@
 #define UTILITIES_H
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "definitions.h"
@@ -18,15 +19,38 @@
 #include "decode_instructions.h"
 #include "execute_instructions.h"
 #include "fetch_instructions.h"
+#include "interrupts.h"
+#include "console.h"
+#include "memory_export.h"
+#include "statistics.h"
+#include "branch_predictor.h"
+#include "metrics.h"
+#include "control_flow.h"
+#include "assembler.h"
+
+/* Run Cycle Status */
+#define CYCLE_CONTINUE 0
+#define CYCLE_BREAKPOINT 1
+#define CYCLE_LIMIT 2
+#define NO_CYCLE_LIMIT INT_MAX
 
 /* Function Prototypes */
-void load_memory(program_t *program, char *supplied_path);
+int load_memory(program_t *program, char *supplied_path);
 void memory_dump(byte_t *instruction_memory, byte_t *data_memory);
 void memory_write(byte_t *instruction_memory, byte_t *data_memory);
 void register_dump(word_t *register_file);
 void register_set(word_t *register_file);
 void set_breakpoint(int *breakpoint);
+int run_cycle(program_t *program, int cycle_limit);
+int run_cycles(program_t *program, int cycle_count);
+int step_instructions(program_t *program, int instruction_count);
 void run(program_t *program);
 void restart_program(program_t *program);
+void console_output(program_t *program);
+void branch_predictor(program_t *program);
+void cache_configuration(program_t *program);
+void data_profile_configuration(program_t *program);
+void memory_export(program_t *program);
+void memory_import(program_t *program);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,1506 @@
+/**
+ * @file assembler.c
+ * @brief Two pass XM23P assembler
+ *
+ * Assembles source text into the S-Records the loader reads, a symbol
+ * table and a listing in the layout of the X-Makina assembler. Pass one
+ * defines the labels, pass two encodes the instructions and directives.
+ * The records are kept in memory so a program can be loaded without
+ * being written out and parsed back.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-11
+ */
+
+#include "assembler.h"
+
+/* Listing text */
+#define LISTING_TITLE "X-Makina Assembler - Version XM-23p Single Pass+ Assembler - Release 24.05.16"
+#define LISTING_NAME_WIDTH 35
+
+/* Register or constant operand - source is a constant */
+#define RC_CONSTANT 0x0080
+/* Byte operation */
+#define WB_BYTE 0x0040
+/* Load and store addressing */
+#define ADDRESS_PRPO 0x0200
+#define ADDRESS_DEC 0x0100
+#define ADDRESS_INC 0x0080
+
+/* Operand ranges */
+#define LINK_OFFSET_MIN -4096
+#define LINK_OFFSET_MAX 4095
+#define BRANCH_OFFSET_MIN -512
+#define BRANCH_OFFSET_MAX 511
+#define RELATIVE_OFFSET_MIN -64
+#define RELATIVE_OFFSET_MAX 63
+
+/**
+ * @brief Operand layouts - instructions then directives
+ */
+typedef enum operand_format_t
+{
+    FORMAT_LINK,                /* BL label */
+    FORMAT_BRANCH,              /* Bcc label */
+    FORMAT_ARITHMETIC,          /* Register or constant, register */
+    FORMAT_MOVE,                /* Register, register */
+    FORMAT_SINGLE,              /* Register */
+    FORMAT_PRIORITY,            /* SETPRI priority */
+    FORMAT_SERVICE,             /* SVC number */
+    FORMAT_CONDITION_CODES,     /* SETCC/CLRCC flag letters */
+    FORMAT_CONDITIONAL,         /* CEX condition, true count, false count */
+    FORMAT_LOAD,                /* LD address register, register */
+    FORMAT_STORE,               /* ST register, address register */
+    FORMAT_LITERAL,             /* MOVx value, register */
+    FORMAT_LOAD_RELATIVE,       /* LDR register, offset, register */
+    FORMAT_STORE_RELATIVE,      /* STR register, register, offset */
+    DIRECTIVE_ORG,
+    DIRECTIVE_EQU,
+    DIRECTIVE_BYTE,
+    DIRECTIVE_WORD,
+    DIRECTIVE_BSS,
+    DIRECTIVE_ALIGN,
+    DIRECTIVE_CODE,
+    DIRECTIVE_DATA,
+    DIRECTIVE_END
+} operand_format_t;
+
+/**
+ * @brief Mnemonic or directive
+ */
+typedef struct mnemonic_t
+{
+    const char *name;
+    operand_format_t format;
+    word_t opcode;
+    int sized;                  /* Accepts .B/.W */
+} mnemonic_t;
+
+static const mnemonic_t mnemonics[] =
+{
+    {"BL",      FORMAT_LINK,            0x0000, 0},
+    {"BEQ",     FORMAT_BRANCH,          0x2000, 0},
+    {"BZ",      FORMAT_BRANCH,          0x2000, 0},
+    {"BNE",     FORMAT_BRANCH,          0x2400, 0},
+    {"BNZ",     FORMAT_BRANCH,          0x2400, 0},
+    {"BC",      FORMAT_BRANCH,          0x2800, 0},
+    {"BHS",     FORMAT_BRANCH,          0x2800, 0},
+    {"BNC",     FORMAT_BRANCH,          0x2C00, 0},
+    {"BLO",     FORMAT_BRANCH,          0x2C00, 0},
+    {"BN",      FORMAT_BRANCH,          0x3000, 0},
+    {"BGE",     FORMAT_BRANCH,          0x3400, 0},
+    {"BLT",     FORMAT_BRANCH,          0x3800, 0},
+    {"BRA",     FORMAT_BRANCH,          0x3C00, 0},
+    {"ADD",     FORMAT_ARITHMETIC,      0x4000, 1},
+    {"ADDC",    FORMAT_ARITHMETIC,      0x4100, 1},
+    {"SUB",     FORMAT_ARITHMETIC,      0x4200, 1},
+    {"SUBC",    FORMAT_ARITHMETIC,      0x4300, 1},
+    {"DADD",    FORMAT_ARITHMETIC,      0x4400, 1},
+    {"CMP",     FORMAT_ARITHMETIC,      0x4500, 1},
+    {"XOR",     FORMAT_ARITHMETIC,      0x4600, 1},
+    {"AND",     FORMAT_ARITHMETIC,      0x4700, 1},
+    {"OR",      FORMAT_ARITHMETIC,      0x4800, 1},
+    {"BIT",     FORMAT_ARITHMETIC,      0x4900, 1},
+    {"BIC",     FORMAT_ARITHMETIC,      0x4A00, 1},
+    {"BIS",     FORMAT_ARITHMETIC,      0x4B00, 1},
+    {"MOV",     FORMAT_MOVE,            0x4C00, 1},
+    {"SWAP",    FORMAT_MOVE,            0x4C80, 0},
+    {"SRA",     FORMAT_SINGLE,          0x4D00, 1},
+    {"RRC",     FORMAT_SINGLE,          0x4D08, 1},
+    {"SWPB",    FORMAT_SINGLE,          0x4D18, 0},
+    {"SXT",     FORMAT_SINGLE,          0x4D20, 0},
+    {"SETPRI",  FORMAT_PRIORITY,        0x4D80, 0},
+    {"SVC",     FORMAT_SERVICE,         0x4D90, 0},
+    {"SETCC",   FORMAT_CONDITION_CODES, 0x4DA0, 0},
+    {"CLRCC",   FORMAT_CONDITION_CODES, 0x4DC0, 0},
+    {"CEX",     FORMAT_CONDITIONAL,     0x5000, 0},
+    {"LD",      FORMAT_LOAD,            0x5800, 1},
+    {"ST",      FORMAT_STORE,           0x5C00, 1},
+    {"MOVL",    FORMAT_LITERAL,         0x6000, 0},
+    {"MOVLZ",   FORMAT_LITERAL,         0x6800, 0},
+    {"MOVLS",   FORMAT_LITERAL,         0x7000, 0},
+    {"MOVH",    FORMAT_LITERAL,         0x7800, 0},
+    {"LDR",     FORMAT_LOAD_RELATIVE,   0x8000, 1},
+    {"STR",     FORMAT_STORE_RELATIVE,  0xC000, 1},
+    {"ORG",     DIRECTIVE_ORG,          0x0000, 0},
+    {"EQU",     DIRECTIVE_EQU,          0x0000, 0},
+    {"BYTE",    DIRECTIVE_BYTE,         0x0000, 0},
+    {"WORD",    DIRECTIVE_WORD,         0x0000, 0},
+    {"BSS",     DIRECTIVE_BSS,          0x0000, 0},
+    {"ALIGN",   DIRECTIVE_ALIGN,        0x0000, 0},
+    {"CODE",    DIRECTIVE_CODE,         0x0000, 0},
+    {"DATA",    DIRECTIVE_DATA,         0x0000, 0},
+    {"END",     DIRECTIVE_END,          0x0000, 0}
+};
+#define MNEMONIC_COUNT (int)(sizeof(mnemonics) / sizeof(mnemonics[0]))
+
+/* Register or constant values - indexed by encoded constant */
+static const int constants[] = {0, 1, 2, 4, 8, 16, 32, -1};
+
+/* CEX conditions - indexed by encoded condition, aliases follow */
+static const char *conditions[] =
+{
+    "EQ", "NE", "CS", "CC", "MI", "PL", "VS", "VC",
+    "HI", "LS", "GE", "LT", "GT", "LE", "TR", "FL",
+    "HS", "LO"
+};
+#define CONDITION_COUNT 16
+#define CONDITION_HS 2
+#define CONDITION_LO 3
+
+/* Symbol table sections - indexed by symbol_type_t */
+static const char *symbol_sections[] = {"Constants (Equates)", "Labels (Code)", "Labels (Data)", "Registers"};
+static const char *symbol_types[] = {"ABS", "REL", "REL", "REG"};
+
+static const char *day_names[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char *month_names[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+/**
+ * @brief State of one pass over the source
+ */
+typedef struct assembly_pass_t
+{
+    int pass;                               /* 1 = Define labels, 2 = Encode */
+    int section;                            /* 0 = Code, 1 = Data */
+    word_t location[2];                     /* Location counter per section */
+    int line;                               /* Line being assembled - 1 based */
+    const char *error;                      /* First error on the line */
+    int forward;                            /* Pass one met an undefined symbol */
+    s_record_t record;                      /* Record being filled */
+    int pending;                            /* Data bytes in the record */
+} assembly_pass_t;
+
+/**
+ * @brief Note the first error on the line
+ *
+ * @param pass Pass state
+ * @param message Error message
+ * @return int Always -1 so callers can return it
+ */
+static int assembly_error(assembly_pass_t *pass, const char *message)
+{
+    if(pass->error == NULL)
+    {
+        pass->error = message;
+    }
+    return -1;
+}
+
+/**
+ * @brief Grow an array to hold one more element
+ *
+ * @param array Array pointer
+ * @param capacity Elements allocated
+ * @param count Elements used
+ * @param size Element size
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int reserve_element(void **array, int *capacity, int count, size_t size)
+{
+    if(count < *capacity)
+    {
+        return 0;
+    }
+    int length = (*capacity == 0) ? ASSEMBLY_INITIAL_LENGTH : 2 * *capacity;
+    void *grown = realloc(*array, length * size);
+    if(grown == NULL)
+    {
+        return -1;
+    }
+    *array = grown;
+    *capacity = length;
+    return 0;
+}
+
+/**
+ * @brief Compare text ignoring case
+ *
+ * @param text Text to compare
+ * @param upper Upper case text
+ * @return int [1 = Equal, 0 = Otherwise]
+ */
+static int equal_ignoring_case(const char *text, const char *upper)
+{
+    while(*text != '\0' && toupper((unsigned char)*text) == *upper)
+    {
+        text++;
+        upper++;
+    }
+    return *text == '\0' && *upper == '\0';
+}
+
+/**
+ * @brief Find a mnemonic or directive, with an optional .B or .W suffix
+ *
+ * @param token Token text
+ * @param byte Set to 1 for .B, 0 otherwise
+ * @param sized Set to 1 if a suffix was given
+ * @return const mnemonic_t* NULL if not a mnemonic
+ */
+static const mnemonic_t *find_mnemonic(const char *token, int *byte, int *sized)
+{
+    char name[ASSEMBLY_NAME_LENGTH];
+    int length = (int)strlen(token);
+    if(length >= ASSEMBLY_NAME_LENGTH)
+    {
+        return NULL;
+    }
+    memcpy(name, token, length + 1);
+    *byte = 0;
+    *sized = 0;
+    if(length > 2 && name[length - 2] == '.')
+    {
+        char suffix = (char)toupper((unsigned char)name[length - 1]);
+        if(suffix != 'B' && suffix != 'W')
+        {
+            return NULL;
+        }
+        *byte = (suffix == 'B');
+        *sized = 1;
+        name[length - 2] = '\0';
+    }
+    for(int index = 0; index < MNEMONIC_COUNT; index++)
+    {
+        if(equal_ignoring_case(name, mnemonics[index].name))
+        {
+            return &mnemonics[index];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Parse a register name R0 - R7
+ *
+ * @param text Operand text
+ * @return int [0 - 7 = Register, < 0 = Not a register]
+ */
+static int parse_register(const char *text)
+{
+    if((text[0] == 'R' || text[0] == 'r') && text[1] >= '0' && text[1] <= '7' && text[2] == '\0')
+    {
+        return text[1] - '0';
+    }
+    return -1;
+}
+
+/**
+ * @brief Find a symbol by name
+ *
+ * @param assembly Assembly
+ * @param name Symbol name
+ * @return assembly_symbol_t* NULL if undefined
+ */
+static assembly_symbol_t *find_symbol(assembly_t *assembly, const char *name)
+{
+    for(int index = 0; index < assembly->symbol_count; index++)
+    {
+        if(strcmp(assembly->symbols[index].name, name) == 0)
+        {
+            return &assembly->symbols[index];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Append an undefined symbol - symbols are listed in order of first appearance
+ *
+ * @param assembly Assembly
+ * @param name Symbol name
+ * @return assembly_symbol_t* NULL if out of memory
+ */
+static assembly_symbol_t *add_symbol(assembly_t *assembly, const char *name)
+{
+    if(reserve_element((void **)&assembly->symbols, &assembly->symbol_capacity, assembly->symbol_count,
+        sizeof(assembly_symbol_t)) != 0)
+    {
+        return NULL;
+    }
+    assembly_symbol_t *symbol = &assembly->symbols[assembly->symbol_count++];
+    memset(symbol, 0, sizeof(assembly_symbol_t));
+    snprintf(symbol->name, ASSEMBLY_NAME_LENGTH, "%s", name);
+    return symbol;
+}
+
+/**
+ * @brief Define a symbol, or update it on the second pass
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param name Symbol name
+ * @param type Symbol category
+ * @param value Symbol value
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int define_symbol(assembly_t *assembly, assembly_pass_t *pass, const char *name, symbol_type_t type, word_t value)
+{
+    if(!(isalpha((unsigned char)name[0]) || name[0] == '_') || strlen(name) >= ASSEMBLY_NAME_LENGTH)
+    {
+        return assembly_error(pass, "Invalid label");
+    }
+    for(const char *character = name; *character != '\0'; character++)
+    {
+        if(!(isalnum((unsigned char)*character) || *character == '_'))
+        {
+            return assembly_error(pass, "Invalid label");
+        }
+    }
+    if(parse_register(name) >= 0)
+    {
+        return assembly_error(pass, "Register name used as label");
+    }
+
+    assembly_symbol_t *symbol = find_symbol(assembly, name);
+    if(symbol != NULL && symbol->defined)
+    {
+        if(symbol->line != pass->line)
+        {
+            return assembly_error(pass, "Duplicate label");
+        }
+        symbol->value = value;
+        return 0;
+    }
+    if(symbol == NULL && (symbol = add_symbol(assembly, name)) == NULL)
+    {
+        return assembly_error(pass, "Out of memory");
+    }
+    symbol->type = type;
+    symbol->value = value;
+    symbol->line = pass->line;
+    symbol->defined = 1;
+    return 0;
+}
+
+/**
+ * @brief Parse a number, character or symbol
+ *
+ * Numbers are #hexadecimal, $decimal or decimal, with an optional sign
+ * after the prefix. An undefined symbol is 0 on the first pass.
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param text Text pointer - advanced past the term
+ * @param value Term value
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_term(assembly_t *assembly, assembly_pass_t *pass, const char **text, int *value)
+{
+    const char *character = *text;
+    int negative = 0;
+    int base = 10;
+    if(*character == '-')
+    {
+        negative = 1;
+        character++;
+    }
+    if(*character == '\'')
+    {
+        if(character[1] == '\0' || character[2] != '\'')
+        {
+            return assembly_error(pass, "Invalid character constant");
+        }
+        *value = (unsigned char)character[1];
+        character += 3;
+    }
+    else if(isalpha((unsigned char)*character) || *character == '_')
+    {
+        char name[ASSEMBLY_NAME_LENGTH];
+        int length = 0;
+        while(isalnum((unsigned char)*character) || *character == '_')
+        {
+            if(length == ASSEMBLY_NAME_LENGTH - 1)
+            {
+                return assembly_error(pass, "Symbol name too long");
+            }
+            name[length++] = *character++;
+        }
+        name[length] = '\0';
+        int register_number = parse_register(name);
+        assembly_symbol_t *symbol = (register_number >= 0) ? NULL : find_symbol(assembly, name);
+        if(register_number >= 0)
+        {
+            *value = register_number;
+        }
+        else if(symbol != NULL && symbol->defined)
+        {
+            *value = symbol->value;
+        }
+        else if(pass->pass == 1)
+        {
+            if(symbol == NULL && add_symbol(assembly, name) == NULL)
+            {
+                return assembly_error(pass, "Out of memory");
+            }
+            pass->forward = 1;
+            *value = 0;
+        }
+        else
+        {
+            return assembly_error(pass, "Undefined symbol");
+        }
+    }
+    else
+    {
+        if(*character == '#' || *character == '$')
+        {
+            base = (*character == '#') ? 16 : 10;
+            character++;
+            if(*character == '-')
+            {
+                negative = !negative;
+                character++;
+            }
+        }
+        if(!isxdigit((unsigned char)*character))
+        {
+            return assembly_error(pass, "Invalid number");
+        }
+        char *end;
+        long number = strtol(character, &end, base);
+        if(end == character || number > 0xFFFF)
+        {
+            return assembly_error(pass, "Invalid number");
+        }
+        *value = (int)number;
+        character = end;
+    }
+    if(negative)
+    {
+        *value = -*value;
+    }
+    *text = character;
+    return 0;
+}
+
+/**
+ * @brief Evaluate terms joined by + and -
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param text Operand text
+ * @param value Expression value
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_value(assembly_t *assembly, assembly_pass_t *pass, const char *text, int *value)
+{
+    int term;
+    if(*text == '\0')
+    {
+        return assembly_error(pass, "Missing operand");
+    }
+    if(parse_term(assembly, pass, &text, value) != 0)
+    {
+        return -1;
+    }
+    while(*text != '\0')
+    {
+        while(isspace((unsigned char)*text))
+        {
+            text++;
+        }
+        char operator = *text++;
+        while(isspace((unsigned char)*text))
+        {
+            text++;
+        }
+        if((operator != '+' && operator != '-') || parse_term(assembly, pass, &text, &term) != 0)
+        {
+            return assembly_error(pass, "Invalid expression");
+        }
+        *value = (operator == '+') ? *value + term : *value - term;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a value within a range
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param text Operand text
+ * @param minimum Smallest value accepted
+ * @param maximum Largest value accepted
+ * @param value Value parsed
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_ranged_value(assembly_t *assembly, assembly_pass_t *pass, const char *text,
+    int minimum, int maximum, int *value)
+{
+    if(parse_value(assembly, pass, text, value) != 0)
+    {
+        return -1;
+    }
+    if(*value < minimum || *value > maximum)
+    {
+        return assembly_error(pass, "Value out of range");
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse a register operand
+ *
+ * @param pass Pass state
+ * @param text Operand text
+ * @param number Register number
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_register_operand(assembly_pass_t *pass, const char *text, int *number)
+{
+    *number = parse_register(text);
+    return (*number < 0) ? assembly_error(pass, "Invalid register") : 0;
+}
+
+/**
+ * @brief Parse an LD/ST address register with increment or decrement
+ *
+ * +Rn and -Rn adjust before the access, Rn+ and Rn- after it.
+ *
+ * @param pass Pass state
+ * @param text Operand text
+ * @param number Register number
+ * @param addressing PRPO, DEC and INC bits
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_address_operand(assembly_pass_t *pass, const char *text, int *number, word_t *addressing)
+{
+    char name[3] = {0};
+    *addressing = 0;
+    if(*text == '+' || *text == '-')
+    {
+        *addressing = ADDRESS_PRPO | ((*text == '+') ? ADDRESS_INC : ADDRESS_DEC);
+        text++;
+    }
+    name[0] = text[0];
+    name[1] = (text[0] != '\0') ? text[1] : '\0';
+    if(name[1] != '\0' && (text[2] == '+' || text[2] == '-') && text[3] == '\0' && *addressing == 0)
+    {
+        *addressing = (text[2] == '+') ? ADDRESS_INC : ADDRESS_DEC;
+    }
+    else if(name[1] == '\0' || text[2] != '\0')
+    {
+        return assembly_error(pass, "Invalid address register");
+    }
+    return parse_register_operand(pass, name, number);
+}
+
+/**
+ * @brief Encode a branch displacement
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param text Target operand
+ * @param address Branch address
+ * @param minimum Smallest word offset
+ * @param maximum Largest word offset
+ * @param offset Word offset from the instruction after the branch
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_branch_offset(assembly_t *assembly, assembly_pass_t *pass, const char *text, word_t address,
+    int minimum, int maximum, int *offset)
+{
+    int target;
+    if(parse_value(assembly, pass, text, &target) != 0)
+    {
+        return -1;
+    }
+    int displacement = (int16_t)(word_t)(target - (address + WORD_LENGTH));
+    if(displacement & 1)
+    {
+        return assembly_error(pass, "Branch target not word aligned");
+    }
+    *offset = displacement / WORD_LENGTH;
+    if(*offset < minimum || *offset > maximum)
+    {
+        return assembly_error(pass, "Branch out of range");
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse SETCC/CLRCC flag letters V, S, N, Z and C
+ *
+ * @param pass Pass state
+ * @param text Operand text
+ * @param bits Flag bits
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_condition_codes(assembly_pass_t *pass, const char *text, int *bits)
+{
+    static const char flags[] = "CZNSV";
+    *bits = 0;
+    for(; *text != '\0'; text++)
+    {
+        const char *flag = strchr(flags, toupper((unsigned char)*text));
+        if(flag == NULL || (*bits & (1 << (flag - flags))))
+        {
+            return assembly_error(pass, "Invalid condition codes");
+        }
+        *bits |= 1 << (flag - flags);
+    }
+    return (*bits == 0) ? assembly_error(pass, "Invalid condition codes") : 0;
+}
+
+/**
+ * @brief Parse a CEX condition mnemonic
+ *
+ * @param pass Pass state
+ * @param text Operand text
+ * @param condition Encoded condition
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_condition(assembly_pass_t *pass, const char *text, int *condition)
+{
+    for(int index = 0; index < (int)(sizeof(conditions) / sizeof(conditions[0])); index++)
+    {
+        if(equal_ignoring_case(text, conditions[index]))
+        {
+            *condition = (index < CONDITION_COUNT) ? index
+                : (strcmp(conditions[index], "HS") == 0) ? CONDITION_HS : CONDITION_LO;
+            return 0;
+        }
+    }
+    return assembly_error(pass, "Invalid condition");
+}
+
+/**
+ * @brief Encode an instruction
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param mnemonic Instruction
+ * @param byte 1 for a .B suffix
+ * @param operands Operand text
+ * @param count Number of operands
+ * @param address Instruction address
+ * @param opcode Encoded instruction
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int encode_instruction(assembly_t *assembly, assembly_pass_t *pass, const mnemonic_t *mnemonic, int byte,
+    char **operands, int count, word_t address, word_t *opcode)
+{
+    static const int operand_counts[] = {1, 1, 2, 2, 1, 1, 1, 1, 3, 2, 2, 2, 3, 3};
+    int source = 0;
+    int destination = 0;
+    int value = 0;
+    int status = 0;
+    word_t addressing = 0;
+
+    if(count != operand_counts[mnemonic->format])
+    {
+        return assembly_error(pass, "Wrong number of operands");
+    }
+    *opcode = mnemonic->opcode | (byte ? WB_BYTE : 0);
+    switch(mnemonic->format)
+    {
+    case FORMAT_LINK:
+        status = parse_branch_offset(assembly, pass, operands[0], address, LINK_OFFSET_MIN, LINK_OFFSET_MAX, &value);
+        *opcode |= (word_t)(value & 0x1FFF);
+        break;
+    case FORMAT_BRANCH:
+        status = parse_branch_offset(assembly, pass, operands[0], address, BRANCH_OFFSET_MIN, BRANCH_OFFSET_MAX,
+            &value);
+        *opcode |= (word_t)(value & 0x03FF);
+        break;
+    case FORMAT_ARITHMETIC:
+        status = parse_register_operand(pass, operands[1], &destination);
+        source = parse_register(operands[0]);
+        if(status == 0 && source < 0)
+        {
+            status = parse_value(assembly, pass, operands[0], &value);
+            for(source = 0; status == 0 && source < (int)(sizeof(constants) / sizeof(constants[0])); source++)
+            {
+                if((word_t)constants[source] == (word_t)value)
+                {
+                    break;
+                }
+            }
+            if(status == 0 && source == (int)(sizeof(constants) / sizeof(constants[0])))
+            {
+                status = assembly_error(pass, "Invalid constant");
+            }
+            *opcode |= RC_CONSTANT;
+        }
+        *opcode |= (word_t)(source << 3 | destination);
+        break;
+    case FORMAT_MOVE:
+        status = parse_register_operand(pass, operands[0], &source);
+        status |= parse_register_operand(pass, operands[1], &destination);
+        *opcode |= (word_t)(source << 3 | destination);
+        break;
+    case FORMAT_SINGLE:
+        status = parse_register_operand(pass, operands[0], &destination);
+        *opcode |= (word_t)destination;
+        break;
+    case FORMAT_PRIORITY:
+        status = parse_ranged_value(assembly, pass, operands[0], 0, 7, &value);
+        *opcode |= (word_t)value;
+        break;
+    case FORMAT_SERVICE:
+        status = parse_ranged_value(assembly, pass, operands[0], 0, 15, &value);
+        *opcode |= (word_t)value;
+        break;
+    case FORMAT_CONDITION_CODES:
+        status = parse_condition_codes(pass, operands[0], &value);
+        *opcode |= (word_t)value;
+        break;
+    case FORMAT_CONDITIONAL:
+        status = parse_condition(pass, operands[0], &value);
+        status |= parse_ranged_value(assembly, pass, operands[1], 0, 7, &source);
+        status |= parse_ranged_value(assembly, pass, operands[2], 0, 7, &destination);
+        *opcode |= (word_t)(value << 6 | source << 3 | destination);
+        break;
+    case FORMAT_LOAD:
+        status = parse_address_operand(pass, operands[0], &source, &addressing);
+        status |= parse_register_operand(pass, operands[1], &destination);
+        *opcode |= (word_t)(addressing | source << 3 | destination);
+        break;
+    case FORMAT_STORE:
+        status = parse_register_operand(pass, operands[0], &source);
+        status |= parse_address_operand(pass, operands[1], &destination, &addressing);
+        *opcode |= (word_t)(addressing | source << 3 | destination);
+        break;
+    case FORMAT_LITERAL:
+        status = parse_ranged_value(assembly, pass, operands[0], INT16_MIN, UINT16_MAX, &value);
+        status |= parse_register_operand(pass, operands[1], &destination);
+        value = (mnemonic->opcode == 0x7800) ? ((word_t)value >> 8) : (value & 0xFF);
+        *opcode |= (word_t)(value << 3 | destination);
+        break;
+    case FORMAT_LOAD_RELATIVE:
+        status = parse_register_operand(pass, operands[0], &source);
+        status |= parse_ranged_value(assembly, pass, operands[1], RELATIVE_OFFSET_MIN, RELATIVE_OFFSET_MAX, &value);
+        status |= parse_register_operand(pass, operands[2], &destination);
+        *opcode |= (word_t)((value & 0x7F) << 7 | source << 3 | destination);
+        break;
+    case FORMAT_STORE_RELATIVE:
+        status = parse_register_operand(pass, operands[0], &source);
+        status |= parse_register_operand(pass, operands[1], &destination);
+        status |= parse_ranged_value(assembly, pass, operands[2], RELATIVE_OFFSET_MIN, RELATIVE_OFFSET_MAX, &value);
+        *opcode |= (word_t)((value & 0x7F) << 7 | source << 3 | destination);
+        break;
+    default:
+        status = -1;
+        break;
+    }
+    return status;
+}
+
+/**
+ * @brief Append the record being filled to the records
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int flush_record(assembly_t *assembly, assembly_pass_t *pass)
+{
+    if(pass->pending == 0)
+    {
+        return 0;
+    }
+    if(reserve_element((void **)&assembly->records, &assembly->record_capacity, assembly->record_count,
+        sizeof(s_record_t)) != 0)
+    {
+        return assembly_error(pass, "Out of memory");
+    }
+    pass->record.length = (byte_t)(pass->pending + ADDRESS_LENGTH + CHECKSUM_LENGTH);
+    assembly->records[assembly->record_count++] = pass->record;
+    pass->pending = 0;
+    return 0;
+}
+
+/**
+ * @brief Add a record holding the given data
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param type Record type
+ * @param address Record address
+ * @param data Record data
+ * @param length Data length
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int add_record(assembly_t *assembly, assembly_pass_t *pass, record_type_t type, word_t address,
+    const void *data, int length)
+{
+    if(flush_record(assembly, pass) != 0 || reserve_element((void **)&assembly->records,
+        &assembly->record_capacity, assembly->record_count, sizeof(s_record_t)) != 0)
+    {
+        return assembly_error(pass, "Out of memory");
+    }
+    s_record_t *record = &assembly->records[assembly->record_count++];
+    record->type = type;
+    record->length = (byte_t)(length + ADDRESS_LENGTH + CHECKSUM_LENGTH);
+    record->address[0] = (byte_t)(address >> 8);
+    record->address[1] = (byte_t)address;
+    if(length > 0)
+    {
+        memcpy(record->data, data, length);
+    }
+    return 0;
+}
+
+/**
+ * @brief Place a byte at the location counter of the current section
+ *
+ * Bytes are gathered into S1 (code) or S2 (data) records, a new record
+ * starting on a change of section or address, or when the record is full.
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param value Byte
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int emit_byte(assembly_t *assembly, assembly_pass_t *pass, byte_t value)
+{
+    word_t address = pass->location[pass->section];
+    pass->location[pass->section]++;
+    if(pass->pass == 1)
+    {
+        return 0;
+    }
+    record_type_t type = pass->section ? DATA_TYPE : INSTRUCTION_TYPE;
+    word_t next = (word_t)((pass->record.address[0] << 8 | pass->record.address[1]) + pass->pending);
+    if(pass->pending > 0 && (pass->record.type != type || next != address || pass->pending == ASSEMBLY_RECORD_DATA))
+    {
+        if(flush_record(assembly, pass) != 0)
+        {
+            return -1;
+        }
+    }
+    if(pass->pending == 0)
+    {
+        pass->record.type = type;
+        pass->record.address[0] = (byte_t)(address >> 8);
+        pass->record.address[1] = (byte_t)address;
+    }
+    pass->record.data[pass->pending++] = value;
+    return 0;
+}
+
+/**
+ * @brief Place a little endian word at the location counter
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param value Word
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int emit_word(assembly_t *assembly, assembly_pass_t *pass, word_t value)
+{
+    if(emit_byte(assembly, pass, (byte_t)value) != 0)
+    {
+        return -1;
+    }
+    return emit_byte(assembly, pass, (byte_t)(value >> 8));
+}
+
+/**
+ * @brief Split operands at commas outside quotes and trim them
+ *
+ * @param text Operand text - modified
+ * @param operands Operand pointers
+ * @param limit Most operands stored
+ * @return int Number of operands, more than limit if some were dropped
+ */
+static int split_operands(char *text, char **operands, int limit)
+{
+    int count = 0;
+    int quoted = 0;
+    if(*text == '\0')
+    {
+        return 0;
+    }
+    char *start = text;
+    for(char *character = text; ; character++)
+    {
+        if(*character == '"' || *character == '\'')
+        {
+            quoted = !quoted;
+        }
+        if(*character == '\0' || (*character == ',' && !quoted))
+        {
+            int last = (*character == '\0');
+            *character = '\0';
+            while(isspace((unsigned char)*start))
+            {
+                start++;
+            }
+            for(char *end = character - 1; end >= start && isspace((unsigned char)*end); end--)
+            {
+                *end = '\0';
+            }
+            if(count < limit)
+            {
+                operands[count] = start;
+            }
+            count++;
+            if(last)
+            {
+                break;
+            }
+            start = character + 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Assemble a directive
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param mnemonic Directive
+ * @param operands Operand text
+ * @param count Number of operands
+ * @param listed Listing entry for the line
+ * @return int [0 = SUCCESS, 1 = END, < 0 = FAILURE]
+ */
+static int assemble_directive(assembly_t *assembly, assembly_pass_t *pass, const mnemonic_t *mnemonic,
+    char **operands, int count, assembly_line_t *listed)
+{
+    int value = 0;
+    int status = 0;
+    int undefined = 0;
+    int forward = pass->forward;
+    switch(mnemonic->format)
+    {
+    case DIRECTIVE_ORG:
+    case DIRECTIVE_BSS:
+        /* Later labels depend on the location so the value must be known on the first pass */
+        pass->forward = 0;
+        status = (count != 1 || parse_ranged_value(assembly, pass, operands[0], INT16_MIN, UINT16_MAX, &value) != 0);
+        undefined = pass->forward;
+        pass->forward |= forward;
+        if(status != 0)
+        {
+            return assembly_error(pass, "Invalid operand");
+        }
+        if(undefined)
+        {
+            return assembly_error(pass, "Value must be defined before use");
+        }
+        pass->location[pass->section] = (mnemonic->format == DIRECTIVE_ORG)
+            ? (word_t)value : (word_t)(pass->location[pass->section] + value);
+        return 0;
+    case DIRECTIVE_ALIGN:
+        pass->location[pass->section] = (word_t)((pass->location[pass->section] + 1) & ~1);
+        return 0;
+    case DIRECTIVE_CODE:
+    case DIRECTIVE_DATA:
+        pass->section = (mnemonic->format == DIRECTIVE_DATA);
+        return 0;
+    case DIRECTIVE_END:
+        if(count > 1 || (count == 1 && parse_ranged_value(assembly, pass, operands[0], 0, UINT16_MAX, &value) != 0))
+        {
+            return assembly_error(pass, "Invalid operand");
+        }
+        assembly->starting_address = (word_t)value;
+        return 1;
+    case DIRECTIVE_WORD:
+    case DIRECTIVE_BYTE:
+        if(count == 0)
+        {
+            return assembly_error(pass, "Missing operand");
+        }
+        listed->address = pass->location[pass->section];
+        for(int index = 0; index < count && index < ASSEMBLY_LINE_LENGTH; index++)
+        {
+            char *operand = operands[index];
+            int length = (int)strlen(operand);
+            if(mnemonic->format == DIRECTIVE_BYTE && length >= 2 && operand[0] == '"' && operand[length - 1] == '"')
+            {
+                for(int character = 1; character < length - 1; character++)
+                {
+                    emit_byte(assembly, pass, (byte_t)operand[character]);
+                }
+                value = (length > 2) ? (byte_t)operand[1] : 0;
+            }
+            else if(mnemonic->format == DIRECTIVE_BYTE)
+            {
+                if(parse_ranged_value(assembly, pass, operand, INT8_MIN, UINT8_MAX, &value) != 0)
+                {
+                    return -1;
+                }
+                emit_byte(assembly, pass, (byte_t)value);
+            }
+            else
+            {
+                if(parse_ranged_value(assembly, pass, operand, INT16_MIN, UINT16_MAX, &value) != 0)
+                {
+                    return -1;
+                }
+                emit_word(assembly, pass, (word_t)value);
+            }
+            if(index == 0)
+            {
+                listed->listing = LISTING_WORD;
+                listed->value = (mnemonic->format == DIRECTIVE_BYTE) ? (byte_t)value : (word_t)value;
+            }
+        }
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief Assemble one source line
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @param text Line text, without the line ending
+ * @param length Line length
+ * @param listed Listing entry for the line
+ * @return int [0 = SUCCESS, 1 = END, < 0 = FAILURE]
+ */
+static int assemble_line(assembly_t *assembly, assembly_pass_t *pass, const char *text, int length,
+    assembly_line_t *listed)
+{
+    char line[ASSEMBLY_LINE_LENGTH];
+    char *operands[ASSEMBLY_OPERANDS];
+    char label[ASSEMBLY_LINE_LENGTH] = {0};
+    int quoted = 0;
+
+    /* Copy without the comment */
+    if(length >= ASSEMBLY_LINE_LENGTH)
+    {
+        length = ASSEMBLY_LINE_LENGTH - 1;
+    }
+    int used = 0;
+    for(; used < length && (text[used] != ';' || quoted); used++)
+    {
+        if(text[used] == '"' || text[used] == '\'')
+        {
+            quoted = !quoted;
+        }
+        line[used] = text[used];
+    }
+    line[used] = '\0';
+
+    /* Label in column one unless it is a mnemonic */
+    char *character = line;
+    char *token = NULL;
+    int byte = 0;
+    int sized = 0;
+    const mnemonic_t *mnemonic = NULL;
+    if(*character != '\0' && !isspace((unsigned char)*character))
+    {
+        token = character;
+        while(*character != '\0' && !isspace((unsigned char)*character))
+        {
+            character++;
+        }
+        if(*character != '\0')
+        {
+            *character++ = '\0';
+        }
+        mnemonic = find_mnemonic(token, &byte, &sized);
+        if(mnemonic == NULL)
+        {
+            strcpy(label, token);
+            if(label[0] != '\0' && label[strlen(label) - 1] == ':')
+            {
+                label[strlen(label) - 1] = '\0';
+            }
+        }
+    }
+    if(mnemonic == NULL)
+    {
+        while(isspace((unsigned char)*character))
+        {
+            character++;
+        }
+        token = character;
+        while(*character != '\0' && !isspace((unsigned char)*character))
+        {
+            character++;
+        }
+        if(*character != '\0')
+        {
+            *character++ = '\0';
+        }
+        if(*token != '\0')
+        {
+            mnemonic = find_mnemonic(token, &byte, &sized);
+            if(mnemonic == NULL)
+            {
+                return assembly_error(pass, "Unknown instruction");
+            }
+        }
+    }
+    while(isspace((unsigned char)*character))
+    {
+        character++;
+    }
+    int count = split_operands(character, operands, ASSEMBLY_OPERANDS);
+    if(mnemonic != NULL && sized && !mnemonic->sized)
+    {
+        return assembly_error(pass, "Size suffix not allowed");
+    }
+
+    /* Define the label - equates take the operand value */
+    if(label[0] != '\0')
+    {
+        if(mnemonic != NULL && mnemonic->format == DIRECTIVE_EQU)
+        {
+            int value = 0;
+            if(count != 1 || parse_ranged_value(assembly, pass, operands[0], INT16_MIN, UINT16_MAX, &value) != 0)
+            {
+                return assembly_error(pass, "Invalid operand");
+            }
+            return define_symbol(assembly, pass, label, SYMBOL_EQUATE, (word_t)value);
+        }
+        if(define_symbol(assembly, pass, label, pass->section ? SYMBOL_DATA : SYMBOL_CODE,
+            pass->location[pass->section]) != 0)
+        {
+            return -1;
+        }
+    }
+    if(mnemonic == NULL)
+    {
+        return 0;
+    }
+    if(mnemonic->format == DIRECTIVE_EQU)
+    {
+        return assembly_error(pass, "EQU requires a label");
+    }
+    if(mnemonic->format >= DIRECTIVE_ORG)
+    {
+        return assemble_directive(assembly, pass, mnemonic, operands, count, listed);
+    }
+
+    /* Instruction */
+    word_t address = pass->location[pass->section];
+    word_t opcode = 0;
+    if(address & 1)
+    {
+        return assembly_error(pass, "Instruction at odd address");
+    }
+    const char *error = pass->error;
+    int status = encode_instruction(assembly, pass, mnemonic, byte,
+        operands, (count > ASSEMBLY_OPERANDS) ? ASSEMBLY_OPERANDS + 1 : count, address, &opcode);
+    if(pass->pass == 1)
+    {
+        /* Operands may refer to labels not yet defined - checked on the second pass */
+        pass->error = error;
+    }
+    else if(status != 0)
+    {
+        opcode = 0;
+    }
+    listed->listing = LISTING_WORD;
+    listed->address = address;
+    listed->value = opcode;
+    return emit_word(assembly, pass, opcode);
+}
+
+/**
+ * @brief Make one pass over the source
+ *
+ * @param assembly Assembly
+ * @param pass Pass state
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int assemble_pass(assembly_t *assembly, assembly_pass_t *pass)
+{
+    int ended = 0;
+    for(int index = 0; index < assembly->line_count && !ended; index++)
+    {
+        assembly_line_t *listed = &assembly->lines[index];
+        pass->line = index + 1;
+        pass->error = NULL;
+        listed->listing = LISTING_NONE;
+        int status = assemble_line(assembly, pass, &assembly->source[listed->start], listed->length, listed);
+        ended = (status == 1);
+        if(pass->pass == 1 || pass->error != NULL)
+        {
+            /* First pass errors stand unless the second pass finds its own */
+            listed->error = pass->error;
+        }
+        if(pass->pass == 2)
+        {
+            assembly->error_count += (listed->error != NULL);
+        }
+        if(ended && index + 1 < assembly->line_count)
+        {
+            /* Lines after END are neither assembled nor listed */
+            assembly->line_count = index + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Assemble source text
+ *
+ * @param assembly Assembly - zero initialised or from an earlier assembly
+ * @param source Source text
+ * @param name Source name for the S0 record and listing
+ * @return int [0 = SUCCESS, > 0 = Number of source errors, < 0 = FAILURE]
+ */
+int assemble_source(assembly_t *assembly, const char *source, const char *name)
+{
+    if(assembly == NULL || source == NULL || name == NULL)
+    {
+        return -1;
+    }
+    int source_length = (int)strlen(source);
+    char *copy = realloc(assembly->source, source_length + 1);
+    if(copy == NULL)
+    {
+        return -2;
+    }
+    memcpy(copy, source, source_length + 1);
+    assembly->source = copy;
+    snprintf(assembly->name, MAX_PATH_LENGTH, "%s", name);
+    assembly->record_count = 0;
+    assembly->symbol_count = 0;
+    assembly->line_count = 0;
+    assembly->error_count = 0;
+    assembly->starting_address = 0;
+
+    /* Split into lines */
+    for(int start = 0; start < source_length; )
+    {
+        int end = start;
+        while(end < source_length && copy[end] != '\n')
+        {
+            end++;
+        }
+        if(reserve_element((void **)&assembly->lines, &assembly->line_capacity, assembly->line_count,
+            sizeof(assembly_line_t)) != 0)
+        {
+            return -3;
+        }
+        assembly_line_t *line = &assembly->lines[assembly->line_count++];
+        memset(line, 0, sizeof(assembly_line_t));
+        line->start = start;
+        line->length = (end > start && copy[end - 1] == '\r') ? end - start - 1 : end - start;
+        start = end + 1;
+    }
+
+    /* Registers head the symbol table */
+    assembly_pass_t pass;
+    memset(&pass, 0, sizeof(assembly_pass_t));
+    for(int number = 0; number < REGISTER_FILE_LENGTH; number++)
+    {
+        char name[ASSEMBLY_NAME_LENGTH];
+        snprintf(name, ASSEMBLY_NAME_LENGTH, "R%d", number);
+        assembly_symbol_t *symbol = add_symbol(assembly, name);
+        if(symbol == NULL)
+        {
+            return -3;
+        }
+        symbol->type = SYMBOL_REGISTER;
+        symbol->value = (word_t)number;
+        symbol->defined = 1;
+    }
+
+    pass.pass = 1;
+    assemble_pass(assembly, &pass);
+    assembly->passes = pass.forward ? 2 : 1;
+
+    memset(&pass, 0, sizeof(assembly_pass_t));
+    pass.pass = 2;
+    int name_length = (int)strlen(assembly->name);
+    if(name_length > MAX_RECORD_LENGTH - ADDRESS_LENGTH - CHECKSUM_LENGTH - 1)
+    {
+        name_length = MAX_RECORD_LENGTH - ADDRESS_LENGTH - CHECKSUM_LENGTH - 1;
+    }
+    add_record(assembly, &pass, NAME_TYPE, 0, assembly->name, name_length);
+    assemble_pass(assembly, &pass);
+    flush_record(assembly, &pass);
+    add_record(assembly, &pass, ADDRESS_TYPE, assembly->starting_address, NULL, 0);
+    return assembly->error_count;
+}
+
+/**
+ * @brief Assemble a source file
+ *
+ * @param assembly Assembly - zero initialised or from an earlier assembly
+ * @param path Source path
+ * @return int [0 = SUCCESS, > 0 = Number of source errors, < 0 = FAILURE]
+ */
+int assemble_file(assembly_t *assembly, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *source = malloc(length + 1);
+    if(source == NULL || length < 0 || fread(source, 1, length, file) != (size_t)length)
+    {
+        free(source);
+        fclose(file);
+        return -2;
+    }
+    fclose(file);
+    source[length] = '\0';
+
+    /* Name records after the file, not the directory */
+    const char *name = path;
+    for(const char *character = path; *character != '\0'; character++)
+    {
+        if(*character == '/' || *character == '\\')
+        {
+            name = character + 1;
+        }
+    }
+    int status = assemble_source(assembly, source, name);
+    free(source);
+    return status;
+}
+
+/**
+ * @brief Write the records as an S-Record (.xme) file
+ *
+ * @param assembly Assembly
+ * @param file Open output file
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int write_assembly_records(assembly_t *assembly, FILE *file)
+{
+    for(int index = 0; index < assembly->record_count; index++)
+    {
+        s_record_t *record = &assembly->records[index];
+        int data_length = record->length - ADDRESS_LENGTH - CHECKSUM_LENGTH;
+        byte_t sum = (byte_t)(record->length + record->address[0] + record->address[1]);
+        fprintf(file, "S%c%02X%02X%02X", record->type, record->length, record->address[0], record->address[1]);
+        for(int position = 0; position < data_length; position++)
+        {
+            fprintf(file, "%02X", record->data[position]);
+            sum += record->data[position];
+        }
+        fprintf(file, "%02X\n", (byte_t)~sum);
+    }
+    return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Write the listing - source lines with addresses and values, then the symbol table
+ *
+ * @param assembly Assembly
+ * @param file Open output file
+ * @param records_path S-Record file named at the end of the listing
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int write_assembly_listing(assembly_t *assembly, FILE *file, const char *records_path)
+{
+    time_t now = time(NULL);
+    struct tm *local = localtime(&now);
+    fprintf(file, "%s\n", LISTING_TITLE);
+    fprintf(file, "Input file name: %s\n", assembly->name);
+    fprintf(file, "Time of assembly: %s %d %s %d %02d:%02d:%02d \n", day_names[local->tm_wday], local->tm_mday,
+        month_names[local->tm_mon], local->tm_year + 1900, local->tm_hour, local->tm_min, local->tm_sec);
+
+    for(int index = 0; index < assembly->line_count; index++)
+    {
+        assembly_line_t *line = &assembly->lines[index];
+        if(line->listing == LISTING_WORD)
+        {
+            fprintf(file, "%3d\t%04X\t%04X\t", index + 1, line->address, line->value);
+        }
+        else
+        {
+            fprintf(file, "%3d\t    \t     \t", index + 1);
+        }
+        fwrite(&assembly->source[line->start], 1, line->length, file);
+        if(assembly->source[line->start + line->length] != '\0')
+        {
+            /* Source line endings are kept - a last line without one runs into the summary */
+            fprintf(file, "\n");
+        }
+        if(line->error != NULL)
+        {
+            fprintf(file, "** Error: %s\n", line->error);
+        }
+    }
+
+    if(assembly->error_count == 0)
+    {
+        fprintf(file, "\nSuccessful completion of assembly - %dP\n", assembly->passes);
+    }
+    else
+    {
+        fprintf(file, "\nAssembly failed with %d errors - %dP\n", assembly->error_count, assembly->passes);
+    }
+    fprintf(file, "\n** Symbol table **\n\n");
+    for(int type = SYMBOL_EQUATE; type <= SYMBOL_REGISTER; type++)
+    {
+        fprintf(file, "%s\n%-*s\tType\tValue\tDecimal\n", symbol_sections[type], LISTING_NAME_WIDTH, "Name");
+        for(int index = assembly->symbol_count - 1; index >= 0; index--)
+        {
+            assembly_symbol_t *symbol = &assembly->symbols[index];
+            if(symbol->defined && symbol->type == (symbol_type_t)type)
+            {
+                fprintf(file, "%-*s\t%s\t%04X\t%d\tPRI\n", LISTING_NAME_WIDTH, symbol->name, symbol_types[type],
+                    symbol->value, symbol->value);
+            }
+        }
+        fprintf(file, "\n");
+    }
+    fprintf(file, ".XME file: %s\n\n", records_path);
+    return ferror(file) ? -1 : 0;
+}
+
+/**
+ * @brief Print each error with its source line number
+ *
+ * @param assembly Assembly
+ */
+void print_assembly_errors(assembly_t *assembly)
+{
+    for(int index = 0; index < assembly->line_count; index++)
+    {
+        if(assembly->lines[index].error != NULL)
+        {
+            printf("%s:%d: %s\n", assembly->name, index + 1, assembly->lines[index].error);
+        }
+    }
+}
+
+/**
+ * @brief Free the memory held by an assembly
+ *
+ * @param assembly Assembly
+ */
+void release_assembly(assembly_t *assembly)
+{
+    free(assembly->source);
+    free(assembly->records);
+    free(assembly->symbols);
+    free(assembly->lines);
+    memset(assembly, 0, sizeof(assembly_t));
+}
+
+/**
+ * @brief Check a path names assembly source
+ *
+ * @param path File path
+ * @return int [1 = Assembly source, 0 = Otherwise]
+ */
+int is_assembly_path(const char *path)
+{
+    int length = (int)strlen(path);
+    int extension_length = (int)strlen(ASSEMBLY_EXTENSION);
+    if(length < extension_length)
+    {
+        return 0;
+    }
+    const char *extension = &path[length - extension_length];
+    for(int index = 0; index < extension_length; index++)
+    {
+        if(tolower((unsigned char)extension[index]) != ASSEMBLY_EXTENSION[index])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,920 @@
+/**
+ * @file batch.c
+ * @brief Lockstep execution of many instances of one program
+ *
+ * Parameter sweeps run one program image many times with different initial
+ * registers or data. A batch runs every instance as a lane of one engine:
+ * the instruction is fetched and decoded once per step and its handler
+ * updates all lanes in a single loop over the structure of arrays. Updates
+ * are masked rather than branched on, so the compiler vectorizes the loops
+ * with the host SIMD instructions.
+ *
+ * Lanes follow the pipelined core instruction by instruction - PC reads,
+ * branch targets, CEX, the instruction after a PC write and breakpoints
+ * behave as they do in run(). Timing is not modelled. SVC and device
+ * registers need the pipelined core and stop the lane.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-15
+ */
+
+#include "batch.h"
+
+/* Final lane states - indexed by lane_state_t */
+static const char *lane_state_names[] = {"Running", "Breakpoint", "Instruction Limit", "Unsupported"};
+
+/* Condition tested by each conditional branch, BEQ through BLT */
+static const condition_code_t branch_conditions[BLT - BEQ + 1] =
+{
+    EQUAL, NOT_EQUAL, CARRY, NOT_CARRY, NEGATIVE, SIGNED_GREATER_EQUAL, SIGNED_LESS
+};
+
+/* Sweep register names - indexed by register number */
+static const char *sweep_register_names[] = {"r0", "r1", "r2", "r3", "r4", "r5", "r6"};
+
+/**
+ * @brief Source operand of a lane - register or constant selected by RC
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ * @param lane Lane
+ * @return word_t Source operand
+ */
+static inline word_t lane_source(batch_t *batch, const instruction_t *instruction, int lane)
+{
+    return INSTRUCTION_RC(instruction) ? batch->constants[instruction->source]
+        : batch->registers[instruction->source][lane];
+}
+
+/**
+ * @brief PSW with Carry, Zero, Negative and Overflow replaced
+ *
+ * @param psw Program status word
+ * @param carry Carry Flag [0, 1]
+ * @param zero Zero Flag [0, 1]
+ * @param negative Negative Flag [0, 1]
+ * @param overflow Overflow Flag [0, 1]
+ * @return word_t Updated program status word
+ */
+static inline word_t lane_status(word_t psw, unsigned int carry, unsigned int zero, unsigned int negative, unsigned int overflow)
+{
+    return (word_t)((psw & ~((ONE_BIT << PSW_CARRY_BIT) | (ONE_BIT << PSW_ZERO_BIT) | (ONE_BIT << PSW_NEGATIVE_BIT)
+        | (ONE_BIT << PSW_OVERFLOW_BIT)))
+        | (carry << PSW_CARRY_BIT) | (zero << PSW_ZERO_BIT) | (negative << PSW_NEGATIVE_BIT) | (overflow << PSW_OVERFLOW_BIT));
+}
+
+/**
+ * @brief PSW with Zero and Negative replaced
+ *
+ * @param psw Program status word
+ * @param zero Zero Flag [0, 1]
+ * @param negative Negative Flag [0, 1]
+ * @return word_t Updated program status word
+ */
+static inline word_t lane_logic_status(word_t psw, unsigned int zero, unsigned int negative)
+{
+    return (word_t)((psw & ~((ONE_BIT << PSW_ZERO_BIT) | (ONE_BIT << PSW_NEGATIVE_BIT)))
+        | (zero << PSW_ZERO_BIT) | (negative << PSW_NEGATIVE_BIT));
+}
+
+/**
+ * @brief ADD, ADDC, SUB, SUBC and CMP over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_arithmetic(batch_t *batch, const instruction_t *instruction)
+{
+    unsigned int byte = INSTRUCTION_WB(instruction);
+    unsigned int msb = byte ? 7 : 15;
+    unsigned int width = byte ? EIGHT_BITS : 0xFFFF;
+    int type = instruction->type;
+    /* SUB and CMP add the 2's complement, SUBC the 1's complement and carry */
+    int complement = (type == SUB || type == SUBC || type == CMP);
+    word_t negate = (type == SUB || type == CMP);
+    unsigned int with_carry = (type == ADDC || type == SUBC);
+    int write = (type != CMP);
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        word_t source = lane_source(batch, instruction, lane);
+        source = complement ? (word_t)(~source + negate) : source;
+        unsigned int s = source & width;
+        unsigned int d = destination[lane] & width;
+        unsigned int result = s + d + (with_carry & PSW_BIT(psw[lane], PSW_CARRY_BIT));
+        word_t truncated = (word_t)result;
+        /* Operands of one sign with a result of the other - the byte result keeps its carry, as in test_overflow */
+        unsigned int overflow = ((s >> msb) & (d >> msb) & ((truncated >> msb) == 0))
+            | (((s >> msb) == 0) & ((d >> msb) == 0) & ((truncated >> msb) != 0));
+        word_t value = byte ? (word_t)((destination[lane] & 0xFF00) | (result & EIGHT_BITS)) : truncated;
+        destination[lane] = LANE_SELECT(mask[lane], write ? value : destination[lane], destination[lane]);
+        psw[lane] = LANE_SELECT(mask[lane], lane_status(psw[lane], result > width, (result & width) == 0,
+            (result >> msb) & ONE_BIT, overflow), psw[lane]);
+    }
+}
+
+/**
+ * @brief DADD over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_dadd(batch_t *batch, const instruction_t *instruction)
+{
+    unsigned int digit_mask = INSTRUCTION_WB(instruction) ? 0x00FF : 0xFFFF;
+    unsigned int carry_bits = INSTRUCTION_WB(instruction) ? 0x00110 : 0x11110;
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        unsigned int source = lane_source(batch, instruction, lane) & digit_mask;
+        unsigned int d = destination[lane] & digit_mask;
+        /* Biased digits carry in binary - see execute_dadd */
+        unsigned int biased = source + (0x6666 & digit_mask);
+        unsigned int sum = biased + d + PSW_BIT(psw[lane], PSW_CARRY_BIT);
+        unsigned int carries = sum ^ biased ^ d;
+        unsigned int no_carry = ~carries & carry_bits;
+        sum = (sum - ((no_carry >> 2) | (no_carry >> 3))) & digit_mask;
+        word_t value = (word_t)((destination[lane] & ~digit_mask) | sum);
+        destination[lane] = LANE_SELECT(mask[lane], value, destination[lane]);
+        psw[lane] = LANE_SELECT(mask[lane], lane_status(psw[lane], (carries & (digit_mask + 1)) != 0, sum == 0, 0, 0),
+            psw[lane]);
+    }
+}
+
+/**
+ * @brief XOR, AND and OR over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_logic(batch_t *batch, const instruction_t *instruction)
+{
+    unsigned int msb = INSTRUCTION_WB(instruction) ? 7 : 15;
+    word_t width = INSTRUCTION_WB(instruction) ? EIGHT_BITS : 0xFFFF;
+    int type = instruction->type;
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        /* Byte operations clear the high byte of the source only */
+        word_t source = lane_source(batch, instruction, lane) & width;
+        word_t d = destination[lane];
+        word_t value = (type == XOR) ? (word_t)(d ^ source) : (type == AND) ? (word_t)(d & source) : (word_t)(d | source);
+        destination[lane] = LANE_SELECT(mask[lane], value, d);
+        psw[lane] = LANE_SELECT(mask[lane], lane_logic_status(psw[lane], (value & width) == 0, (value >> msb) & ONE_BIT),
+            psw[lane]);
+    }
+}
+
+/**
+ * @brief BIT, BIC and BIS over all lanes
+ *
+ * A bit number past the operand leaves the lane unchanged.
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_bit(batch_t *batch, const instruction_t *instruction)
+{
+    unsigned int msb = INSTRUCTION_WB(instruction) ? 7 : 15;
+    word_t width = INSTRUCTION_WB(instruction) ? EIGHT_BITS : 0xFFFF;
+    int type = instruction->type;
+    word_t *destination = batch->registers[instruction->destination];
+    /* BIC and BIS take the bit number from the register, as the pipelined core does */
+    word_t *bit_register = batch->registers[instruction->source];
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        word_t source = lane_source(batch, instruction, lane) & width;
+        word_t enabled = (source <= msb) ? mask[lane] : LANE_OFF;
+        word_t d = destination[lane];
+        if(type == BIT)
+        {
+            unsigned int tested = d & (ONE_BIT << (source & FOUR_BITS));
+            psw[lane] = LANE_SELECT(enabled, lane_logic_status(psw[lane], tested == 0, PSW_BIT(psw[lane], PSW_NEGATIVE_BIT)),
+                psw[lane]);
+        }
+        else
+        {
+            /* Counts past 31 wrap as the host shift does in execute_bic and execute_bis */
+            word_t bit = (word_t)(1u << (bit_register[lane] & 31));
+            word_t value = (type == BIC) ? (word_t)(d & ~bit) : (word_t)(d | bit);
+            destination[lane] = LANE_SELECT(enabled, value, d);
+            psw[lane] = LANE_SELECT(enabled, lane_logic_status(psw[lane], (value & width) == 0, (value >> msb) & ONE_BIT),
+                psw[lane]);
+        }
+    }
+}
+
+/**
+ * @brief SRA, RRC, SWPB and SXT over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_shift(batch_t *batch, const instruction_t *instruction)
+{
+    int byte = INSTRUCTION_WB(instruction);
+    int type = instruction->type;
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        word_t d = destination[lane];
+        word_t value = d;
+        word_t status = psw[lane];
+        if(type == SRA && !byte)
+        {
+            value = (word_t)((short)d >> 1);
+            status = lane_logic_status(status, value == 0, value >> 15);
+        }
+        else if(type == SRA)
+        {
+            byte_t low = (byte_t)((signed char)d >> 1);
+            value = (word_t)((d & 0xFF00) | low);
+            status = lane_logic_status(status, low == 0, low >> 7);
+        }
+        else if(type == RRC && !byte)
+        {
+            value = (word_t)((d >> 1) | (PSW_BIT(status, PSW_CARRY_BIT) << 15));
+            status = lane_status(status, d & ONE_BIT, value == 0, value >> 15, PSW_BIT(status, PSW_OVERFLOW_BIT));
+        }
+        else if(type == RRC)
+        {
+            /* Flags test the shifted byte without the carry in, as execute_rrc does */
+            byte_t low = (byte_t)((d & EIGHT_BITS) >> 1);
+            value = (word_t)((d & 0xFF00) | (PSW_BIT(status, PSW_CARRY_BIT) << 7) | low);
+            status = lane_status(status, d & ONE_BIT, low == 0, low >> 7, PSW_BIT(status, PSW_OVERFLOW_BIT));
+        }
+        else if(type == SWPB)
+        {
+            value = (word_t)((d << 8) | (d >> 8));
+        }
+        else
+        {
+            value = (d & BIT_7) ? (word_t)(d | 0xFF00) : (word_t)(d & 0x00FF);
+            status = lane_logic_status(status, value == 0, value >> 15);
+        }
+        destination[lane] = LANE_SELECT(mask[lane], value, d);
+        psw[lane] = LANE_SELECT(mask[lane], status, psw[lane]);
+    }
+}
+
+/**
+ * @brief MOV, SWAP, MOVL, MOVLZ, MOVLS and MOVH over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_move(batch_t *batch, const instruction_t *instruction)
+{
+    int type = instruction->type;
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *source = batch->registers[instruction->source];
+    word_t *mask = batch->mask;
+    word_t byte = instruction->source;
+    /* A byte move clears the low byte before reading the source, as execute_mov does */
+    word_t source_byte = (instruction->source == instruction->destination) ? 0x0000 : EIGHT_BITS;
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        word_t d = destination[lane];
+        word_t value;
+        switch(type)
+        {
+        case MOV:
+            value = INSTRUCTION_WB(instruction) ? (word_t)((d & 0xFF00) | (source[lane] & source_byte)) : source[lane];
+            break;
+        case SWAP:
+            value = source[lane];
+            source[lane] = LANE_SELECT(mask[lane], d, source[lane]);
+            break;
+        case MOVL:
+            value = (word_t)((d & 0xFF00) | byte);
+            break;
+        case MOVLZ:
+            value = byte;
+            break;
+        case MOVLS:
+            value = (word_t)(0xFF00 | byte);
+            break;
+        default:
+            value = (word_t)((d & 0x00FF) | (byte << 8));
+            break;
+        }
+        destination[lane] = LANE_SELECT(mask[lane], value, d);
+    }
+    /* MOV and SWAP into PC discard the fetched instruction - other writes to PC do not */
+    if((type == MOV || type == SWAP) && instruction->destination == PC)
+    {
+        for(int lane = 0; lane < batch->lane_count; lane++)
+        {
+            batch->flush[lane] = mask[lane] ? FLUSH_FETCH : batch->flush[lane];
+        }
+    }
+}
+
+/**
+ * @brief Branches and BL over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_branch(batch_t *batch, const instruction_t *instruction)
+{
+    word_t *pc = batch->registers[PC];
+    word_t *mask = batch->mask;
+    signed short offset;
+    int type = instruction->type;
+    if(type == BL)
+    {
+        /* BL +0 is the pipeline NOOP */
+        if(instruction->argument == 0x0000)
+        {
+            return;
+        }
+        offset = restore_offset(instruction->argument, LINK_OFFSET_LENGTH);
+        word_t *link = batch->registers[LR];
+        for(int lane = 0; lane < batch->lane_count; lane++)
+        {
+            link[lane] = LANE_SELECT(mask[lane], (word_t)(pc[lane] - WORD_LENGTH), link[lane]);
+        }
+    }
+    else
+    {
+        offset = restore_offset(BRANCH_OFFSET(instruction), BRANCH_OFFSET_LENGTH);
+    }
+    /* Offset 0 continues in sequence */
+    if(offset == 0x0000)
+    {
+        return;
+    }
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        int taken = (type == BL || type == BRA) ? 1 : check_condition(branch_conditions[type - BEQ], batch->psw[lane]);
+        word_t enabled = taken ? mask[lane] : LANE_OFF;
+        pc[lane] = LANE_SELECT(enabled, (word_t)(pc[lane] - WORD_LENGTH + offset), pc[lane]);
+        batch->flush[lane] = enabled ? FLUSH_FETCH : batch->flush[lane];
+    }
+}
+
+/**
+ * @brief CEX over all lanes - each lane queues its own predicate
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_cex(batch_t *batch, const instruction_t *instruction)
+{
+    unsigned int true_mask = (1u << CEX_TRUE_COUNT(instruction)) - 1;
+    unsigned int false_mask = ((1u << CEX_FALSE_COUNT(instruction)) - 1) << CEX_TRUE_COUNT(instruction);
+    int length = CEX_TRUE_COUNT(instruction) + CEX_FALSE_COUNT(instruction);
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        if(batch->mask[lane])
+        {
+            unsigned int skip_mask = check_condition((condition_code_t)CEX_CONDITION(instruction), batch->psw[lane])
+                ? false_mask : true_mask;
+            batch->skip_mask[lane] |= skip_mask << batch->skip_count[lane];
+            batch->skip_count[lane] = (byte_t)(batch->skip_count[lane] + length);
+        }
+    }
+}
+
+/**
+ * @brief SETPRI, SETCC, CLRCC and SVC over all lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_system(batch_t *batch, const instruction_t *instruction)
+{
+    int type = instruction->type;
+    word_t *psw = batch->psw;
+    word_t *mask = batch->mask;
+    word_t conditions = instruction->argument & PSW_CONDITION_MASK;
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        word_t status = psw[lane];
+        if(type == SETPRI)
+        {
+            SET_PSW_PRIORITY(status, PSW_CURRENT_PRIORITY_BIT, SETPRI_PRIORITY(instruction));
+        }
+        else if(type == SETCC)
+        {
+            status |= conditions;
+        }
+        else if(type == CLRCC)
+        {
+            status &= (word_t)~conditions;
+        }
+        psw[lane] = LANE_SELECT(mask[lane], status, psw[lane]);
+    }
+    /* Exceptions need the vector table and handlers of the pipelined core */
+    if(type == SVC)
+    {
+        for(int lane = 0; lane < batch->lane_count; lane++)
+        {
+            batch->state[lane] = mask[lane] ? LANE_UNSUPPORTED : batch->state[lane];
+        }
+    }
+}
+
+/**
+ * @brief LD, ST, LDR and STR over all lanes
+ *
+ * Addresses differ between lanes, so each enabled lane accesses its own
+ * data memory in turn.
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void lanes_memory(batch_t *batch, const instruction_t *instruction)
+{
+    int type = instruction->type;
+    int load = (type == LD || type == LDR);
+    /* Address register - source of loads, destination of stores */
+    word_t *address_register = batch->registers[load ? instruction->source : instruction->destination];
+    word_t *destination = batch->registers[instruction->destination];
+    word_t *source = batch->registers[instruction->source];
+    word_t increment_size = (word_t)(2 - INSTRUCTION_WB(instruction));
+    signed short offset = (signed short)((signed char)(instruction->argument << 1) >> 1);
+    int relative = (type == LDR || type == STR);
+    int pre = (INSTRUCTION_PRPO(instruction) == PRE);
+    /* Post increment of a store subtracts, as execute_st does */
+    word_t post_step = (word_t)((INSTRUCTION_INCREMENT(instruction) && load) ? increment_size : -increment_size);
+    word_t step = INSTRUCTION_INCREMENT(instruction) ? increment_size : (word_t)-increment_size;
+    int stepped = !relative && (INSTRUCTION_INCREMENT(instruction) || INSTRUCTION_DECREMENT(instruction));
+
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        if(!batch->mask[lane])
+        {
+            continue;
+        }
+        if(stepped && pre)
+        {
+            address_register[lane] = (word_t)(address_register[lane] + step);
+        }
+        word_t address = (word_t)(address_register[lane] + (relative ? offset : 0));
+        word_t value = source[lane];
+        if(stepped && !pre)
+        {
+            address_register[lane] = (word_t)(address_register[lane] + post_step);
+        }
+        if(batch->page_attributes[address >> PAGE_SHIFT] != PAGE_RAM)
+        {
+            /* Device registers belong to the pipelined core */
+            batch->state[lane] = LANE_UNSUPPORTED;
+            continue;
+        }
+        byte_t *data_memory = &batch->data_memory[(size_t)lane * LANE_MEMORY_LENGTH];
+        if(load)
+        {
+            /* Byte loads clear the high byte */
+            destination[lane] = INSTRUCTION_WB(instruction) ? data_memory[address] : read_memory_word(data_memory, address);
+        }
+        else if(INSTRUCTION_WB(instruction))
+        {
+            data_memory[address] = (byte_t)value;
+        }
+        else
+        {
+            write_memory_word(data_memory, address, value);
+        }
+    }
+    /* Fetch continues past the next instruction, which decode discards */
+    if(load && instruction->destination == PC)
+    {
+        for(int lane = 0; lane < batch->lane_count; lane++)
+        {
+            batch->flush[lane] = (batch->mask[lane] && batch->state[lane] == LANE_RUNNING) ? FLUSH_LOAD : batch->flush[lane];
+        }
+    }
+}
+
+/**
+ * @brief Execute an instruction in the enabled lanes
+ *
+ * @param batch Batch
+ * @param instruction Instruction
+ */
+static void execute_lanes(batch_t *batch, const instruction_t *instruction)
+{
+    switch(instruction->type)
+    {
+    case BL: case BEQ: case BNE: case BC: case BNC: case BN: case BGE: case BLT: case BRA:
+        lanes_branch(batch, instruction);
+        break;
+    case ADD: case ADDC: case SUB: case SUBC: case CMP:
+        lanes_arithmetic(batch, instruction);
+        break;
+    case DADD:
+        lanes_dadd(batch, instruction);
+        break;
+    case XOR: case AND: case OR:
+        lanes_logic(batch, instruction);
+        break;
+    case BIT: case BIC: case BIS:
+        lanes_bit(batch, instruction);
+        break;
+    case MOV: case SWAP: case MOVL: case MOVLZ: case MOVLS: case MOVH:
+        lanes_move(batch, instruction);
+        break;
+    case SRA: case RRC: case SWPB: case SXT:
+        lanes_shift(batch, instruction);
+        break;
+    case SETPRI: case SVC: case SETCC: case CLRCC:
+        lanes_system(batch, instruction);
+        break;
+    case CEX:
+        lanes_cex(batch, instruction);
+        break;
+    case LD: case ST: case LDR: case STR:
+        lanes_memory(batch, instruction);
+        break;
+    default:
+        /* Undefined instructions have no effect */
+        break;
+    }
+}
+
+/**
+ * @brief Stop a lane at a breakpoint, compared as the pipeline does after each execute
+ *
+ * @param batch Batch
+ * @param lane Lane
+ * @param program_counter PC at the end of the execute
+ * @return int [1 = Stopped, 0 = Running]
+ */
+static int lane_breakpoint(batch_t *batch, int lane, word_t program_counter)
+{
+    if((word_t)(program_counter - 2 * WORD_LENGTH) != batch->breakpoint)
+    {
+        return 0;
+    }
+    /* PC left where run() leaves it */
+    batch->registers[PC][lane] = (word_t)(program_counter - 2 * WORD_LENGTH);
+    batch->state[lane] = LANE_BREAKPOINT;
+    return 1;
+}
+
+/**
+ * @brief Move a lane to its next instruction
+ *
+ * A redirected lane passes through the bubble that replaced the discarded
+ * instruction, which also clears any CEX predicate.
+ *
+ * @param batch Batch
+ * @param lane Lane
+ */
+static void advance_lane(batch_t *batch, int lane)
+{
+    word_t *pc = batch->registers[PC];
+    if(batch->state[lane] == LANE_UNSUPPORTED)
+    {
+        /* Resumes at the instruction that stopped it */
+        pc[lane] = batch->next[lane];
+        return;
+    }
+    batch->instructions[lane] += (batch->mask[lane] != LANE_OFF);
+    switch(batch->flush[lane])
+    {
+    case FLUSH_FETCH:
+        if(lane_breakpoint(batch, lane, pc[lane]))
+        {
+            return;
+        }
+        batch->next[lane] = pc[lane];
+        pc[lane] = (word_t)(pc[lane] + WORD_LENGTH);
+        batch->skip_mask[lane] = 0;
+        batch->skip_count[lane] = 0;
+        if(lane_breakpoint(batch, lane, pc[lane]))
+        {
+            return;
+        }
+        break;
+    case FLUSH_LOAD:
+        /* PC holds the loaded address - the instruction after the discarded one runs first */
+        if(lane_breakpoint(batch, lane, (word_t)(batch->fetched[lane] + WORD_LENGTH)) || lane_breakpoint(batch, lane, pc[lane]))
+        {
+            return;
+        }
+        batch->next[lane] = (word_t)(batch->fetched[lane] + WORD_LENGTH);
+        batch->skip_mask[lane] = 0;
+        batch->skip_count[lane] = 0;
+        break;
+    default:
+        if(lane_breakpoint(batch, lane, pc[lane]))
+        {
+            return;
+        }
+        batch->next[lane] = batch->fetched[lane];
+        break;
+    }
+    if(batch->instructions[lane] >= batch->instruction_limit)
+    {
+        batch->state[lane] = LANE_LIMIT;
+        pc[lane] = batch->next[lane];
+    }
+}
+
+/**
+ * @brief Execute the instruction at the lowest next address of the running lanes
+ *
+ * @param batch Batch
+ * @return int [1 = Executed, 0 = Every lane stopped]
+ */
+static int step_lanes(batch_t *batch)
+{
+    int lane_count = batch->lane_count;
+    int address = -1;
+    for(int lane = 0; lane < lane_count; lane++)
+    {
+        if(batch->state[lane] == LANE_RUNNING && (address < 0 || batch->next[lane] < address))
+        {
+            address = batch->next[lane];
+        }
+    }
+    if(address < 0)
+    {
+        return 0;
+    }
+
+    /* Fetched and decoded once for every lane */
+    word_t opcode = read_memory_word(batch->instruction_memory, (word_t)address);
+    const decoded_opcode_t *decoded = &decode_table[opcode];
+    instruction_t instruction;
+    instruction.type = decoded->type;
+    instruction.source = decoded->source;
+    instruction.destination = decoded->destination;
+    instruction.flags = decoded->flags;
+    instruction.argument = decoded->argument;
+    instruction.address = (word_t)address;
+
+    word_t *pc = batch->registers[PC];
+    int enabled = 0;
+    for(int lane = 0; lane < lane_count; lane++)
+    {
+        word_t selected = (batch->state[lane] == LANE_RUNNING && batch->next[lane] == address) ? LANE_ON : LANE_OFF;
+        batch->selected[lane] = selected;
+        batch->fetched[lane] = pc[lane];
+        pc[lane] = (word_t)(pc[lane] + (selected & WORD_LENGTH));
+        batch->flush[lane] = FLUSH_NONE;
+        /* Decode drops the instruction where the lane's CEX predicate says so */
+        word_t dropped = LANE_OFF;
+        if(selected && batch->skip_count[lane] > 0)
+        {
+            dropped = (batch->skip_mask[lane] & ONE_BIT) ? LANE_ON : LANE_OFF;
+            batch->skip_mask[lane] >>= 1;
+            batch->skip_count[lane]--;
+        }
+        batch->mask[lane] = selected & ~dropped;
+        enabled += (batch->mask[lane] != LANE_OFF);
+    }
+
+    execute_lanes(batch, &instruction);
+
+    for(int lane = 0; lane < lane_count; lane++)
+    {
+        if(batch->selected[lane])
+        {
+            advance_lane(batch, lane);
+        }
+    }
+    batch->steps++;
+    batch->lane_slots += enabled;
+    return 1;
+}
+
+/**
+ * @brief Create a batch of lanes starting from a loaded program
+ *
+ * Every lane starts with the program's data memory, registers cleared and
+ * the PSW of the program.
+ *
+ * @param batch Batch
+ * @param program Loaded program - must outlive the batch
+ * @param lane_count Number of lanes [1 - MAX_LANES]
+ * @param instruction_limit Instructions run by each lane
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int create_batch(batch_t *batch, program_t *program, int lane_count, int instruction_limit)
+{
+    memset(batch, 0, sizeof(batch_t));
+    if(program == NULL || lane_count < 1 || lane_count > MAX_LANES || instruction_limit <= 0)
+    {
+        return -1;
+    }
+    batch->lane_count = lane_count;
+    batch->instruction_limit = instruction_limit;
+    batch->breakpoint = (word_t)program->breakpoint & 0xFFFE;
+    batch->instruction_memory = program->instruction_memory;
+    batch->constants = program->register_file[CONSTANT];
+    batch->page_attributes = program->page_attributes;
+
+    size_t words = (size_t)lane_count * sizeof(word_t);
+    int allocated = 1;
+    for(int index = 0; index < REGISTER_FILE_LENGTH; index++)
+    {
+        batch->registers[index] = calloc(1, words);
+        allocated &= (batch->registers[index] != NULL);
+    }
+    batch->psw = malloc(words);
+    batch->next = malloc(words);
+    batch->selected = calloc(1, words);
+    batch->mask = calloc(1, words);
+    batch->fetched = calloc(1, words);
+    batch->skip_mask = calloc((size_t)lane_count, sizeof(unsigned int));
+    batch->skip_count = calloc((size_t)lane_count, sizeof(byte_t));
+    batch->flush = calloc((size_t)lane_count, sizeof(byte_t));
+    batch->state = calloc((size_t)lane_count, sizeof(byte_t));
+    batch->instructions = calloc((size_t)lane_count, sizeof(int));
+    batch->data_memory = malloc((size_t)lane_count * LANE_MEMORY_LENGTH);
+    if(!allocated || batch->psw == NULL || batch->next == NULL || batch->selected == NULL || batch->mask == NULL
+        || batch->fetched == NULL || batch->skip_mask == NULL || batch->skip_count == NULL || batch->flush == NULL
+        || batch->state == NULL || batch->instructions == NULL || batch->data_memory == NULL)
+    {
+        release_batch(batch);
+        return -2;
+    }
+
+    for(int lane = 0; lane < lane_count; lane++)
+    {
+        /* The starting instruction is fetched - PC holds the address after it */
+        batch->next[lane] = (word_t)program->starting_address;
+        batch->registers[PC][lane] = (word_t)(program->starting_address + WORD_LENGTH);
+        batch->psw[lane] = program->program_status_word;
+        memcpy(&batch->data_memory[(size_t)lane * LANE_MEMORY_LENGTH], program->data_memory, LANE_MEMORY_LENGTH);
+    }
+    return 0;
+}
+
+/**
+ * @brief Set the initial registers and data of lanes from a sweep file
+ *
+ * Line n sets up lane n with space separated assignments - r0 to r6, sp,
+ * lr, bp and psw take a hex value, a hex address takes a hex data word:
+ *
+ *     r0=0010 r1=fffe 1000=1234
+ *
+ * Lines starting with ; are comments. Lanes past the last line keep the
+ * loaded program's state.
+ *
+ * @param batch Batch
+ * @param path Sweep file path
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int load_sweep(batch_t *batch, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if(file == NULL)
+    {
+        printf("Unable to open %s\n", path);
+        return -1;
+    }
+    char line[SWEEP_LINE_LENGTH];
+    int lane = 0;
+    int line_number = 0;
+    int error_status = 0;
+    while(lane < batch->lane_count && fgets(line, SWEEP_LINE_LENGTH, file) != NULL)
+    {
+        line_number++;
+        if(line[0] == ';')
+        {
+            continue;
+        }
+        for(char *token = strtok(line, " \t\r\n"); token != NULL; token = strtok(NULL, " \t\r\n"))
+        {
+            char *separator = strchr(token, '=');
+            char *end = NULL;
+            unsigned long value = (separator != NULL) ? strtoul(separator + 1, &end, 16) : 0;
+            if(separator == NULL || end == separator + 1 || *end != NUL || value > 0xFFFF)
+            {
+                printf("Invalid Sweep Assignment on Line %d: %s\n", line_number, token);
+                error_status = -2;
+                continue;
+            }
+            *separator = NUL;
+            for(char *character = token; *character != NUL; character++)
+            {
+                *character = (char)tolower((unsigned char)*character);
+            }
+            int index = -1;
+            for(int name = 0; name < PC; name++)
+            {
+                if(strcmp(token, sweep_register_names[name]) == 0)
+                {
+                    index = name;
+                }
+            }
+            index = (strcmp(token, "bp") == 0) ? BP : (strcmp(token, "lr") == 0) ? LR : (strcmp(token, "sp") == 0) ? SP : index;
+            if(index >= 0)
+            {
+                batch->registers[index][lane] = (word_t)value;
+            }
+            else if(strcmp(token, "psw") == 0)
+            {
+                batch->psw[lane] = (word_t)value;
+            }
+            else
+            {
+                unsigned long address = strtoul(token, &end, 16);
+                if(end == token || *end != NUL || address > 0xFFFF)
+                {
+                    printf("Invalid Sweep Assignment on Line %d: %s\n", line_number, token);
+                    error_status = -2;
+                    continue;
+                }
+                write_memory_word(&batch->data_memory[(size_t)lane * LANE_MEMORY_LENGTH], (word_t)address, (word_t)value);
+            }
+        }
+        lane++;
+    }
+    fclose(file);
+    return error_status;
+}
+
+/**
+ * @brief Run every lane to a breakpoint, its instruction limit or an unsupported instruction
+ *
+ * @param batch Batch
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int run_batch(batch_t *batch)
+{
+    if(batch == NULL || batch->lane_count == 0)
+    {
+        return -1;
+    }
+    double run_start = host_seconds();
+    while(step_lanes(batch))
+    {
+    }
+    batch->seconds = host_seconds() - run_start;
+    return 0;
+}
+
+/**
+ * @brief Print the final registers and state of each lane and the batch totals
+ *
+ * @param batch Batch
+ * @param file Output file
+ */
+void print_batch(batch_t *batch, FILE *file)
+{
+    long long instructions = 0;
+    for(int lane = 0; lane < batch->lane_count; lane++)
+    {
+        fprintf(file, "Lane %d:", lane);
+        for(int index = 0; index < REGISTER_FILE_LENGTH; index++)
+        {
+            fprintf(file, " R%d %04x", index, batch->registers[index][lane]);
+        }
+        fprintf(file, " PSW %04x, %d Instructions, %s\n", batch->psw[lane], batch->instructions[lane],
+            lane_state_names[batch->state[lane]]);
+        instructions += batch->instructions[lane];
+    }
+    /* Share of lane slots doing work - lower as lanes diverge */
+    double utilization = (batch->steps > 0) ? 100.0 * (double)batch->lane_slots / ((double)batch->steps * batch->lane_count) : 0.0;
+    fprintf(file, "%d Lanes, %lld Steps, %lld Instructions in %.3f Seconds, %.1f%% Lane Utilization\n",
+        batch->lane_count, batch->steps, instructions, batch->seconds, utilization);
+}
+
+/**
+ * @brief Free the lanes of a batch
+ *
+ * @param batch Batch
+ */
+void release_batch(batch_t *batch)
+{
+    for(int index = 0; index < REGISTER_FILE_LENGTH; index++)
+    {
+        free(batch->registers[index]);
+        batch->registers[index] = NULL;
+    }
+    free(batch->psw);
+    free(batch->next);
+    free(batch->selected);
+    free(batch->mask);
+    free(batch->fetched);
+    free(batch->skip_mask);
+    free(batch->skip_count);
+    free(batch->flush);
+    free(batch->state);
+    free(batch->instructions);
+    free(batch->data_memory);
+    memset(batch, 0, sizeof(batch_t));
+}
@@ -0,0 +1,245 @@
+/**
+ * @file branch_predictor.c
+ * @brief Branch prediction model
+ *
+ * The emulated pipeline always fetches the next sequential instruction, so
+ * every taken branch costs one bubble. The model observes each executed
+ * branch, predicts it with the selected scheme and charges a bubble only
+ * when the prediction is wrong. A correct taken prediction is assumed to
+ * redirect fetch without a bubble. The emulated pipeline is unchanged -
+ * the model reports the clock cycles a predicting core would have needed.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-26
+ */
+
+#include "branch_predictor.h"
+
+/* Names accepted on selection and printed in the report */
+static const char *predictor_names[NUM_OF_PREDICTORS] =
+{
+    "none", "nottaken", "btfn", "bimodal", "gshare", "btb"
+};
+
+/**
+ * @brief Select a prediction scheme, allocating the model on first use
+ *
+ * @param program Program context
+ * @param name Scheme name - none disables the model
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_branch_predictor(program_t *program, char *name)
+{
+    int type = 0;
+    while(type < NUM_OF_PREDICTORS && strcmp(name, predictor_names[type]) != 0)
+    {
+        type++;
+    }
+    if(type == NUM_OF_PREDICTORS)
+    {
+        return -1;
+    }
+    if(type == PREDICTOR_NONE)
+    {
+        release_branch_predictor(program);
+        return 0;
+    }
+    if(program->settings.predictor == NULL)
+    {
+        program->settings.predictor = malloc(sizeof(branch_predictor_t));
+        if(program->settings.predictor == NULL)
+        {
+            return -2;
+        }
+    }
+    program->settings.predictor->type = (predictor_type_t)type;
+    reset_branch_predictor(program);
+    return 0;
+}
+
+/**
+ * @brief Move a two bit counter towards the outcome
+ *
+ * @param counter Counter to update
+ * @param taken Branch outcome
+ */
+static void train_counter(byte_t *counter, int taken)
+{
+    if(taken && *counter < COUNTER_MAX)
+    {
+        (*counter)++;
+    }
+    else if(!taken && *counter > 0)
+    {
+        (*counter)--;
+    }
+}
+
+/**
+ * @brief Predict a branch, then train the scheme with its outcome
+ *
+ * @param program Program context
+ * @param address Address of the branch instruction
+ * @param target Branch destination if taken
+ * @param conditional Branch depends on a condition - BRA and BL are always taken
+ * @param taken Branch outcome
+ */
+void predict_branch(program_t *program, word_t address, word_t target, int conditional, int taken)
+{
+    branch_predictor_t *predictor = program->settings.predictor;
+    if(predictor == NULL)
+    {
+        return;
+    }
+
+    int prediction = 0;
+    byte_t *counter = NULL;
+    btb_entry_t *entry = &predictor->btb[(address >> 1) % BTB_LENGTH];
+    switch(predictor->type)
+    {
+    case PREDICTOR_BTFN:
+        /* Direction decides conditional branches only */
+        prediction = !conditional || (target <= address);
+        break;
+    case PREDICTOR_BIMODAL:
+        counter = &predictor->counters[(address >> 1) % PREDICTOR_TABLE_LENGTH];
+        break;
+    case PREDICTOR_GSHARE:
+        counter = &predictor->counters[((address >> 1) ^ predictor->history) % PREDICTOR_TABLE_LENGTH];
+        break;
+    case PREDICTOR_BTB:
+        /* A miss falls through to the next instruction */
+        prediction = entry->valid && entry->address == address
+            && entry->counter >= COUNTER_WEAKLY_TAKEN && entry->target == target;
+        break;
+    default:
+        break;
+    }
+    if(counter != NULL)
+    {
+        prediction = (*counter >= COUNTER_WEAKLY_TAKEN);
+        train_counter(counter, taken);
+    }
+    if(predictor->type == PREDICTOR_BTB)
+    {
+        if(entry->valid && entry->address == address)
+        {
+            train_counter(&entry->counter, taken);
+            entry->target = taken ? target : entry->target;
+        }
+        else if(taken)
+        {
+            /* Allocate on the first taken execution */
+            entry->valid = 1;
+            entry->address = address;
+            entry->target = target;
+            entry->counter = COUNTER_WEAKLY_TAKEN;
+        }
+    }
+    predictor->history = ((predictor->history << 1) | (taken != 0)) & PREDICTOR_HISTORY_MASK;
+
+    branch_site_t *site = &predictor->sites[address >> 1];
+    site->executed++;
+    predictor->branches++;
+    if(taken)
+    {
+        site->taken++;
+        predictor->baseline_penalty += CYCLES_PER_INSTRUCTION;
+    }
+    if(prediction != (taken != 0))
+    {
+        site->mispredicted++;
+        predictor->mispredicted++;
+        predictor->predicted_penalty += CYCLES_PER_INSTRUCTION;
+    }
+}
+
+/**
+ * @brief Clear predictor tables and results, keeping the selected scheme
+ *
+ * @param program Program context
+ */
+void reset_branch_predictor(program_t *program)
+{
+    branch_predictor_t *predictor = program->settings.predictor;
+    if(predictor == NULL)
+    {
+        return;
+    }
+    predictor_type_t type = predictor->type;
+    memset(predictor, 0, sizeof(branch_predictor_t));
+    predictor->type = type;
+    /* Counters start weakly not taken */
+    memset(predictor->counters, COUNTER_WEAKLY_TAKEN - 1, sizeof(predictor->counters));
+}
+
+/**
+ * @brief Free the predictor, disabling the model
+ *
+ * @param program Program context
+ */
+void release_branch_predictor(program_t *program)
+{
+    free(program->settings.predictor);
+    program->settings.predictor = NULL;
+}
+
+/**
+ * @brief Print prediction accuracy, adjusted clock cycles and the least predictable sites
+ *
+ * @param program Program context
+ */
+void display_branch_predictor(program_t *program)
+{
+    branch_predictor_t *predictor = program->settings.predictor;
+    if(predictor == NULL)
+    {
+        return;
+    }
+
+    printf("Branch Predictor: %s\n", predictor_names[predictor->type]);
+    printf("Branches: %u\n", predictor->branches);
+    printf("Mispredicted: %u\n", predictor->mispredicted);
+    if(predictor->branches > 0)
+    {
+        printf("Accuracy: %.2f%%\n", 100.0 * (predictor->branches - predictor->mispredicted) / predictor->branches);
+    }
+    else
+    {
+        printf("Accuracy: -\n");
+    }
+    long adjusted_cycles = (long)program->clock_cycles - predictor->baseline_penalty + predictor->predicted_penalty;
+    printf("Branch Cycles: %u Emulated, %u Predicted\n", predictor->baseline_penalty, predictor->predicted_penalty);
+    printf("Adjusted Clock Cycles: %ld (%+ld)\n", adjusted_cycles, adjusted_cycles - program->clock_cycles);
+
+    /* Select the sites with the most mispredictions, highest first */
+    int top_index[BRANCH_REPORT_LENGTH];
+    int top_count = 0;
+    for(int index = 0; index < BRANCH_SITE_LENGTH; index++)
+    {
+        branch_site_t *site = &predictor->sites[index];
+        if(site->executed == 0 || (top_count == BRANCH_REPORT_LENGTH
+            && site->mispredicted <= predictor->sites[top_index[top_count - 1]].mispredicted))
+        {
+            continue;
+        }
+        /* Insertion into the sorted list */
+        int position = (top_count < BRANCH_REPORT_LENGTH) ? top_count++ : top_count - 1;
+        while(position > 0 && predictor->sites[top_index[position - 1]].mispredicted < site->mispredicted)
+        {
+            top_index[position] = top_index[position - 1];
+            position--;
+        }
+        top_index[position] = index;
+    }
+    if(top_count > 0)
+    {
+        printf("Branch Sites:      Executed    Taken  Mispredicted  Accuracy\n");
+    }
+    for(int i = 0; i < top_count; i++)
+    {
+        branch_site_t *site = &predictor->sites[top_index[i]];
+        printf("  #%04x: %13u %8u %13u %8.2f%%\n", top_index[i] << 1, site->executed, site->taken,
+            site->mispredicted, 100.0 * (site->executed - site->mispredicted) / site->executed);
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file cache.c
+ * @brief Instruction and data cache model
+ *
+ * Instruction fetches (F1) and data memory accesses (E1) are looked up in
+ * optional set associative caches. Memory contents are always read from
+ * the memory arrays - the model only tracks tags, and each miss adds the
+ * configured penalty to the clock cycles. Device registers bypass the data
+ * cache. A disabled cache is a NULL pointer and costs one test per access.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-28
+ */
+
+#include "cache.h"
+
+/* Names accepted on configuration and printed in the report */
+static const char *cache_policy_names[NUM_OF_CACHE_POLICIES] =
+{
+    "lru", "fifo", "random"
+};
+
+#define RANDOM_SEED 0x2545F491u
+
+/**
+ * @brief Check a value is a power of two
+ *
+ * @param value Value to check
+ * @return int [1 = Power of two, 0 = Otherwise]
+ */
+static int is_power_of_two(int value)
+{
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+/**
+ * @brief Look up a replacement policy by name
+ *
+ * @param name Policy name
+ * @return int [>= 0 = Policy, < 0 = FAILURE]
+ */
+int parse_cache_policy(char *name)
+{
+    for(int policy = 0; policy < NUM_OF_CACHE_POLICIES; policy++)
+    {
+        if(strcmp(name, cache_policy_names[policy]) == 0)
+        {
+            return policy;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Configure, replace or disable a cache
+ *
+ * @param program Program context
+ * @param select Instruction or data cache
+ * @param config Geometry and timing - NULL disables the cache
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_cache(program_t *program, cache_select_t select, cache_config_t *config)
+{
+    cache_t **cache = (select == INSTRUCTION_CACHE) ? &program->settings.instruction_cache : &program->settings.data_cache;
+    if(config == NULL)
+    {
+        free(*cache);
+        *cache = NULL;
+        return 0;
+    }
+    if(!is_power_of_two(config->size) || !is_power_of_two(config->line_size) || !is_power_of_two(config->associativity)
+        || config->size > CACHE_MAX_SIZE || config->line_size < WORD_LENGTH
+        || config->line_size * config->associativity > config->size
+        || config->policy < 0 || config->policy >= NUM_OF_CACHE_POLICIES || config->miss_penalty < 0)
+    {
+        return -1;
+    }
+
+    int line_count = config->size / config->line_size;
+    cache_t *new_cache = malloc(sizeof(cache_t) + line_count * sizeof(cache_line_t));
+    if(new_cache == NULL)
+    {
+        return -2;
+    }
+    new_cache->config = *config;
+    new_cache->line_shift = 0;
+    while((1 << new_cache->line_shift) < config->line_size)
+    {
+        new_cache->line_shift++;
+    }
+    new_cache->set_mask = line_count / config->associativity - 1;
+    free(*cache);
+    *cache = new_cache;
+    reset_caches(program);
+    return 0;
+}
+
+/**
+ * @brief Look up an address, allocating its line on a miss
+ *
+ * @param cache Cache model
+ * @param address Byte address accessed
+ * @return int Clock cycles added by the access
+ */
+int cache_access(cache_t *cache, word_t address)
+{
+    word_t tag = address >> cache->line_shift;
+    cache_line_t *set = &cache->lines[(tag & cache->set_mask) * cache->config.associativity];
+    int region = address >> CACHE_REGION_SHIFT;
+    cache->accesses++;
+
+    cache_line_t *victim = &set[0];
+    for(int way = 0; way < cache->config.associativity; way++)
+    {
+        cache_line_t *line = &set[way];
+        if(line->valid && line->tag == tag)
+        {
+            cache->hits[region]++;
+            if(cache->config.policy == CACHE_LRU)
+            {
+                line->stamp = cache->accesses;
+            }
+            return 0;
+        }
+        /* Prefer an empty line, then the oldest stamp */
+        if(victim->valid && (!line->valid || line->stamp < victim->stamp))
+        {
+            victim = line;
+        }
+    }
+
+    cache->misses[region]++;
+    if(cache->config.policy == CACHE_RANDOM && victim->valid)
+    {
+        /* Xorshift - repeatable between runs */
+        cache->random_state ^= cache->random_state << 13;
+        cache->random_state ^= cache->random_state >> 17;
+        cache->random_state ^= cache->random_state << 5;
+        victim = &set[cache->random_state & (cache->config.associativity - 1)];
+    }
+    victim->valid = 1;
+    victim->tag = tag;
+    victim->stamp = cache->accesses;
+    return cache->config.miss_penalty;
+}
+
+/**
+ * @brief Invalidate a cache and clear its counters
+ *
+ * @param cache Cache model - may be NULL
+ */
+static void reset_cache(cache_t *cache)
+{
+    if(cache == NULL)
+    {
+        return;
+    }
+    cache->accesses = 0;
+    cache->random_state = RANDOM_SEED;
+    memset(cache->hits, 0, sizeof(cache->hits));
+    memset(cache->misses, 0, sizeof(cache->misses));
+    memset(cache->lines, 0, (cache->config.size / cache->config.line_size) * sizeof(cache_line_t));
+}
+
+/**
+ * @brief Invalidate both caches and clear their counters
+ *
+ * @param program Program context
+ */
+void reset_caches(program_t *program)
+{
+    reset_cache(program->settings.instruction_cache);
+    reset_cache(program->settings.data_cache);
+}
+
+/**
+ * @brief Free both caches, disabling the model
+ *
+ * @param program Program context
+ */
+void release_caches(program_t *program)
+{
+    set_cache(program, INSTRUCTION_CACHE, NULL);
+    set_cache(program, DATA_CACHE, NULL);
+}
+
+/**
+ * @brief Print one cache's configuration and hits and misses for each region accessed
+ *
+ * @param cache Cache model - may be NULL
+ * @param name Cache name
+ */
+static void display_cache(cache_t *cache, char *name)
+{
+    if(cache == NULL)
+    {
+        return;
+    }
+    cache_config_t *config = &cache->config;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    for(int region = 0; region < CACHE_REGION_COUNT; region++)
+    {
+        hits += cache->hits[region];
+        misses += cache->misses[region];
+    }
+
+    printf("%s Cache: %d Bytes, %d Way, %d Byte Lines, %s, %d Cycle Miss Penalty\n", name, config->size,
+        config->associativity, config->line_size, cache_policy_names[config->policy], config->miss_penalty);
+    printf("Hits: %u Misses: %u", hits, misses);
+    if(hits + misses > 0)
+    {
+        printf(" Hit Rate: %.2f%%", 100.0 * hits / (hits + misses));
+    }
+    printf(" Penalty Cycles: %u\n", misses * config->miss_penalty);
+    for(int region = 0; region < CACHE_REGION_COUNT; region++)
+    {
+        unsigned int accesses = cache->hits[region] + cache->misses[region];
+        if(accesses > 0)
+        {
+            printf("  #%04x - #%04x: %10u Hits %10u Misses %8.2f%%\n", region << CACHE_REGION_SHIFT,
+                ((region + 1) << CACHE_REGION_SHIFT) - 1, cache->hits[region], cache->misses[region],
+                100.0 * cache->hits[region] / accesses);
+        }
+    }
+}
+
+/**
+ * @brief Print both caches' results
+ *
+ * @param program Program context
+ */
+void display_caches(program_t *program)
+{
+    display_cache(program->settings.instruction_cache, "Instruction");
+    display_cache(program->settings.data_cache, "Data");
+}
@@ -0,0 +1,219 @@
+/**
+ * @file console.c
+ * @brief Buffered console device
+ *
+ * Bytes written by the guest are collected in the console buffer and
+ * written to the output with a single call when a newline is written,
+ * when the buffer fills, or when the emulator exits. Cores of a multi-core
+ * system do not flush on newlines, so their output is written in core order
+ * at quantum boundaries. Received bytes are
+ * taken from the input file only when the guest polls the device, and are
+ * logged or replayed through the input log.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-15
+ */
+
+#include "console.h"
+
+/**
+ * @brief Append a byte to the console buffer
+ *
+ * @param program Program context
+ * @param character Byte written by the guest
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int console_write(program_t *program, byte_t character)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    program->console.buffer[program->console.length++] = (char)character;
+    /* Cores of a system flush in core order at each quantum boundary instead */
+    if((character == '\n' && program->settings.multicore == NULL) || program->console.length >= CONSOLE_BUFFER_LENGTH)
+    {
+        return flush_console(program);
+    }
+    return 0;
+}
+
+/**
+ * @brief Write pending console output
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int flush_console(program_t *program)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    int error_status = 0;
+    if(program->console.length > 0)
+    {
+        FILE *output = program->settings.console_output ? program->settings.console_output : stdout;
+        if(fwrite(program->console.buffer, 1, program->console.length, output) != (size_t)program->console.length)
+        {
+            error_status = -2;
+        }
+        fflush(output);
+        program->console.length = 0;
+    }
+    return error_status;
+}
+
+/**
+ * @brief Direct console output to a file
+ *
+ * @param program Program context
+ * @param path Output file path - NULL or "-" for stdout
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_console_output(program_t *program, char *path)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    close_console(program);
+    if(path != NULL && strcmp(path, "-") != 0)
+    {
+        if(fopen_s(&program->settings.console_output, path, "w") != 0)
+        {
+            program->settings.console_output = NULL;
+            return -2;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Flush pending output and close the console output file
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int close_console(program_t *program)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    int error_status = flush_console(program);
+    if(program->settings.console_output != NULL)
+    {
+        fclose(program->settings.console_output);
+        program->settings.console_output = NULL;
+    }
+    return error_status;
+}
+
+/**
+ * @brief Select the file the console device receives from
+ *
+ * @param program Program context
+ * @param path Input file path - "-" for stdin, NULL closes the input
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_console_input(program_t *program, char *path)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    if(program->settings.console_input != NULL && program->settings.console_input != stdin)
+    {
+        fclose(program->settings.console_input);
+    }
+    program->settings.console_input = NULL;
+    if(path == NULL)
+    {
+        return 0;
+    }
+    program->settings.console_input = stdin;
+    if(strcmp(path, "-") != 0 && fopen_s(&program->settings.console_input, path, "rb") != 0)
+    {
+        program->settings.console_input = NULL;
+        return -2;
+    }
+    /* Readiness is polled on the descriptor - no bytes may wait in a stdio buffer */
+    setvbuf(program->settings.console_input, NULL, _IONBF, 0);
+    return 0;
+}
+
+/**
+ * @brief Check the host input has a byte without blocking
+ *
+ * @param input Input file
+ * @return int [1 = Ready, 0 = Not Ready]
+ */
+static int host_input_ready(FILE *input)
+{
+#ifdef WINDOWS
+    /* No portable readiness test - bytes are read when requested */
+    (void) input;
+    return 1;
+#else
+    struct pollfd descriptor = {fileno(input), POLLIN, 0};
+    return poll(&descriptor, 1, 0) > 0;
+#endif
+}
+
+/**
+ * @brief Receive a byte if none is waiting - from the log when replaying, the host otherwise
+ *
+ * @param program Program context
+ * @return int [1 = Byte Waiting, 0 = None]
+ */
+int console_receive_ready(program_t *program)
+{
+    console_device_t *console = &program->console;
+    if(console->receive_pending)
+    {
+        return 1;
+    }
+    input_log_t *log = program->settings.input_log;
+    if(log != NULL && log->mode == REPLAY_PLAYBACK)
+    {
+        /* No host input while replaying */
+        console->receive_pending = replay_input(program, INPUT_CONSOLE, &console->receive_data);
+        return console->receive_pending;
+    }
+    FILE *input = program->settings.console_input;
+    if(input != NULL && host_input_ready(input))
+    {
+        int character = fgetc(input);
+        if(character == EOF)
+        {
+            /* End of input - stop polling */
+            if(input != stdin)
+            {
+                fclose(input);
+            }
+            program->settings.console_input = NULL;
+            return 0;
+        }
+        console->receive_data = (byte_t)character;
+        console->receive_pending = 1;
+        (void) record_input(program, INPUT_CONSOLE, console->receive_data);
+    }
+    return console->receive_pending;
+}
+
+/**
+ * @brief Read the received byte, clearing receive ready
+ *
+ * @param program Program context
+ * @return byte_t Byte received - 0 if none
+ */
+byte_t console_read(program_t *program)
+{
+    if(!console_receive_ready(program))
+    {
+        return 0x00;
+    }
+    program->console.receive_pending = 0;
+    return program->console.receive_data;
+}
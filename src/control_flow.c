@@ -0,0 +1,445 @@
+/**
+ * @file control_flow.c
+ * @brief Static control flow graph of the loaded program
+ *
+ * Built at load time by decoding the code reachable from the starting
+ * address and the vector handlers, following BL and branch offsets. The
+ * walk ends at PC writes, since their destination is only known at run
+ * time, so returns and jump tables close their block without a successor.
+ * Erased memory (0x0000, the BL +0 pipeline NOOP) is taken as the end of
+ * the code and is not decoded.
+ * Basic blocks are joined by fall through, taken and call edges, and the
+ * destinations of back edges found by a depth first search are reported as
+ * loop headers - the candidates for hot loops. The graph can be written as
+ * a DOT file for Graphviz.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-09
+ */
+
+#include "control_flow.h"
+
+#define VISIT_NEW 0             /* Depth first search colours */
+#define VISIT_OPEN 1            /* On the search stack */
+#define VISIT_DONE 2
+
+/* DOT edge attributes - indexed by flow_edge_t */
+static const char *edge_attributes[] =
+{
+    "", " [label=\"taken\"]", " [label=\"call\", style=dashed]"
+};
+
+/**
+ * @brief Check a decoded instruction writes the PC
+ *
+ * @param decoded Decoded opcode
+ * @return int [1 = Writes PC, 0 = Otherwise]
+ */
+static int writes_pc(const decoded_opcode_t *decoded)
+{
+    int auto_index = (decoded->flags & (OPERAND_INCREMENT | OPERAND_DECREMENT)) != 0;
+    switch(decoded->type)
+    {
+    case CMP:
+    case BIT:
+        return 0;
+    case SWAP:
+        return decoded->source == PC || decoded->destination == PC;
+    case LD:
+        /* Address register is the source */
+        return decoded->destination == PC || (auto_index && decoded->source == PC);
+    case ST:
+        /* Address register is the destination */
+        return auto_index && decoded->destination == PC;
+    default:
+        break;
+    }
+    return (decoded->type >= ADD && decoded->type <= SXT) || (decoded->type >= MOVL && decoded->type <= LDR)
+        ? decoded->destination == PC : 0;
+}
+
+/**
+ * @brief Find a branch destination, if the instruction branches
+ *
+ * @param decoded Decoded opcode
+ * @param address Instruction address
+ * @param target Destination
+ * @return int [EDGE_TAKEN, EDGE_CALL, EDGE_FALL_THROUGH = Not a branch]
+ */
+static int branch_target(const decoded_opcode_t *decoded, word_t address, word_t *target)
+{
+    /* Offset 0 continues in sequence */
+    if(decoded->type == BL && decoded->argument != 0)
+    {
+        *target = (word_t)(address + WORD_LENGTH + restore_offset(decoded->argument, LINK_OFFSET_LENGTH));
+        return EDGE_CALL;
+    }
+    if(decoded->type >= BEQ && decoded->type <= BRA && BRANCH_OFFSET(decoded) != 0)
+    {
+        *target = (word_t)(address + WORD_LENGTH + restore_offset(BRANCH_OFFSET(decoded), BRANCH_OFFSET_LENGTH));
+        return EDGE_TAKEN;
+    }
+    return EDGE_FALL_THROUGH;
+}
+
+/**
+ * @brief Mark a block start and queue it if not yet decoded
+ *
+ * @param flow Control flow graph
+ * @param worklist Slots waiting to be decoded
+ * @param length Number of queued slots
+ * @param address Block start
+ * @param flags Additional flags
+ */
+static void add_block_start(control_flow_t *flow, int *worklist, int *length, word_t address, byte_t flags)
+{
+    int slot = address >> 1;
+    flow->slots[slot] |= FLOW_BLOCK_START | flags;
+    if(!(flow->slots[slot] & FLOW_REACHABLE))
+    {
+        worklist[(*length)++] = slot;
+    }
+}
+
+/**
+ * @brief Find the block starting at an address
+ *
+ * @param flow Control flow graph
+ * @param address Block start
+ * @return int [>= 0 = Block index, < 0 = Not found]
+ */
+static int find_block(control_flow_t *flow, word_t address)
+{
+    int low = 0;
+    int high = flow->block_count - 1;
+    while(low <= high)
+    {
+        int middle = (low + high) / 2;
+        if(flow->blocks[middle].start == address)
+        {
+            return middle;
+        }
+        if(flow->blocks[middle].start < address)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Add an edge from a block
+ *
+ * @param flow Control flow graph
+ * @param block Source block
+ * @param edge Edge kind
+ * @param address Destination block start
+ */
+static void add_edge(control_flow_t *flow, flow_block_t *block, flow_edge_t edge, word_t address)
+{
+    int successor = find_block(flow, address);
+    if(successor >= 0)
+    {
+        block->edges[block->successor_count] = (byte_t)edge;
+        block->successors[block->successor_count++] = successor;
+        flow->edge_count++;
+    }
+}
+
+/**
+ * @brief Decode the code reachable from the entries, marking block boundaries
+ *
+ * @param program Program context
+ * @param worklist Slots waiting to be decoded - holds every branch target
+ * @return int Number of queued slots remaining - 0
+ */
+static int walk_code(program_t *program, int *worklist)
+{
+    control_flow_t *flow = program->settings.control_flow;
+    int length = 0;
+    add_block_start(flow, worklist, &length, (word_t)(program->starting_address & 0xFFFE), FLOW_ENTRY);
+    for(int vector = 0; vector < VECTOR_COUNT; vector++)
+    {
+        /* Unused vectors are left 0 */
+        word_t handler = read_memory_word(program->data_memory, VECTOR_TABLE_ADDRESS + vector * VECTOR_LENGTH + WORD_LENGTH);
+        if(handler != 0x0000)
+        {
+            add_block_start(flow, worklist, &length, handler & 0xFFFE, FLOW_ENTRY);
+        }
+    }
+
+    while(length > 0)
+    {
+        /* Decode in sequence until control leaves or joins decoded code */
+        for(int slot = worklist[--length]; slot < CONTROL_FLOW_SLOTS && !(flow->slots[slot] & FLOW_REACHABLE); slot++)
+        {
+            word_t address = (word_t)(slot << 1);
+            word_t opcode = read_memory_word(program->instruction_memory, address);
+            if(opcode == INSTRUCTION_NOOP)
+            {
+                break;
+            }
+            flow->slots[slot] |= FLOW_REACHABLE;
+            const decoded_opcode_t *decoded = &decode_table[opcode];
+            word_t target;
+            int edge = branch_target(decoded, address, &target);
+            if(edge != EDGE_FALL_THROUGH)
+            {
+                flow->slots[slot] |= FLOW_BLOCK_END;
+                add_block_start(flow, worklist, &length, target, (edge == EDGE_CALL) ? FLOW_CALL_TARGET : 0);
+                /* BRA does not fall through */
+                if(decoded->type != BRA && slot + 1 < CONTROL_FLOW_SLOTS)
+                {
+                    add_block_start(flow, worklist, &length, (word_t)(address + WORD_LENGTH), 0);
+                }
+                break;
+            }
+            if(decoded->type == UNDEFINED || writes_pc(decoded))
+            {
+                flow->slots[slot] |= FLOW_BLOCK_END;
+                break;
+            }
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief Mark the destinations of back edges as loop headers
+ *
+ * @param flow Control flow graph
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int find_loop_headers(control_flow_t *flow)
+{
+    byte_t *visit = calloc(flow->block_count + 1, sizeof(byte_t));
+    int *stack = malloc((flow->block_count + 1) * sizeof(int));
+    int *next_edge = malloc((flow->block_count + 1) * sizeof(int));
+    if(visit == NULL || stack == NULL || next_edge == NULL)
+    {
+        free(visit);
+        free(stack);
+        free(next_edge);
+        return -1;
+    }
+
+    for(int root = 0; root < flow->block_count; root++)
+    {
+        if(!(flow->blocks[root].flags & FLOW_ENTRY) || visit[root] != VISIT_NEW)
+        {
+            continue;
+        }
+        int depth = 0;
+        stack[depth] = root;
+        next_edge[depth++] = 0;
+        visit[root] = VISIT_OPEN;
+        while(depth > 0)
+        {
+            flow_block_t *block = &flow->blocks[stack[depth - 1]];
+            if(next_edge[depth - 1] == block->successor_count)
+            {
+                visit[stack[--depth]] = VISIT_DONE;
+                continue;
+            }
+            int successor = block->successors[next_edge[depth - 1]++];
+            if(visit[successor] == VISIT_OPEN && !(flow->blocks[successor].flags & FLOW_LOOP_HEADER))
+            {
+                /* Back edge */
+                flow->blocks[successor].flags |= FLOW_LOOP_HEADER;
+                flow->slots[flow->blocks[successor].start >> 1] |= FLOW_LOOP_HEADER;
+                flow->loop_header_count++;
+            }
+            else if(visit[successor] == VISIT_NEW)
+            {
+                visit[successor] = VISIT_OPEN;
+                stack[depth] = successor;
+                next_edge[depth++] = 0;
+            }
+        }
+    }
+    free(visit);
+    free(stack);
+    free(next_edge);
+    return 0;
+}
+
+/**
+ * @brief Enable the graph, built on every load
+ *
+ * @param program Program context
+ * @param dot_path DOT file written on each build - NULL for none
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_control_flow(program_t *program, char *dot_path)
+{
+    if(program == NULL || (dot_path != NULL && strlen(dot_path) >= MAX_PATH_LENGTH))
+    {
+        return -1;
+    }
+    if(program->settings.control_flow == NULL)
+    {
+        program->settings.control_flow = malloc(sizeof(control_flow_t));
+        if(program->settings.control_flow == NULL)
+        {
+            return -2;
+        }
+    }
+    strcpy_s(program->settings.control_flow->dot_path, MAX_PATH_LENGTH, (dot_path != NULL) ? dot_path : "");
+    return 0;
+}
+
+/**
+ * @brief Build the graph of the loaded program, and write it if a DOT file is set
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int build_control_flow(program_t *program)
+{
+    control_flow_t *flow = program->settings.control_flow;
+    if(flow == NULL)
+    {
+        return -1;
+    }
+    /* Each branch queues at most two slots */
+    int *worklist = malloc((2 * CONTROL_FLOW_SLOTS + VECTOR_COUNT + 1) * sizeof(int));
+    if(worklist == NULL)
+    {
+        return -2;
+    }
+    memset(flow->slots, 0, sizeof(flow->slots));
+    flow->block_count = 0;
+    flow->edge_count = 0;
+    flow->loop_header_count = 0;
+    flow->call_target_count = 0;
+    walk_code(program, worklist);
+    free(worklist);
+
+    /* Split the decoded code into blocks */
+    flow_block_t *block = NULL;
+    for(int slot = 0; slot < CONTROL_FLOW_SLOTS; slot++)
+    {
+        if(!(flow->slots[slot] & FLOW_REACHABLE))
+        {
+            block = NULL;
+            continue;
+        }
+        if(block == NULL || (flow->slots[slot] & FLOW_BLOCK_START))
+        {
+            block = &flow->blocks[flow->block_count++];
+            block->start = (word_t)(slot << 1);
+            block->flags = flow->slots[slot];
+            block->successor_count = 0;
+            flow->call_target_count += (block->flags & FLOW_CALL_TARGET) != 0;
+        }
+        block->end = (word_t)(slot << 1);
+        if(flow->slots[slot] & FLOW_BLOCK_END)
+        {
+            block = NULL;
+        }
+    }
+
+    /* Join blocks by their last instruction */
+    for(int index = 0; index < flow->block_count; index++)
+    {
+        block = &flow->blocks[index];
+        const decoded_opcode_t *decoded = &decode_table[read_memory_word(program->instruction_memory, block->end)];
+        word_t next = (word_t)(block->end + WORD_LENGTH);
+        word_t target;
+        int edge = branch_target(decoded, block->end, &target);
+        if(edge != EDGE_FALL_THROUGH)
+        {
+            add_edge(flow, block, (flow_edge_t)edge, target);
+        }
+        if(!(edge == EDGE_TAKEN && decoded->type == BRA) && decoded->type != UNDEFINED && !writes_pc(decoded) && next != 0x0000)
+        {
+            add_edge(flow, block, EDGE_FALL_THROUGH, next);
+        }
+    }
+
+    int error_status = find_loop_headers(flow);
+    printf("Control Flow: %d Blocks, %d Edges, %d Call Targets, %d Loop Headers\n", flow->block_count,
+        flow->edge_count, flow->call_target_count, flow->loop_header_count);
+    if(flow->loop_header_count > 0)
+    {
+        printf("Hot Loop Candidates:");
+        for(int index = 0; index < flow->block_count; index++)
+        {
+            if(flow->blocks[index].flags & FLOW_LOOP_HEADER)
+            {
+                printf(" #%04x", flow->blocks[index].start);
+            }
+        }
+        printf("\n");
+    }
+    if(error_status == 0 && flow->dot_path[0] != NUL)
+    {
+        error_status = write_control_flow(program, flow->dot_path);
+    }
+    return error_status;
+}
+
+/**
+ * @brief Write the graph as a DOT file - one node per block listing its instructions
+ *
+ * @param program Program context
+ * @param dot_path Output file path
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int write_control_flow(program_t *program, char *dot_path)
+{
+    control_flow_t *flow = program->settings.control_flow;
+    FILE *file;
+    if(flow == NULL || dot_path == NULL)
+    {
+        return -1;
+    }
+    if(fopen_s(&file, dot_path, "w") != 0)
+    {
+        return -2;
+    }
+    fprintf(file, "digraph control_flow {\n");
+    fprintf(file, "    node [shape=box, fontname=\"monospace\"];\n");
+    for(int index = 0; index < flow->block_count; index++)
+    {
+        flow_block_t *block = &flow->blocks[index];
+        fprintf(file, "    b%04x [label=\"", block->start);
+        for(word_t address = block->start; ; address += WORD_LENGTH)
+        {
+            word_t opcode = read_memory_word(program->instruction_memory, address);
+            fprintf(file, "#%04x  %04x  %s\\l", address, opcode, instruction_names[decode_table[opcode].type]);
+            if(address == block->end)
+            {
+                break;
+            }
+        }
+        fprintf(file, "\"%s%s];\n", (block->flags & FLOW_LOOP_HEADER) ? ", peripheries=2" : "",
+            (block->flags & (FLOW_ENTRY | FLOW_CALL_TARGET)) ? ", style=bold" : "");
+    }
+    for(int index = 0; index < flow->block_count; index++)
+    {
+        flow_block_t *block = &flow->blocks[index];
+        for(int edge = 0; edge < block->successor_count; edge++)
+        {
+            fprintf(file, "    b%04x -> b%04x%s;\n", block->start, flow->blocks[block->successors[edge]].start,
+                edge_attributes[block->edges[edge]]);
+        }
+    }
+    fprintf(file, "}\n");
+    return (fclose(file) == 0) ? 0 : -3;
+}
+
+/**
+ * @brief Free the graph, disabling it
+ *
+ * @param program Program context
+ */
+void release_control_flow(program_t *program)
+{
+    free(program->settings.control_flow);
+    program->settings.control_flow = NULL;
+}
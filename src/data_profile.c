@@ -0,0 +1,528 @@
+/**
+ * @file data_profile.c
+ * @brief Data memory access profiler
+ *
+ * Data memory accesses made by E1 are counted as reads and writes of
+ * fixed size blocks - single addresses, or lines matching a data cache -
+ * together with the address of the instruction making each access. The
+ * working set is the number of blocks accessed in each window of clock
+ * cycles. Results are printed as the hottest blocks and the instructions
+ * accessing them, or exported as a heatmap and a working set series for
+ * choosing the layout of data in small memories. Device registers are not
+ * counted. A disabled profile is a NULL pointer and costs one test per
+ * access.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-17
+ */
+
+#include "data_profile.h"
+
+/* Names accepted on export */
+static const char *profile_select_names[NUM_OF_PROFILE_SELECTS] =
+{
+    "all", "reads", "writes"
+};
+
+#define SITE_HASH 0x9E3779B1u
+
+/**
+ * @brief Block and its access count for sorting
+ */
+typedef struct profile_rank_t
+{
+    int block;
+    unsigned int accesses;
+} profile_rank_t;
+
+/**
+ * @brief Look up an access selection by name
+ *
+ * @param name Selection name
+ * @return int [>= 0 = Selection, < 0 = FAILURE]
+ */
+int parse_profile_select(char *name)
+{
+    for(int select = 0; select < NUM_OF_PROFILE_SELECTS; select++)
+    {
+        if(strcmp(name, profile_select_names[select]) == 0)
+        {
+            return select;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Free a profile and its tables
+ *
+ * @param profile Profile - may be NULL
+ */
+static void free_data_profile(data_profile_t *profile)
+{
+    if(profile == NULL)
+    {
+        return;
+    }
+    free(profile->reads);
+    free(profile->writes);
+    free(profile->stamps);
+    free(profile->sites);
+    free(profile->windows);
+    free(profile);
+}
+
+/**
+ * @brief Configure, replace or disable the data memory profile
+ *
+ * @param program Program context
+ * @param block_size Bytes counted as one block - power of two, 0 disables the profile
+ * @param window_cycles Clock cycles in each working set window
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_data_profile(program_t *program, int block_size, int window_cycles)
+{
+    if(block_size == 0)
+    {
+        free_data_profile(program->settings.data_profile);
+        program->settings.data_profile = NULL;
+        return 0;
+    }
+    if(block_size < 0 || (block_size & (block_size - 1)) != 0 || block_size > PROFILE_MAX_BLOCK_SIZE
+        || window_cycles <= 0)
+    {
+        return -1;
+    }
+
+    data_profile_t *profile = calloc(1, sizeof(data_profile_t));
+    if(profile == NULL)
+    {
+        return -2;
+    }
+    profile->block_size = block_size;
+    while((1 << profile->block_shift) < block_size)
+    {
+        profile->block_shift++;
+    }
+    profile->block_count = DATA_MEMORY_LENGTH >> profile->block_shift;
+    profile->window_cycles = window_cycles;
+    profile->site_capacity = PROFILE_SITES_INITIAL_LENGTH;
+    profile->reads = malloc(profile->block_count * sizeof(unsigned int));
+    profile->writes = malloc(profile->block_count * sizeof(unsigned int));
+    profile->stamps = malloc(profile->block_count * sizeof(int));
+    profile->sites = malloc(profile->site_capacity * sizeof(profile_site_t));
+    if(profile->reads == NULL || profile->writes == NULL || profile->stamps == NULL || profile->sites == NULL)
+    {
+        free_data_profile(profile);
+        return -2;
+    }
+    free_data_profile(program->settings.data_profile);
+    program->settings.data_profile = profile;
+    reset_data_profile(program);
+    return 0;
+}
+
+/**
+ * @brief Append a working set window
+ *
+ * @param profile Data memory profile
+ * @param start_cycle First cycle of the window
+ * @param blocks Blocks accessed in the window
+ */
+static void add_window(data_profile_t *profile, int start_cycle, int blocks)
+{
+    if(profile->window_count == profile->window_capacity)
+    {
+        int capacity = (profile->window_capacity == 0) ? PROFILE_WINDOWS_INITIAL_LENGTH : profile->window_capacity * 2;
+        profile_window_t *windows = realloc(profile->windows, capacity * sizeof(profile_window_t));
+        if(windows == NULL)
+        {
+            /* Series is cut short - counts are unaffected */
+            return;
+        }
+        profile->windows = windows;
+        profile->window_capacity = capacity;
+    }
+    profile->windows[profile->window_count].start_cycle = start_cycle;
+    profile->windows[profile->window_count].blocks = blocks;
+    profile->window_count++;
+}
+
+/**
+ * @brief Find the entry of a block and PC pair
+ *
+ * @param sites Table - capacity is a power of two
+ * @param capacity Entries in the table
+ * @param key block << 16 | PC
+ * @return profile_site_t* Entry holding the key, or the empty entry it belongs in
+ */
+static profile_site_t *find_site(profile_site_t *sites, int capacity, unsigned int key)
+{
+    unsigned int hash = key * SITE_HASH;
+    unsigned int index = (hash ^ (hash >> 16)) & (capacity - 1);
+    while(sites[index].count != 0 && sites[index].key != key)
+    {
+        index = (index + 1) & (capacity - 1);
+    }
+    return &sites[index];
+}
+
+/**
+ * @brief Count an access of a block by an instruction, growing the table at half full
+ *
+ * @param profile Data memory profile
+ * @param key block << 16 | PC
+ */
+static void count_site(data_profile_t *profile, unsigned int key)
+{
+    profile_site_t *site = find_site(profile->sites, profile->site_capacity, key);
+    if(site->count == 0)
+    {
+        if(2 * (profile->site_count + 1) > profile->site_capacity)
+        {
+            int capacity = profile->site_capacity * 2;
+            profile_site_t *sites = calloc(capacity, sizeof(profile_site_t));
+            if(sites == NULL)
+            {
+                /* Instruction is not attributed - counts are unaffected */
+                return;
+            }
+            for(int i = 0; i < profile->site_capacity; i++)
+            {
+                if(profile->sites[i].count != 0)
+                {
+                    *find_site(sites, capacity, profile->sites[i].key) = profile->sites[i];
+                }
+            }
+            free(profile->sites);
+            profile->sites = sites;
+            profile->site_capacity = capacity;
+            site = find_site(sites, capacity, key);
+        }
+        site->key = key;
+        profile->site_count++;
+    }
+    site->count++;
+}
+
+/**
+ * @brief Count a data memory access
+ *
+ * @param profile Data memory profile
+ * @param address Byte address accessed
+ * @param write Access is a write
+ * @param pc Address of the instruction making the access
+ * @param clock_cycle Clock cycle of the access
+ */
+void profile_access(data_profile_t *profile, word_t address, int write, word_t pc, int clock_cycle)
+{
+    int block = address >> profile->block_shift;
+
+    /* Close the open window, and any passed without accesses */
+    if(clock_cycle - profile->window_start >= profile->window_cycles)
+    {
+        add_window(profile, profile->window_start, profile->window_blocks);
+        profile->window_start += profile->window_cycles;
+        while(clock_cycle - profile->window_start >= profile->window_cycles)
+        {
+            add_window(profile, profile->window_start, 0);
+            profile->window_start += profile->window_cycles;
+        }
+        profile->window_blocks = 0;
+        profile->window_number++;
+    }
+    if(profile->stamps[block] != profile->window_number)
+    {
+        profile->stamps[block] = profile->window_number;
+        profile->window_blocks++;
+    }
+    if(profile->reads[block] == 0 && profile->writes[block] == 0)
+    {
+        profile->footprint++;
+    }
+
+    if(write)
+    {
+        profile->writes[block]++;
+    }
+    else
+    {
+        profile->reads[block]++;
+    }
+    count_site(profile, ((unsigned int)block << 16) | pc);
+}
+
+/**
+ * @brief Clear the counts and working set series
+ *
+ * @param program Program context
+ */
+void reset_data_profile(program_t *program)
+{
+    data_profile_t *profile = program->settings.data_profile;
+    if(profile == NULL)
+    {
+        return;
+    }
+    memset(profile->reads, 0, profile->block_count * sizeof(unsigned int));
+    memset(profile->writes, 0, profile->block_count * sizeof(unsigned int));
+    memset(profile->stamps, 0, profile->block_count * sizeof(int));
+    memset(profile->sites, 0, profile->site_capacity * sizeof(profile_site_t));
+    profile->site_count = 0;
+    profile->window_count = 0;
+    profile->window_start = 0;
+    profile->window_blocks = 0;
+    /* Stamps of 0 are blocks never accessed */
+    profile->window_number = 1;
+    profile->footprint = 0;
+}
+
+/**
+ * @brief Free the profile, disabling it
+ *
+ * @param program Program context
+ */
+void release_data_profile(program_t *program)
+{
+    set_data_profile(program, 0, 0);
+}
+
+/**
+ * @brief Order blocks by accesses, most first, then by address
+ */
+static int compare_ranks(const void *first, const void *second)
+{
+    const profile_rank_t *a = first;
+    const profile_rank_t *b = second;
+    if(a->accesses != b->accesses)
+    {
+        return (a->accesses < b->accesses) ? 1 : -1;
+    }
+    return a->block - b->block;
+}
+
+/**
+ * @brief Print the instructions accessing a block most, most first
+ *
+ * @param profile Data memory profile
+ * @param block Block accessed
+ */
+static void display_block_sites(data_profile_t *profile, int block)
+{
+    profile_site_t top[PROFILE_TOP_PCS] = {0};
+    for(int i = 0; i < profile->site_capacity; i++)
+    {
+        profile_site_t site = profile->sites[i];
+        if(site.count == 0 || (int)(site.key >> 16) != block)
+        {
+            continue;
+        }
+        /* Insert into the ordered list, dropping the last */
+        for(int j = 0; j < PROFILE_TOP_PCS; j++)
+        {
+            if(site.count > top[j].count || (site.count == top[j].count && top[j].count != 0 && site.key < top[j].key))
+            {
+                profile_site_t displaced = top[j];
+                top[j] = site;
+                site = displaced;
+            }
+        }
+    }
+    for(int j = 0; j < PROFILE_TOP_PCS && top[j].count != 0; j++)
+    {
+        printf(" #%04x (%u)", top[j].key & 0xFFFF, top[j].count);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Print totals, working set sizes and the hottest blocks with the instructions accessing them
+ *
+ * @param program Program context
+ * @param top_count Blocks listed
+ */
+void display_data_profile(program_t *program, int top_count)
+{
+    data_profile_t *profile = program->settings.data_profile;
+    if(profile == NULL)
+    {
+        return;
+    }
+    unsigned long long reads = 0;
+    unsigned long long writes = 0;
+    int ranked = 0;
+    profile_rank_t *ranks = malloc(profile->block_count * sizeof(profile_rank_t));
+    for(int block = 0; block < profile->block_count; block++)
+    {
+        reads += profile->reads[block];
+        writes += profile->writes[block];
+        if(ranks != NULL && profile->reads[block] + profile->writes[block] > 0)
+        {
+            ranks[ranked].block = block;
+            ranks[ranked].accesses = profile->reads[block] + profile->writes[block];
+            ranked++;
+        }
+    }
+    /* Open window is included while it holds accesses */
+    int peak = profile->window_blocks;
+    long long total = profile->window_blocks;
+    int windows = profile->window_count + (profile->window_blocks > 0);
+    for(int i = 0; i < profile->window_count; i++)
+    {
+        peak = (profile->windows[i].blocks > peak) ? profile->windows[i].blocks : peak;
+        total += profile->windows[i].blocks;
+    }
+
+    printf("Data Profile: %d Byte Blocks, %d Cycle Windows\n", profile->block_size, profile->window_cycles);
+    printf("Reads: %llu Writes: %llu Footprint: %d Blocks (%d Bytes)\n", reads, writes,
+        profile->footprint, profile->footprint * profile->block_size);
+    printf("Working Set - Peak: %d Blocks (%d Bytes)", peak, peak * profile->block_size);
+    if(windows > 0)
+    {
+        printf(" Mean: %.1f Blocks over %d Windows", (double)total / windows, windows);
+    }
+    printf("\n");
+    if(ranks == NULL)
+    {
+        return;
+    }
+    qsort(ranks, ranked, sizeof(profile_rank_t), compare_ranks);
+    for(int i = 0; i < ranked && i < top_count; i++)
+    {
+        int block = ranks[i].block;
+        printf("  #%04x - #%04x: %10u Reads %10u Writes  PCs:", block << profile->block_shift,
+            ((block + 1) << profile->block_shift) - 1, profile->reads[block], profile->writes[block]);
+        display_block_sites(profile, block);
+    }
+    free(ranks);
+}
+
+/**
+ * @brief Accesses of a block selected for a heatmap
+ *
+ * @param profile Data memory profile
+ * @param block Block accessed
+ * @param select Reads, writes or both
+ * @return unsigned int Selected accesses
+ */
+static unsigned int selected_accesses(data_profile_t *profile, int block, profile_select_t select)
+{
+    switch(select)
+    {
+        case PROFILE_READS:
+            return profile->reads[block];
+        case PROFILE_WRITES:
+            return profile->writes[block];
+        default:
+            return profile->reads[block] + profile->writes[block];
+    }
+}
+
+/**
+ * @brief Number of significant bits - a logarithmic heat level
+ *
+ * @param value Value to measure
+ * @return int [0 - 32]
+ */
+static int bit_length(unsigned int value)
+{
+    int length = 0;
+    while(value != 0)
+    {
+        value >>= 1;
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Write block accesses as a heatmap - a PGM image when the path ends
+ * in .pgm, CSV rows of consecutive blocks otherwise
+ *
+ * Image rows hold PROFILE_HEATMAP_WIDTH blocks, with brightness logarithmic
+ * in accesses so rarely used blocks remain visible beside hot ones.
+ *
+ * @param program Program context
+ * @param path Output path
+ * @param select Reads, writes or both
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int export_profile_heatmap(program_t *program, const char *path, profile_select_t select)
+{
+    data_profile_t *profile = program->settings.data_profile;
+    if(profile == NULL || select < 0 || select >= NUM_OF_PROFILE_SELECTS)
+    {
+        return -1;
+    }
+    size_t path_length = strlen(path);
+    int image = path_length > 4 && strcmp(path + path_length - 4, ".pgm") == 0;
+    FILE *file = fopen(path, image ? "wb" : "w");
+    if(file == NULL)
+    {
+        return -2;
+    }
+
+    if(image)
+    {
+        int hottest = 0;
+        for(int block = 0; block < profile->block_count; block++)
+        {
+            int level = bit_length(selected_accesses(profile, block, select));
+            hottest = (level > hottest) ? level : hottest;
+        }
+        fprintf(file, "P5\n%d %d\n255\n", PROFILE_HEATMAP_WIDTH, profile->block_count / PROFILE_HEATMAP_WIDTH);
+        for(int block = 0; block < profile->block_count; block++)
+        {
+            int level = bit_length(selected_accesses(profile, block, select));
+            fputc((hottest == 0) ? 0 : 255 * level / hottest, file);
+        }
+    }
+    else
+    {
+        fprintf(file, "address");
+        for(int column = 0; column < PROFILE_HEATMAP_COLUMNS; column++)
+        {
+            fprintf(file, ",+%x", column << profile->block_shift);
+        }
+        fprintf(file, "\n");
+        for(int row = 0; row < profile->block_count; row += PROFILE_HEATMAP_COLUMNS)
+        {
+            fprintf(file, "%04x", row << profile->block_shift);
+            for(int column = 0; column < PROFILE_HEATMAP_COLUMNS; column++)
+            {
+                fprintf(file, ",%u", selected_accesses(profile, row + column, select));
+            }
+            fprintf(file, "\n");
+        }
+    }
+    return (fclose(file) == 0) ? 0 : -2;
+}
+
+/**
+ * @brief Write the working set of each window as CSV, ending with the open window
+ *
+ * @param program Program context
+ * @param path Output path
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int export_working_set(program_t *program, const char *path)
+{
+    data_profile_t *profile = program->settings.data_profile;
+    if(profile == NULL)
+    {
+        return -1;
+    }
+    FILE *file = fopen(path, "w");
+    if(file == NULL)
+    {
+        return -2;
+    }
+    fprintf(file, "cycle,blocks,bytes\n");
+    for(int i = 0; i < profile->window_count; i++)
+    {
+        fprintf(file, "%d,%d,%d\n", profile->windows[i].start_cycle, profile->windows[i].blocks,
+            profile->windows[i].blocks * profile->block_size);
+    }
+    fprintf(file, "%d,%d,%d\n", profile->window_start, profile->window_blocks, profile->window_blocks * profile->block_size);
+    return (fclose(file) == 0) ? 0 : -2;
+}
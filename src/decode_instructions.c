@@ -9,72 +9,18 @@
 #include "decode_instructions.h"
 
 /**
- * @brief Array of MOV instructions.
+ * @brief Condition tested by each conditional branch, BEQ through BLT
  * 
- * This array represents the MOV instructions supported by the system.
  */
-instruction_type_t mov_table[MOV_INSTRUCTION_COUNT] = 
+static const condition_code_t branch_conditions[BLT - BEQ + 1] = 
 {
-    MOVL, 
-    MOVLZ, 
-    MOVLS, 
-    MOVH
-};
-
-/**
- * @brief Table of arithmetic register instructions.
- * 
- * This table stores the arithmetic register instructions supported by the system.
- * The instructions are stored in the order they appear in the instruction set.
- */
-instruction_type_t arithmetic_register_table[ARITHMETIC_REGISTER_INSTRUCTION_COUNT] = 
-{
-    ADD, 
-    ADDC, 
-    SUB, 
-    SUBC, 
-    DADD, 
-    CMP,
-    XOR,
-    AND,
-    OR,
-    BIT,
-    BIC,
-    BIS,
-};
-
-/**
- * @brief Table of shift register instructions.
- * 
- * This table stores the shift register instructions supported by the system.
- */
-instruction_type_t shift_register_table[SHIFT_REGISTER_INSTRUCTION_COUNT] = 
-{
-    SRA,
-    RRC,
-    UNDEFINED,
-    SWPB,
-    SXT,
-    UNDEFINED,
-    UNDEFINED,
-    UNDEFINED
-};
-
-/**
- * @brief Table of branch instructions.
- * 
- * This table stores the branch instructions supported by the system.
- */
-instruction_type_t branch_table[BRANCH_INSTRUCTION_COUNT] = 
-{
-    BEQ, 
-    BNE, 
-    BC, 
-    BNC, 
-    BN, 
-    BGE, 
-    BLT, 
-    BRA
+    EQUAL,
+    NOT_EQUAL,
+    CARRY,
+    NOT_CARRY,
+    NEGATIVE,
+    SIGNED_GREATER_EQUAL,
+    SIGNED_LESS
 };
 
 /**
@@ -90,20 +36,81 @@ int reset_instruction_arguments(instruction_t *instruction)
     {
         return -1;
     }
-    /* Copy Opcode and Address */
-    word_t opcode = instruction->opcode;
+    /* Copy Address */
     word_t address = instruction->address;
     
     /* Clear Instruction Struct */
     memset(instruction, 0, sizeof(instruction_t));
-    /* Restore Opcode and Address */
-    instruction->opcode = opcode;
+    /* Restore Address */
     instruction->address = address;
 
 
     return 0;
 }
 
+/**
+ * @brief Fuse a decoded instruction with the one fetched after it
+ * 
+ * Recognised pairs are CMP followed by a conditional branch, and MOVL, MOVLZ
+ * or MOVLS followed by MOVH of the same register. The pair is decoded now
+ * and executed as one operation in the second instruction's slot; the first
+ * slot still takes its cycles. Interrupts and stops wait for the pair to
+ * complete, so pairs are only fused where neither can happen between them
+ * and the effects are those of the two instructions in sequence.
+ * 
+ * @param instruction First instruction of a possible pair
+ * @param program Program context
+ */
+static void fuse_instruction(instruction_t *instruction, program_t *program)
+{
+    /* Fetched by F0 of this cycle */
+    word_t address = program->instruction_memory_address_register;
+    word_t breakpoint = (word_t)program->breakpoint & 0xFFFE;
+    if(program->bubble_queue.size != 0 || program->debug_mode || program->settings.fusion_disabled
+        || address == breakpoint || (word_t)(address - WORD_LENGTH) == breakpoint)
+    {
+        return;
+    }
+    /* The run must not stop, and events must not be serviced, between the pair.
+        A data access in E1 of this cycle may raise an event */
+    if(program->clock_cycles + 1 >= program->cycle_limit || INSTRUCTION_DATA(&program->previous_instruction)
+        || program->next_event_cycle <= program->clock_cycles + CYCLES_PER_INSTRUCTION)
+    {
+        return;
+    }
+    word_t next = read_memory_word(program->instruction_memory, address);
+
+    const decoded_opcode_t *decoded = &decode_table[next];
+
+    instruction_t fused = *instruction;
+    if(instruction->type == CMP)
+    {
+        /* Conditional branch - BRA is not fused */
+        if(decoded->type < BEQ || decoded->type > BLT)
+        {
+            return;
+        }
+        fused.type = FUSED_CMP_BRANCH;
+        /* Branch offset in bits 0-9, condition in bits 10-13 */
+        fused.argument = decoded->argument | (branch_conditions[decoded->type - BEQ] << FUSED_CONDITION_SHIFT);
+    }
+    else
+    {
+        /* MOVH to the same register - PC writes redirect fetch and are not fused */
+        if(decoded->type != MOVH || decoded->destination != instruction->destination || instruction->destination == PC)
+        {
+            return;
+        }
+        fused.type = FUSED_MOVE;
+        /* High byte in argument, low byte in source */
+        fused.argument = decoded->source;
+    }
+    program->fused_instruction = fused;
+    program->fusion_pending = 1;
+    /* First slot carries no work */
+    instruction->type = SKIPPED;
+}
+
 /**
  * @brief Decode an instruction from a memory address
  * 
@@ -121,255 +128,65 @@ int decode_instruction(instruction_t *instruction, program_t *program)
     {
         return -1;
     }
+    int restart = 0;
 
     /* Check if bubble queue is empty */
-    if(program->bubble_queue.size > 0)
+    if(program->bubble_queue.size > 0 && remove_bubble(&program->bubble_queue))
     {
-        /* Check if next instruction should bubble */
-        if(remove_bubble(&program->bubble_queue))
-        {
-            /* Replace next instruction with NOOP */
+        /* Replace next instruction with NOOP */
 #ifdef DEBUG
-            printf("Bubblin'...\n");
+        printf("Bubblin'...\n");
 #endif
-            program->instruction_register = INSTRUCTION_NOOP;
-        }
+        program->instruction_register = INSTRUCTION_NOOP;
+        record_bubble(program, program->bubble_queue.cause, program->bubble_queue.source_address);
+        /* Dropped without decoding - the slot still takes its cycles */
+        reset_instruction_arguments(instruction);
+        program->instruction_opcode = INSTRUCTION_NOOP;
+        instruction->type = SKIPPED;
+        instruction->flags = OPERAND_NOOP;
+        return 0;
+    }
+    else if(program->fusion_pending)
+    {
+        /* Second instruction of a pair - decoded with the first */
+        program->fusion_pending = 0;
+        program->statistics.instructions_retired++;
+        program->instruction_opcode = program->instruction_register;
+        *instruction = program->fused_instruction;
+        return 0;
+    }
+    else if(program->cycle_state == CYCLE_START)
+    {
+        /* NOOP loaded to restart the pipeline */
+        record_bubble(program, BUBBLE_RESTART, program->PROGRAM_COUNTER - WORD_LENGTH);
+        restart = 1;
+    }
+    else
+    {
+        program->statistics.instructions_retired++;
     }
 
     word_t instruction_register = program->instruction_register;
-
-    /* Clear Instruction Struct */
-    reset_instruction_arguments(instruction);
-    instruction->opcode = instruction_register;
-    
-    /* Decode Bits Thirteen through Fifteen */
-    switch (READ_BITS(instruction_register, 13, 15))
+    /* Single lookup in the generated table */
+    const decoded_opcode_t *decoded = &decode_table[instruction_register];
+
+    /* Copy the descriptor - address is kept */
+    program->instruction_opcode = instruction_register;
+    instruction->type = decoded->type;
+    instruction->source = decoded->source;
+    instruction->destination = decoded->destination;
+    instruction->flags = decoded->flags | (restart ? OPERAND_NOOP : 0);
+    instruction->argument = decoded->argument;
+
+    /* Load into PC - the fetched instruction is discarded */
+    if((instruction->type == LD || instruction->type == LDR) && instruction->destination == PC)
     {
-    /* Move Instructions */
-    case MOVE_CODE:
-        /* Decode Opcode from bits Eleven and Twelve */
-        instruction->type = mov_table[READ_BITS(instruction_register, 11, 12)];
-        /* Decode source byte from bits Three through Ten */
-        instruction->source = READ_BITS(instruction_register, 3, 10);
-        /* Decode destination register from bits Zero through Two */
-        instruction->destination = READ_BITS(instruction_register, 0, 2);
-        break;
-
-    case REGISTER_CODE:
-        /* Read bits Eight through Twelve */
-        if(READ_BITS(instruction_register, 8, 12) < ARITHMETIC_REGISTER_CODE)
-        {
-            /* Arithmetic Register Instruction - Bits Eight through Twelve */
-            instruction->type = arithmetic_register_table[READ_BITS(instruction_register, 8, 12)];
-            /* Register/Constant Select - Bit Seven */
-            instruction->rc = READ_BITS(instruction_register, 7, 7);
-            /* Word/Byte Select - Bit Six */
-            instruction->wb = READ_BITS(instruction_register, 6, 6);
-            /* Source Register - Bits Three through Five*/
-            instruction->source = READ_BITS(instruction_register, 3, 5);
-            /* Destination Register - Bits Zero through Two */
-            instruction->destination = READ_BITS(instruction_register, 0, 2);
-        }
-        /* Read Bits Eight through Twelve */
-        else if (READ_BITS(instruction_register, 8, 12) == SWAP_REGISTER_CODE)
-        {
-            /* MOV/Swap Instruction - Bit Seven */
-            if(READ_BITS(instruction_register, 7, 7))
-            {
-                /* Swap Instruction */
-                instruction->type = SWAP;
-            }
-            else
-            {
-                /* Mov Instruction */
-                instruction->type = MOV;
-                /* Word/Byte Select - Bit Six*/
-                instruction->wb = READ_BITS(instruction_register, 6, 6);
-            }
-            /* Source Register - Bits Three through Five */
-            instruction->source = READ_BITS(instruction_register, 3, 5);
-            /* Destination Register - Bits Zero through Three */
-            instruction->destination = READ_BITS(instruction_register, 0, 2);
-        }
-        /* Read Bits Eight through Twelve */
-        else if (READ_BITS(instruction_register, 8, 12) == SHIFT_REGISTER_CODE)
-        {
-            /* Read Bit Seven */
-            if(READ_BITS(instruction_register, 7, 7) == 1)
-            {
-                /* CPU Instructions */
-                /* Read bit 6*/
-                if(READ_BITS(instruction_register, 6, 6) == 1)
-                {
-                    /* CLRCC */
-                    instruction->type = CLRCC;
-                    instruction->status.overflow = READ_BITS(instruction_register, 4, 4);
-                    instruction->status.sleep = READ_BITS(instruction_register, 3, 3);
-                    instruction->status.negative = READ_BITS(instruction_register, 2, 2);
-                    instruction->status.zero = READ_BITS(instruction_register, 1, 1);
-                    instruction->status.carry = READ_BITS(instruction_register, 0, 0);
-                }
-                /* Read bit 5 */
-                else if (READ_BITS(instruction_register, 5, 5) == 1)
-                {
-                    /* SETCC */
-                    instruction->type = SETCC;
-                    instruction->status.overflow = READ_BITS(instruction_register, 4, 4);
-                    instruction->status.sleep = READ_BITS(instruction_register, 3, 3);
-                    instruction->status.negative = READ_BITS(instruction_register, 2, 2);
-                    instruction->status.zero = READ_BITS(instruction_register, 1, 1);
-                    instruction->status.carry = READ_BITS(instruction_register, 0, 0);
-                }
-                /* Read bit 4 */
-                else if (READ_BITS(instruction_register, 4, 4) == 1)
-                {
-                    /* SVC */
-                    instruction->type = SVC;
-                    /* Service Address - Bits Zero through Three */
-                    instruction->sa = READ_BITS(instruction_register, 0, 3);
-                }
-                /* Read bit 3 */
-                else if(READ_BITS(instruction_register, 3, 3) == 1)
-                {
-                    /* Invalid Instruction */
-                    instruction->type = UNDEFINED;
-                }
-                else
-                {
-                    /* SETPRI */
-                    instruction->type = SETPRI;
-                    /* Priority Level - Bits Zero through Three */
-                }
-            }
-            else
-            {
-                /* Shift Register Instruction */
-                /* Word/Byte Select - Bit Six */
-                instruction->wb = READ_BITS(instruction_register, 6, 6);
-                /* Decode Type from bits 3 through 5 */
-                instruction->type = shift_register_table[READ_BITS(instruction_register, 3, 5)];
-                /* Destination Register - Bits 0 through 2 */
-                instruction->destination = READ_BITS(instruction_register, 0, 2);
-
-            }
-        }
-        else if(READ_BITS(instruction_register, 12, 12) == 1)
-        {
-            switch(READ_BITS(instruction_register, 10, 11))
-            {
-                case CEX_CODE:
-                    /* CEX */
-                    instruction->type = CEX;
-                    /* Decode Condition Code */
-                    instruction->condition_code = READ_BITS(instruction_register, 6, 9);
-                    /* Decode True Count */
-                    instruction->t_count = READ_BITS(instruction_register, 3, 5);
-                    /* Decode False Count */
-                    instruction->f_count = READ_BITS(instruction_register, 0, 2);
-                    break;
-                case LD_CODE:
-                    /* LD */
-                    instruction->type = LD;
-                    /* Decode Pre/Post Increment Flag */
-                    instruction->prpo = READ_BITS(instruction_register, 9, 9);
-                    /* Decode Decrement Flag */
-                    instruction->decrement = READ_BITS(instruction_register, 8, 8);
-                    /* Decode Increment Flag */
-                    instruction->increment = READ_BITS(instruction_register, 7, 7);
-                    /* Decode Word/Byte Flag */
-                    instruction->wb = READ_BITS(instruction_register, 6, 6);
-                    /* Decode Source Register */
-                    instruction->source = READ_BITS(instruction_register, 3, 5);
-                    /* Decode Destination Register */
-                    instruction->destination = READ_BITS(instruction_register, 0, 2);
-                    /* Check if destination is PC, and insert bubble */
-                    if(instruction->destination == PC)
-                    {
-                        clear_bubble_queue(&program->bubble_queue);
-                        insert_bubble(&program->bubble_queue, BUBBLE);
-                    }
-                    break;
-                case ST_CODE:
-                    /* ST */
-                    instruction->type = ST;
-                    /* Decode Pre/Post Increment Flag */
-                    instruction->prpo = READ_BITS(instruction_register, 9, 9);
-                    /* Decode Decrement Flag */
-                    instruction->decrement = READ_BITS(instruction_register, 8, 8);
-                    /* Decode Increment Flag */
-                    instruction->increment = READ_BITS(instruction_register, 7, 7);
-                    /* Decode Word/Byte Flag */
-                    instruction->wb = READ_BITS(instruction_register, 6, 6);
-                    /* Decode Source Register */
-                    instruction->source = READ_BITS(instruction_register, 3, 5);
-                    /* Decode Destination Register */
-                    instruction->destination = READ_BITS(instruction_register, 0, 2);
-
-                    break;
-                default:
-                    /* Instruction not implemented */
-                    instruction->type = UNDEFINED;
-                    break;
-            }
-        }
-        else
-        {
-            /* Instruction not implemented */
-            instruction->type = UNDEFINED;
-        }
-        
-        break;
-    case BRANCH_CODE:
-        /* Decode Type from bits 10 - 12 */
-        instruction->type = branch_table[READ_BITS(instruction_register, 10, 12)];
-        /* Decode Branch Offset from bits 9 - 0 */
-        instruction->offset = READ_BITS(instruction_register, 0, 9);
-        break;
-    case LINK_CODE:
-        instruction->type = BL;
-        /* Decode Branch Offset from bits 0 - 12 */
-        instruction->offset = READ_BITS(instruction_register, 0, 12);
-        break;
-    default:
-        if(READ_BITS(instruction_register, 14, 15) == LOAD_RELATIVE_CODE)
-        {
-            /* Load Relative Instruction */
-            instruction->type = LDR;
-            /* Decode Offset from bits 7 - 13 */
-            instruction->offset = READ_BITS(instruction_register, 7, 13);
-            /* Decode Word/Byte Select from bit 6 */
-            instruction->wb = READ_BITS(instruction_register, 6, 6);
-            /* Decode Source Register from bits 3 - 5 */
-            instruction->source = READ_BITS(instruction_register, 3, 5);
-            /* Decode Destination Register from bits 0 - 3 */
-            instruction->destination = READ_BITS(instruction_register, 0, 2);
-            /* Check if destination is PC, and insert bubble */
-            if(instruction->destination == PC)
-            {
-                clear_bubble_queue(&program->bubble_queue);
-                insert_bubble(&program->bubble_queue, BUBBLE);
-            }
-        }
-        else if(READ_BITS(instruction_register, 14, 15) == STORE_RELATIVE_CODE)
-        {
-            /* Store Relative Instruction */
-            instruction->type = STR;
-            /* Decode Offset from bits 7 - 13 */
-            instruction->offset = READ_BITS(instruction_register, 7, 13);
-            /* Decode Word/Byte Select from bit 6 */
-            instruction->wb = READ_BITS(instruction_register, 6, 6);
-            /* Decode Source Register from bits 3 - 5 */
-            instruction->source = READ_BITS(instruction_register, 3, 5);
-            /* Decode Destination Register from bits 0 - 2 */
-            instruction->destination = READ_BITS(instruction_register, 0, 2);
-        }
-        else
-        {
-            /* Instruction not implemented */
-            instruction->type = UNDEFINED;
-        }
-        break;
+        flush_pipeline(program, BUBBLE_LOAD_PC, program->PROGRAM_COUNTER - 2 * WORD_LENGTH);
     }
 
+    if(instruction->type == CMP || instruction->type == MOVL || instruction->type == MOVLZ || instruction->type == MOVLS)
+    {
+        fuse_instruction(instruction, program);
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+/**
+ * @file decode_opcode.c
+ * @brief Reference decoder for a single instruction word
+ *
+ * Built into the decode table generator, which runs it over every opcode.
+ * The emulator itself decodes by indexing the generated table.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-30
+ */
+
+#include "decode_table.h"
+#include "decode_instructions.h"
+
+/**
+ * @brief Array of MOV instructions.
+ *
+ * This array represents the MOV instructions supported by the system.
+ */
+static const instruction_type_t mov_table[MOV_INSTRUCTION_COUNT] =
+{
+    MOVL,
+    MOVLZ,
+    MOVLS,
+    MOVH
+};
+
+/**
+ * @brief Table of arithmetic register instructions.
+ *
+ * This table stores the arithmetic register instructions supported by the system.
+ * The instructions are stored in the order they appear in the instruction set.
+ */
+static const instruction_type_t arithmetic_register_table[ARITHMETIC_REGISTER_INSTRUCTION_COUNT] =
+{
+    ADD,
+    ADDC,
+    SUB,
+    SUBC,
+    DADD,
+    CMP,
+    XOR,
+    AND,
+    OR,
+    BIT,
+    BIC,
+    BIS,
+};
+
+/**
+ * @brief Table of shift register instructions.
+ *
+ * This table stores the shift register instructions supported by the system.
+ */
+static const instruction_type_t shift_register_table[SHIFT_REGISTER_INSTRUCTION_COUNT] =
+{
+    SRA,
+    RRC,
+    UNDEFINED,
+    SWPB,
+    SXT,
+    UNDEFINED,
+    UNDEFINED,
+    UNDEFINED
+};
+
+/**
+ * @brief Table of branch instructions.
+ *
+ * This table stores the branch instructions supported by the system.
+ */
+static const instruction_type_t branch_table[BRANCH_INSTRUCTION_COUNT] =
+{
+    BEQ,
+    BNE,
+    BC,
+    BNC,
+    BN,
+    BGE,
+    BLT,
+    BRA
+};
+
+/**
+ * @brief Decode an instruction word into its type and operand fields
+ *
+ * @param opcode Instruction word to decode
+ * @param decoded Descriptor receiving the fields
+ */
+void decode_opcode(word_t opcode, decoded_opcode_t *decoded)
+{
+    /* Clear Descriptor */
+    memset(decoded, 0, sizeof(decoded_opcode_t));
+    decoded->type = UNDEFINED;
+
+    /* Decode Bits Thirteen through Fifteen */
+    switch (READ_BITS(opcode, 13, 15))
+    {
+    /* Move Instructions */
+    case MOVE_CODE:
+        /* Decode Opcode from bits Eleven and Twelve */
+        decoded->type = mov_table[READ_BITS(opcode, 11, 12)];
+        /* Decode source byte from bits Three through Ten */
+        decoded->source = READ_BITS(opcode, 3, 10);
+        /* Decode destination register from bits Zero through Two */
+        decoded->destination = READ_BITS(opcode, 0, 2);
+        break;
+
+    case REGISTER_CODE:
+        /* Read bits Eight through Twelve */
+        if(READ_BITS(opcode, 8, 12) < ARITHMETIC_REGISTER_CODE)
+        {
+            /* Arithmetic Register Instruction - Bits Eight through Twelve */
+            decoded->type = arithmetic_register_table[READ_BITS(opcode, 8, 12)];
+            /* Register/Constant Select - Bit Seven, Word/Byte Select - Bit Six */
+            decoded->flags = (READ_BITS(opcode, 7, 7) ? OPERAND_RC : 0) | (READ_BITS(opcode, 6, 6) ? OPERAND_WB : 0);
+            /* Source Register - Bits Three through Five*/
+            decoded->source = READ_BITS(opcode, 3, 5);
+            /* Destination Register - Bits Zero through Two */
+            decoded->destination = READ_BITS(opcode, 0, 2);
+        }
+        /* Read Bits Eight through Twelve */
+        else if (READ_BITS(opcode, 8, 12) == SWAP_REGISTER_CODE)
+        {
+            /* MOV/Swap Instruction - Bit Seven */
+            if(READ_BITS(opcode, 7, 7))
+            {
+                /* Swap Instruction */
+                decoded->type = SWAP;
+            }
+            else
+            {
+                /* Mov Instruction */
+                decoded->type = MOV;
+                /* Word/Byte Select - Bit Six*/
+                decoded->flags = READ_BITS(opcode, 6, 6) ? OPERAND_WB : 0;
+            }
+            /* Source Register - Bits Three through Five */
+            decoded->source = READ_BITS(opcode, 3, 5);
+            /* Destination Register - Bits Zero through Three */
+            decoded->destination = READ_BITS(opcode, 0, 2);
+        }
+        /* Read Bits Eight through Twelve */
+        else if (READ_BITS(opcode, 8, 12) == SHIFT_REGISTER_CODE)
+        {
+            /* Read Bit Seven */
+            if(READ_BITS(opcode, 7, 7) == 1)
+            {
+                /* CPU Instructions */
+                if(READ_BITS(opcode, 6, 6) == 1)
+                {
+                    /* CLRCC - V, SLP, N, Z, C in bits Four through Zero */
+                    decoded->type = CLRCC;
+                    decoded->argument = READ_BITS(opcode, 0, 4);
+                }
+                else if (READ_BITS(opcode, 5, 5) == 1)
+                {
+                    /* SETCC - V, SLP, N, Z, C in bits Four through Zero */
+                    decoded->type = SETCC;
+                    decoded->argument = READ_BITS(opcode, 0, 4);
+                }
+                else if (READ_BITS(opcode, 4, 4) == 1)
+                {
+                    /* SVC - Service Address Bits Zero through Three */
+                    decoded->type = SVC;
+                    decoded->argument = READ_BITS(opcode, 0, 3);
+                }
+                else if(READ_BITS(opcode, 3, 3) == 0)
+                {
+                    /* SETPRI - Priority Level Bits Zero through Two */
+                    decoded->type = SETPRI;
+                    decoded->argument = READ_BITS(opcode, 0, 2);
+                }
+            }
+            else
+            {
+                /* Shift Register Instruction */
+                /* Word/Byte Select - Bit Six */
+                decoded->flags = READ_BITS(opcode, 6, 6) ? OPERAND_WB : 0;
+                /* Decode Type from bits 3 through 5 */
+                decoded->type = shift_register_table[READ_BITS(opcode, 3, 5)];
+                /* Destination Register - Bits 0 through 2 */
+                decoded->destination = READ_BITS(opcode, 0, 2);
+            }
+        }
+        else if(READ_BITS(opcode, 12, 12) == 1)
+        {
+            switch(READ_BITS(opcode, 10, 11))
+            {
+                case CEX_CODE:
+                    /* CEX - Condition Code Bits Six through Nine, True Count Three through Five, False Count Zero through Two */
+                    decoded->type = CEX;
+                    decoded->argument = READ_BITS(opcode, 0, 9);
+                    break;
+                case LD_CODE:
+                case ST_CODE:
+                    decoded->type = (READ_BITS(opcode, 10, 11) == LD_CODE) ? LD : ST;
+                    /* Pre/Post, Decrement, Increment and Word/Byte Flags - Bits Nine through Six */
+                    decoded->flags = (READ_BITS(opcode, 9, 9) ? OPERAND_PRPO : 0) | (READ_BITS(opcode, 8, 8) ? OPERAND_DECREMENT : 0)
+                        | (READ_BITS(opcode, 7, 7) ? OPERAND_INCREMENT : 0) | (READ_BITS(opcode, 6, 6) ? OPERAND_WB : 0);
+                    /* Decode Source Register */
+                    decoded->source = READ_BITS(opcode, 3, 5);
+                    /* Decode Destination Register */
+                    decoded->destination = READ_BITS(opcode, 0, 2);
+                    break;
+                default:
+                    /* Instruction not implemented */
+                    break;
+            }
+        }
+        break;
+    case BRANCH_CODE:
+        /* Decode Type from bits 10 - 12 */
+        decoded->type = branch_table[READ_BITS(opcode, 10, 12)];
+        /* Decode Branch Offset from bits 9 - 0 */
+        decoded->argument = READ_BITS(opcode, 0, 9);
+        break;
+    case LINK_CODE:
+        decoded->type = BL;
+        /* Decode Branch Offset from bits 0 - 12 */
+        decoded->argument = READ_BITS(opcode, 0, 12);
+        break;
+    default:
+        /* Load and Store Relative Instructions */
+        decoded->type = (READ_BITS(opcode, 14, 15) == LOAD_RELATIVE_CODE) ? LDR : STR;
+        /* Decode Offset from bits 7 - 13 */
+        decoded->argument = READ_BITS(opcode, 7, 13);
+        /* Decode Word/Byte Select from bit 6 */
+        decoded->flags = READ_BITS(opcode, 6, 6) ? OPERAND_WB : 0;
+        /* Decode Source Register from bits 3 - 5 */
+        decoded->source = READ_BITS(opcode, 3, 5);
+        /* Decode Destination Register from bits 0 - 2 */
+        decoded->destination = READ_BITS(opcode, 0, 2);
+        break;
+    }
+}
@@ -0,0 +1,296 @@
+/**
+ * @file device_bus.c
+ * @brief Memory-mapped device bus for the XM23P data memory
+ *
+ * Devices claim address ranges in data memory.  Each page containing a
+ * device register is marked in page_attributes, so the E1 stage only
+ * consults the bus for those pages and accesses plain memory otherwise.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-14
+ */
+
+#include "device_bus.h"
+
+/**
+ * @brief Select the byte lane of a word register for a read
+ *
+ * @param register_value Device register contents
+ * @param address Accessed address
+ * @param control Access type
+ * @return word_t Value returned to the CPU
+ */
+word_t read_lane(word_t register_value, word_t address, control_state_t control)
+{
+    if(control == READ_BYTE)
+    {
+        return (address & BYTE_LENGTH) ? (register_value >> 8) : (register_value & EIGHT_BITS);
+    }
+    return register_value;
+}
+
+/**
+ * @brief Merge a CPU write into the byte lane of a word register
+ *
+ * @param register_value Device register contents
+ * @param address Accessed address
+ * @param control Access type
+ * @param value Value written by the CPU
+ * @return word_t New register contents
+ */
+word_t write_lane(word_t register_value, word_t address, control_state_t control, word_t value)
+{
+    if(control == WRITE_BYTE)
+    {
+        if(address & BYTE_LENGTH)
+        {
+            return (register_value & 0x00FF) | ((value & EIGHT_BITS) << 8);
+        }
+        return (register_value & 0xFF00) | (value & EIGHT_BITS);
+    }
+    return value;
+}
+
+/**
+ * @brief Register a device on the data memory bus
+ *
+ * @param program Program context
+ * @param start_address First address decoded by the device
+ * @param end_address Last address decoded by the device
+ * @param access Register access handler
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int register_device(program_t *program, word_t start_address, word_t end_address, device_access_t access)
+{
+    if(program == NULL || access == NULL || end_address < start_address)
+    {
+        return -1;
+    }
+    if(program->device_count >= MAX_DEVICES)
+    {
+        /* Device table full */
+        return -2;
+    }
+    device_t *device = &program->devices[program->device_count++];
+    device->start_address = start_address;
+    device->end_address = end_address;
+    device->access = access;
+
+    /* Mark pages decoded by device */
+    for(int page = start_address >> PAGE_SHIFT; page <= end_address >> PAGE_SHIFT; page++)
+    {
+        program->page_attributes[page] = PAGE_DEVICE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reset the bus and register the standard peripherals
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int initialize_devices(program_t *program)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    memset(program->page_attributes, PAGE_RAM, sizeof(program->page_attributes));
+    memset(&program->timer, 0, sizeof(timer_device_t));
+    program->console.receive_pending = 0;
+    program->device_count = 0;
+    program->device_event_cycle = NO_EVENT;
+
+    int error_status = 0;
+    error_status |= register_device(program, CONSOLE_DATA_ADDRESS, CONSOLE_END_ADDRESS, console_access);
+    error_status |= register_device(program, TIMER_CONTROL_ADDRESS, TIMER_END_ADDRESS, timer_access);
+    error_status |= register_device(program, CYCLE_COUNTER_LOW_ADDRESS, CYCLE_COUNTER_END_ADDRESS, cycle_counter_access);
+    if(program->settings.multicore != NULL)
+    {
+        error_status |= register_device(program, INTERCORE_ID_ADDRESS, INTERCORE_END_ADDRESS, intercore_access);
+    }
+    return error_status;
+}
+
+/**
+ * @brief Perform the E1 memory access for an address in a device page
+ *
+ * @param program Program context
+ * @return int [0 = Device Access, 1 = Not Claimed - Use Memory, < 0 = FAILURE]
+ */
+int bus_access(program_t *program)
+{
+    word_t address = program->data_memory_address_register;
+    for(int i = 0; i < program->device_count; i++)
+    {
+        device_t *device = &program->devices[i];
+        if(address >= device->start_address && address <= device->end_address)
+        {
+            int error_status = device->access(program, address, program->data_control_register, &program->data_memory_buffer_register);
+            if(program->data_control_register == READ_BYTE || program->data_control_register == READ_WORD)
+            {
+                /* Write result to destination register */
+                program->register_file[REGISTER][program->previous_instruction.destination] = program->data_memory_buffer_register;
+            }
+            return error_status;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Advance devices with events due at the current clock cycle
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int update_devices(program_t *program)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    timer_device_t *timer = &program->timer;
+    if((timer->control & TIMER_ENABLE) && program->clock_cycles >= timer->deadline)
+    {
+        timer->control |= TIMER_EXPIRED;
+        if(timer->control & TIMER_INTERRUPT_ENABLE)
+        {
+            raise_interrupt(program, TIMER_VECTOR);
+        }
+        if(timer->period == 0)
+        {
+            /* One-shot */
+            timer->control &= ~TIMER_ENABLE;
+        }
+        else
+        {
+            timer->deadline += timer->period;
+        }
+    }
+    program->device_event_cycle = (timer->control & TIMER_ENABLE) ? timer->deadline : NO_EVENT;
+    update_event_cycle(program);
+    return 0;
+}
+
+/**
+ * @brief Console UART register access
+ *
+ * @param program Program context
+ * @param address Accessed address
+ * @param control Access type
+ * @param value Value read or written
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int console_access(program_t *program, word_t address, control_state_t control, word_t *value)
+{
+    switch(address & ~BYTE_LENGTH)
+    {
+    case CONSOLE_DATA_ADDRESS:
+        if(control == WRITE_BYTE || control == WRITE_WORD)
+        {
+            console_write(program, (byte_t)(*value & EIGHT_BITS));
+        }
+        else
+        {
+            *value = console_read(program);
+        }
+        break;
+    case CONSOLE_STATUS_ADDRESS:
+        if(control == READ_BYTE || control == READ_WORD)
+        {
+            *value = read_lane(CONSOLE_TX_READY | (console_receive_ready(program) ? CONSOLE_RX_READY : 0), address, control);
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Interval timer register access
+ *
+ * @param program Program context
+ * @param address Accessed address
+ * @param control Access type
+ * @param value Value read or written
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int timer_access(program_t *program, word_t address, control_state_t control, word_t *value)
+{
+    timer_device_t *timer = &program->timer;
+    int write = (control == WRITE_BYTE || control == WRITE_WORD);
+    switch(address & ~BYTE_LENGTH)
+    {
+    case TIMER_CONTROL_ADDRESS:
+        if(write)
+        {
+            word_t control_value = write_lane(timer->control, address, control, *value);
+            /* Start counting a full period when enabled */
+            if(!(timer->control & TIMER_ENABLE) && (control_value & TIMER_ENABLE))
+            {
+                timer->deadline = program->clock_cycles + timer->period;
+            }
+            timer->control = control_value;
+            program->device_event_cycle = (timer->control & TIMER_ENABLE) ? timer->deadline : NO_EVENT;
+            update_event_cycle(program);
+        }
+        else
+        {
+            *value = read_lane(timer->control, address, control);
+        }
+        break;
+    case TIMER_PERIOD_ADDRESS:
+        if(write)
+        {
+            timer->period = write_lane(timer->period, address, control, *value);
+        }
+        else
+        {
+            *value = read_lane(timer->period, address, control);
+        }
+        break;
+    case TIMER_COUNT_ADDRESS:
+        if(!write)
+        {
+            word_t count = (timer->control & TIMER_ENABLE) ? (word_t)(timer->deadline - program->clock_cycles) : 0;
+            *value = read_lane(count, address, control);
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Cycle counter register access - read only
+ *
+ * @param program Program context
+ * @param address Accessed address
+ * @param control Access type
+ * @param value Value read
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int cycle_counter_access(program_t *program, word_t address, control_state_t control, word_t *value)
+{
+    if(control == WRITE_BYTE || control == WRITE_WORD)
+    {
+        /* Writes Ignored */
+        return 0;
+    }
+    switch(address & ~BYTE_LENGTH)
+    {
+    case CYCLE_COUNTER_LOW_ADDRESS:
+        *value = read_lane((word_t)program->clock_cycles, address, control);
+        break;
+    case CYCLE_COUNTER_HIGH_ADDRESS:
+        *value = read_lane((word_t)((unsigned int)program->clock_cycles >> 16), address, control);
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
@@ -58,31 +58,37 @@ int convert_word_to_int(byte_t *word, int *integer)
  */
 int display_memory(byte_t *memory_array,  int min_address, int max_address)
 {
-    int error_status = 0;
+    static const char hex_digits[] = "0123456789abcdef";
+    char line[MAX_LINE_LENGTH];
     int location_counter = min_address;
 
     /* Valid Address Checking */
     if(max_address > DATA_MEMORY_LENGTH)
     {
-        error_status = -1;
+        return -1;
     }
 
     if(min_address < 0)
     {
-        error_status = -2;
+        return -2;
     }
 
-    /* Display Memory */
+    /* Display Memory - Each line built in buffer and written once */
     while(location_counter < max_address)
     {
-        printf("#%04x\t", location_counter);
-        for(int i = 0; i < BYTES_PER_LINE; i++)
+        int length = sprintf_s(line, MAX_LINE_LENGTH, "#%04x\t", location_counter);
+        /* Stop at max_address on final partial line */
+        for(int i = 0; i < BYTES_PER_LINE && location_counter + i < max_address; i++)
         {
-            printf("%02x ", memory_array[location_counter + i]);
+            byte_t byte = memory_array[location_counter + i];
+            line[length++] = hex_digits[byte >> 4];
+            line[length++] = hex_digits[byte & FOUR_BITS];
+            line[length++] = ' ';
         }
-        printf("\n");
+        line[length++] = '\n';
+        fwrite(line, 1, length, stdout);
         location_counter += BYTES_PER_LINE;
     }
 
-    return error_status;\
-}
\ No newline at end of file
+    return 0;
+}
@@ -24,7 +24,7 @@ char *instruction_names[NUM_OF_INSTRUCTIONS] =
     "SETPRI", "SVC", "SETCC", "CLRCC",
     "CEX", "LD", "ST", "MOVL",
     "MOVLZ", "MOVLS", "MOVH", "LDR",
-    "STR"
+    "STR", "SKIPPED", "CMP+BRANCH", "MOVL+MOVH"
 };
 
 /**
@@ -43,7 +43,8 @@ execute_instruction_t execute_table[NUM_OF_INSTRUCTIONS] =
     execute_setpri, execute_svc, execute_setcc, execute_clrcc,
     execute_cex, execute_ld, execute_st, execute_movl,
     execute_movlz, execute_movls, execute_movh, execute_ldr,
-    execute_str
+    execute_str, execute_skipped, execute_fused_cmp_branch,
+    execute_fused_move
 };
 
 /**
@@ -67,46 +68,71 @@ int execute_instruction(instruction_t *instruction, program_t *program, int stag
         /* Copy stage to program context for debug logging */
         if(program->debug_mode)
         {
-            sprintf_s(program->instruction_execute, MAX_STAGE_LENGTH, "E0: %04x", instruction->opcode);
+            sprintf_s(program->instruction_execute, MAX_STAGE_LENGTH, "E0: %04x", program->instruction_opcode);
         }
         execute_table[instruction->type](instruction, program);
+        /* Slots replaced at decode executed nothing */
+        if(program->settings.trace != NULL && !INSTRUCTION_REPLACED(instruction))
+        {
+            trace_execute(program, instruction);
+        }
         /* Copy instruction to previous instruction */
         program->previous_instruction = *instruction;
+        program->previous_opcode = program->instruction_opcode;
     }
     else if(stage == E1)
     {
-        if(program->previous_instruction.data_flag)
+        if(INSTRUCTION_DATA(&program->previous_instruction))
         {
-            /* Perform Memory Access */
-            switch(program->data_control_register)
+            program->statistics.memory_cycles++;
+            /* Device pages are decoded by the bus - plain memory otherwise */
+            if(program->page_attributes[program->data_memory_address_register >> PAGE_SHIFT] == PAGE_RAM
+                || bus_access(program) > 0)
+            {
+                if(program->settings.data_cache != NULL)
+                {
+                    /* Miss penalty stalls the pipeline */
+                    program->clock_cycles += cache_access(program->settings.data_cache, program->data_memory_address_register);
+                }
+                if(program->settings.data_profile != NULL)
+                {
+                    profile_access(program->settings.data_profile, program->data_memory_address_register,
+                        program->data_control_register >= WRITE_BYTE, program->previous_instruction.address, program->clock_cycles);
+                }
+                /* Perform Memory Access */
+                byte_t *data_memory = data_memory_of(program);
+                switch(program->data_control_register)
+                {
+                    case WRITE_BYTE:
+                        data_memory[program->data_memory_address_register] = program->data_memory_buffer_register & 0xFF;
+                        break;
+                    case WRITE_WORD:
+                        write_memory_word(data_memory, program->data_memory_address_register, program->data_memory_buffer_register);
+                        break;
+                    case READ_BYTE:
+                        /* Read Byte from Data Memory to Data Memory Buffer */
+                        program->data_memory_buffer_register = data_memory[program->data_memory_address_register];
+                        /* Write result to destination register */
+                        program->register_file[REGISTER][program->previous_instruction.destination] = program->data_memory_buffer_register;
+                        break;
+                    case READ_WORD:
+                        /* Read Word from Data Memory to Data Memory Buffer */
+                        program->data_memory_buffer_register = read_memory_word(data_memory, program->data_memory_address_register);
+                        /* Write result to destination register */
+                        program->register_file[REGISTER][program->previous_instruction.destination] = program->data_memory_buffer_register;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            if(program->settings.trace != NULL)
             {
-                case WRITE_BYTE:
-                    program->data_memory[program->data_memory_address_register] = program->data_memory_buffer_register & 0xFF;
-                    break;
-                case WRITE_WORD:
-                    program->data_memory[program->data_memory_address_register] = program->data_memory_buffer_register & 0xFF;
-                    program->data_memory[program->data_memory_address_register + BYTE_LENGTH] = (program->data_memory_buffer_register >> 8) & 0xFF;
-                    break;
-                case READ_BYTE:
-                    /* Read Byte from Data Memory to Data Memory Buffer */
-                    program->data_memory_buffer_register = program->data_memory[program->data_memory_address_register];
-                    /* Write result to destination register */
-                    program->register_file[REGISTER][program->previous_instruction.destination] = program->data_memory_buffer_register;
-                    break;
-                case READ_WORD:
-                    /* Read Word from Data Memory to Data Memory Buffer */
-                    program->data_memory_buffer_register = program->data_memory[program->data_memory_address_register];
-                    program->data_memory_buffer_register |= program->data_memory[program->data_memory_address_register + BYTE_LENGTH] << 8;
-                    /* Write result to destination register */
-                    program->register_file[REGISTER][program->previous_instruction.destination] = program->data_memory_buffer_register;
-                    break;
-                default:
-                    break;
+                trace_memory(program);
             }
             /* Copy stage to program context for debug logging */
             if(program->debug_mode)
             {
-                sprintf_s(program->instruction_execute, MAX_STAGE_LENGTH, "E1: %04x", program->previous_instruction.opcode);
+                sprintf_s(program->instruction_execute, MAX_STAGE_LENGTH, "E1: %04x", program->previous_opcode);
             }
         }
         /* Copy stage to program context for debug logging */
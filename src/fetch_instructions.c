@@ -36,8 +36,12 @@ int fetch_instruction(program_t *program, int stage)
     else if(stage == F1)
     {
         /* IMBR = IMEM[IMAR}] */
-        program->instruction_memory_buffer_register = program->instruction_memory[program->instruction_memory_address_register];
-        program->instruction_memory_buffer_register |= program->instruction_memory[program->instruction_memory_address_register + BYTE_LENGTH] << 8;
+        program->instruction_memory_buffer_register = read_memory_word(program->instruction_memory, program->instruction_memory_address_register);
+        if(program->settings.instruction_cache != NULL)
+        {
+            /* Miss penalty stalls the pipeline */
+            program->clock_cycles += cache_access(program->settings.instruction_cache, program->instruction_memory_address_register);
+        }
         /* IR = IMBR */
         program->instruction_register = program->instruction_memory_buffer_register;
         
@@ -0,0 +1,833 @@
+/**
+ * @file gdb_stub.c
+ * @brief GDB remote serial protocol stub
+ *
+ * Serves a single debugger connection on a local TCP port or Unix domain
+ * socket.  Registers R0 - R7 and the PSW are 16 bits, sent little endian.
+ * Instruction memory is mapped at 0x00000 and data memory at 0x10000.
+ * Memory is accessed directly - device registers are not decoded.
+ *
+ * Execution uses run_cycle(), stopping only at instruction boundaries with
+ * no queued bubbles so that PC always holds the next instruction to execute.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-20
+ */
+
+#include "gdb_stub.h"
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL     /* Closed connections return an error instead of SIGPIPE */
+#else
+#define SEND_FLAGS 0
+#endif
+
+#define IS_BREAKPOINT(stub, address) ((stub)->breakpoints[(address) >> 4] & (1 << (((address) >> 1) & 7)))
+
+/**
+ * @brief Target description - register names, sizes and order for g/G packets
+ *
+ */
+static const char target_description[] =
+    "<?xml version=\"1.0\"?>"
+    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+    "<target version=\"1.0\">"
+    "<feature name=\"org.xm23p.core\">"
+    "<reg name=\"r0\" bitsize=\"16\" type=\"int16\" regnum=\"0\"/>"
+    "<reg name=\"r1\" bitsize=\"16\" type=\"int16\"/>"
+    "<reg name=\"r2\" bitsize=\"16\" type=\"int16\"/>"
+    "<reg name=\"r3\" bitsize=\"16\" type=\"int16\"/>"
+    "<reg name=\"bp\" bitsize=\"16\" type=\"data_ptr\"/>"
+    "<reg name=\"lr\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "<reg name=\"sp\" bitsize=\"16\" type=\"data_ptr\"/>"
+    "<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+    "<reg name=\"psw\" bitsize=\"16\" type=\"int16\"/>"
+    "</feature>"
+    "</target>";
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/**
+ * @brief Convert a hex character to its value
+ *
+ * @param character Hex character
+ * @return int Value [0 - 15], < 0 = Not Hex
+ */
+static int hex_value(char character)
+{
+    if(character >= '0' && character <= '9')
+    {
+        return character - '0';
+    }
+    if(character >= 'a' && character <= 'f')
+    {
+        return character - 'a' + 10;
+    }
+    if(character >= 'A' && character <= 'F')
+    {
+        return character - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse hex digits, advancing past them
+ *
+ * @param position Pointer to parse position
+ * @param value Pointer to parsed value
+ * @return int [0 = SUCCESS, < 0 = No Digits]
+ */
+static int parse_hex(char **position, unsigned int *value)
+{
+    int digits = 0;
+    *value = 0;
+    while(hex_value(**position) >= 0)
+    {
+        *value = (*value << 4) | (unsigned int)hex_value(**position);
+        (*position)++;
+        digits++;
+    }
+    return digits > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Append a byte as two hex characters
+ *
+ * @param position Output position
+ * @param byte Byte to append
+ * @return char* Position after the appended characters
+ */
+static char *append_hex_byte(char *position, byte_t byte)
+{
+    *position++ = hex_digits[byte >> 4];
+    *position++ = hex_digits[byte & FOUR_BITS];
+    return position;
+}
+
+/**
+ * @brief Map a debugger address to emulator memory
+ *
+ * @param program Program context
+ * @param address Debugger address
+ * @return byte_t* Pointer to the byte, NULL if unmapped
+ */
+static byte_t *map_address(program_t *program, unsigned int address)
+{
+    if(address < INSTRUCTION_MEMORY_LENGTH)
+    {
+        return &program->instruction_memory[address];
+    }
+    if(address >= GDB_DATA_BASE && address < GDB_DATA_BASE + DATA_MEMORY_LENGTH)
+    {
+        return &program->data_memory[address - GDB_DATA_BASE];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Read a register in the target description order
+ *
+ * @param program Program context
+ * @param register_number [0 - 7 = R0 - R7, 8 = PSW]
+ * @return word_t Register value
+ */
+static word_t read_register(program_t *program, int register_number)
+{
+    if(register_number == GDB_PSW_REGISTER)
+    {
+        return program->program_status_word;
+    }
+    return program->register_file[REGISTER][register_number];
+}
+
+/**
+ * @brief Write a register in the target description order
+ *
+ * @param program Program context
+ * @param register_number [0 - 7 = R0 - R7, 8 = PSW]
+ * @param value Register value
+ */
+static void write_register(program_t *program, int register_number, word_t value)
+{
+    if(register_number == GDB_PSW_REGISTER)
+    {
+        program->program_status_word = value & PSW_DEFINED_MASK;
+        update_event_cycle(program);
+    }
+    else
+    {
+        program->register_file[REGISTER][register_number] = value;
+    }
+}
+
+/**
+ * @brief Receive a byte from the debugger
+ *
+ * @param stub Debugger connection
+ * @return int Byte received, < 0 = Connection Closed
+ */
+static int receive_byte(gdb_stub_t *stub)
+{
+    if(stub->receive_position == stub->receive_length)
+    {
+        int length = (int)recv(stub->connection, stub->receive_buffer, GDB_RECEIVE_LENGTH, 0);
+        if(length <= 0)
+        {
+            return -1;
+        }
+        stub->receive_length = length;
+        stub->receive_position = 0;
+    }
+    return (byte_t)stub->receive_buffer[stub->receive_position++];
+}
+
+/**
+ * @brief Check for received bytes without blocking
+ *
+ * @param stub Debugger connection
+ * @return int [1 = Available, 0 = None]
+ */
+static int receive_ready(gdb_stub_t *stub)
+{
+    if(stub->receive_position < stub->receive_length)
+    {
+        return 1;
+    }
+    fd_set read_set;
+    struct timeval timeout = {0, 0};
+    FD_ZERO(&read_set);
+    FD_SET(stub->connection, &read_set);
+    return select((int)stub->connection + 1, &read_set, NULL, NULL, &timeout) > 0;
+}
+
+/**
+ * @brief Send a buffer completely
+ *
+ * @param stub Debugger connection
+ * @param data Data to send
+ * @param length Number of bytes
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int send_all(gdb_stub_t *stub, const char *data, int length)
+{
+    while(length > 0)
+    {
+        int sent = (int)send(stub->connection, data, length, SEND_FLAGS);
+        if(sent <= 0)
+        {
+            return -1;
+        }
+        data += sent;
+        length -= sent;
+    }
+    return 0;
+}
+
+/**
+ * @brief Frame and send a packet, retransmitting until acknowledged
+ *
+ * @param stub Debugger connection
+ * @param data Packet data
+ * @param length Number of bytes of data
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int send_packet(gdb_stub_t *stub, const char *data, int length)
+{
+    if(length > GDB_PACKET_SIZE)
+    {
+        return -1;
+    }
+    byte_t checksum = 0;
+    char *position = stub->reply;
+    *position++ = '$';
+    for(int i = 0; i < length; i++)
+    {
+        checksum += (byte_t)data[i];
+        *position++ = data[i];
+    }
+    *position++ = '#';
+    position = append_hex_byte(position, checksum);
+
+    while(1)
+    {
+        if(send_all(stub, stub->reply, (int)(position - stub->reply)) != 0)
+        {
+            return -1;
+        }
+        if(!stub->acknowledge)
+        {
+            return 0;
+        }
+        int response = receive_byte(stub);
+        if(response == '+')
+        {
+            return 0;
+        }
+        if(response != '-')
+        {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Send a NUL terminated reply
+ *
+ * @param stub Debugger connection
+ * @param reply Reply text
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int send_reply(gdb_stub_t *stub, const char *reply)
+{
+    return send_packet(stub, reply, (int)strlen(reply));
+}
+
+/**
+ * @brief Receive a packet into stub->packet, NUL terminated
+ *
+ * @param stub Debugger connection
+ * @return int Packet length, < 0 = Connection Closed
+ */
+static int receive_packet(gdb_stub_t *stub)
+{
+    while(1)
+    {
+        /* Skip acknowledgements and interrupts received while stopped */
+        int character;
+        do
+        {
+            character = receive_byte(stub);
+            if(character < 0)
+            {
+                return -1;
+            }
+        } while(character != '$');
+
+        int length = 0;
+        byte_t checksum = 0;
+        while((character = receive_byte(stub)) != '#')
+        {
+            if(character < 0)
+            {
+                return -1;
+            }
+            if(length < GDB_PACKET_SIZE)
+            {
+                stub->packet[length++] = (char)character;
+            }
+            checksum += (byte_t)character;
+        }
+        int high = receive_byte(stub);
+        int low = receive_byte(stub);
+        if(high < 0 || low < 0)
+        {
+            return -1;
+        }
+        stub->packet[length] = NUL;
+
+        if(!stub->acknowledge)
+        {
+            return length;
+        }
+        if(hex_value((char)high) == (checksum >> 4) && hex_value((char)low) == (checksum & FOUR_BITS))
+        {
+            if(send_all(stub, "+", 1) != 0)
+            {
+                return -1;
+            }
+            return length;
+        }
+        /* Request Retransmission */
+        if(send_all(stub, "-", 1) != 0)
+        {
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Run until a breakpoint, a single step completes or the debugger interrupts
+ *
+ * @param stub Debugger connection
+ * @param program Program context
+ * @param step Stop after one instruction
+ * @return int Stop signal [GDB_SIGTRAP, GDB_SIGINT], < 0 = Connection Closed
+ */
+static int resume(gdb_stub_t *stub, program_t *program, int step)
+{
+    int boundaries = 0;
+    int poll_cycles = 0;
+    int signal = 0;
+    program->cycle_state = CYCLE_START;
+    while(1)
+    {
+        (void) run_cycle(program, NO_CYCLE_LIMIT);
+        /* Instruction boundary - E0 complete and the fetched instruction will be decoded */
+        if(program->cycle_state == CYCLE_WAIT_1 && pipeline_drained(program))
+        {
+            /* First boundary completes the NOOP that restarts the pipeline */
+            if(boundaries++ > 0)
+            {
+                word_t next_address = program->PROGRAM_COUNTER - WORD_LENGTH;
+                if(step || IS_BREAKPOINT(stub, next_address))
+                {
+                    signal = GDB_SIGTRAP;
+                }
+                if(signal != 0)
+                {
+                    /* Resume at the fetched instruction */
+                    program->PROGRAM_COUNTER = next_address;
+                    flush_console(program);
+                    return signal;
+                }
+            }
+        }
+
+        /* Check for Ctrl-C from the debugger */
+        if(++poll_cycles == GDB_POLL_CYCLES)
+        {
+            poll_cycles = 0;
+            while(signal == 0 && receive_ready(stub))
+            {
+                int character = receive_byte(stub);
+                if(character < 0)
+                {
+                    return -1;
+                }
+                if(character == GDB_INTERRUPT)
+                {
+                    /* Stop at the next boundary */
+                    signal = GDB_SIGINT;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reply to a query packet
+ *
+ * @param stub Debugger connection
+ * @param packet Query packet
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int handle_query(gdb_stub_t *stub, char *packet)
+{
+    char reply[64];
+    if(strncmp(packet, "qSupported", 10) == 0)
+    {
+        sprintf_s(reply, sizeof(reply), "PacketSize=%x;QStartNoAckMode+;qXfer:features:read+", GDB_PACKET_SIZE);
+        return send_reply(stub, reply);
+    }
+    if(strncmp(packet, "qXfer:features:read:target.xml:", 31) == 0)
+    {
+        char *position = packet + 31;
+        unsigned int offset;
+        unsigned int length;
+        if(parse_hex(&position, &offset) != 0 || *position++ != ',' || parse_hex(&position, &length) != 0)
+        {
+            return send_reply(stub, "E01");
+        }
+        unsigned int total = sizeof(target_description) - 1;
+        if(offset >= total)
+        {
+            return send_reply(stub, "l");
+        }
+        if(length > GDB_PACKET_SIZE - 1)
+        {
+            length = GDB_PACKET_SIZE - 1;
+        }
+        if(length > total - offset)
+        {
+            length = total - offset;
+        }
+        /* m = More Data, l = Last Chunk */
+        char *data = stub->packet;
+        data[0] = (offset + length < total) ? 'm' : 'l';
+        memcpy(data + 1, target_description + offset, length);
+        return send_packet(stub, data, (int)length + 1);
+    }
+    if(strcmp(packet, "qAttached") == 0)
+    {
+        return send_reply(stub, "1");
+    }
+    if(strcmp(packet, "qC") == 0)
+    {
+        return send_reply(stub, "QC1");
+    }
+    if(strcmp(packet, "qfThreadInfo") == 0)
+    {
+        return send_reply(stub, "m1");
+    }
+    if(strcmp(packet, "qsThreadInfo") == 0)
+    {
+        return send_reply(stub, "l");
+    }
+    /* Unsupported */
+    return send_reply(stub, "");
+}
+
+/**
+ * @brief Handle a received packet
+ *
+ * @param stub Debugger connection
+ * @param program Program context
+ * @param length Packet length
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int handle_packet(gdb_stub_t *stub, program_t *program, int length)
+{
+    char *packet = stub->packet;
+    char *position = packet + 1;
+    /* Replies are built over the parsed packet */
+    char *reply = packet;
+    char *output = reply;
+    unsigned int address;
+    unsigned int count;
+    unsigned int value;
+
+    switch(packet[0])
+    {
+    case '?':
+        return send_reply(stub, "S05");
+
+    case 'g':
+        for(int i = 0; i < GDB_REGISTER_COUNT; i++)
+        {
+            word_t register_value = read_register(program, i);
+            output = append_hex_byte(output, (byte_t)(register_value & EIGHT_BITS));
+            output = append_hex_byte(output, (byte_t)(register_value >> 8));
+        }
+        return send_packet(stub, reply, (int)(output - reply));
+
+    case 'G':
+        if(length != 1 + GDB_REGISTER_COUNT * 4)
+        {
+            return send_reply(stub, "E01");
+        }
+        for(int i = 0; i < GDB_REGISTER_COUNT; i++, position += 4)
+        {
+            int digits[4];
+            for(int j = 0; j < 4; j++)
+            {
+                digits[j] = hex_value(position[j]);
+                if(digits[j] < 0)
+                {
+                    return send_reply(stub, "E01");
+                }
+            }
+            write_register(program, i, (word_t)((digits[0] << 4) | digits[1] | (digits[2] << 12) | (digits[3] << 8)));
+        }
+        return send_reply(stub, "OK");
+
+    case 'p':
+        if(parse_hex(&position, &address) != 0 || address >= GDB_REGISTER_COUNT)
+        {
+            return send_reply(stub, "E01");
+        }
+        value = read_register(program, (int)address);
+        output = append_hex_byte(output, (byte_t)(value & EIGHT_BITS));
+        output = append_hex_byte(output, (byte_t)(value >> 8));
+        return send_packet(stub, reply, (int)(output - reply));
+
+    case 'P':
+        if(parse_hex(&position, &address) != 0 || address >= GDB_REGISTER_COUNT || *position++ != '='
+            || parse_hex(&position, &value) != 0)
+        {
+            return send_reply(stub, "E01");
+        }
+        /* Little endian register value */
+        write_register(program, (int)address, (word_t)(((value >> 8) & EIGHT_BITS) | ((value & EIGHT_BITS) << 8)));
+        return send_reply(stub, "OK");
+
+    case 'm':
+        if(parse_hex(&position, &address) != 0 || *position++ != ',' || parse_hex(&position, &count) != 0)
+        {
+            return send_reply(stub, "E01");
+        }
+        if(count > GDB_PACKET_SIZE / 2)
+        {
+            count = GDB_PACKET_SIZE / 2;
+        }
+        /* Reply with the readable prefix of the range */
+        for(unsigned int i = 0; i < count; i++)
+        {
+            byte_t *byte = map_address(program, address + i);
+            if(byte == NULL)
+            {
+                break;
+            }
+            output = append_hex_byte(output, *byte);
+        }
+        if(output == reply && count > 0)
+        {
+            return send_reply(stub, "E01");
+        }
+        return send_packet(stub, reply, (int)(output - reply));
+
+    case 'M':
+        if(parse_hex(&position, &address) != 0 || *position++ != ',' || parse_hex(&position, &count) != 0
+            || *position++ != ':' || (unsigned int)(length - (position - packet)) != count * 2)
+        {
+            return send_reply(stub, "E01");
+        }
+        for(unsigned int i = 0; i < count; i++, position += 2)
+        {
+            byte_t *byte = map_address(program, address + i);
+            int high = hex_value(position[0]);
+            int low = hex_value(position[1]);
+            if(byte == NULL || high < 0 || low < 0)
+            {
+                return send_reply(stub, "E01");
+            }
+            *byte = (byte_t)((high << 4) | low);
+        }
+        return send_reply(stub, "OK");
+
+    case 'X':
+        if(parse_hex(&position, &address) != 0 || *position++ != ',' || parse_hex(&position, &count) != 0
+            || *position++ != ':')
+        {
+            return send_reply(stub, "E01");
+        }
+        for(unsigned int i = 0; i < count; i++)
+        {
+            byte_t *byte = map_address(program, address + i);
+            if(byte == NULL || position >= packet + length)
+            {
+                return send_reply(stub, "E01");
+            }
+            /* Escaped bytes are XORed with 0x20 */
+            byte_t data = (byte_t)*position++;
+            if(data == GDB_ESCAPE && position < packet + length)
+            {
+                data = (byte_t)(*position++ ^ 0x20);
+            }
+            *byte = data;
+        }
+        return send_reply(stub, "OK");
+
+    case 'c':
+    case 's':
+    {
+        /* Optional resume address */
+        if(parse_hex(&position, &address) == 0)
+        {
+            program->PROGRAM_COUNTER = (word_t)address;
+        }
+        int signal = resume(stub, program, packet[0] == 's');
+        if(signal < 0)
+        {
+            return -1;
+        }
+        /* Signal numbers are one byte on the wire */
+        char stop_reply[12];
+        sprintf_s(stop_reply, sizeof(stop_reply), "S%02x", signal & 0xFF);
+        return send_reply(stub, stop_reply);
+    }
+
+    case 'Z':
+    case 'z':
+        /* Software and hardware breakpoints share the breakpoint map */
+        if((packet[1] != '0' && packet[1] != '1') || packet[2] != ',')
+        {
+            return send_reply(stub, "");
+        }
+        position = packet + 3;
+        if(parse_hex(&position, &address) != 0 || address >= INSTRUCTION_MEMORY_LENGTH)
+        {
+            return send_reply(stub, "E01");
+        }
+        if(packet[0] == 'Z')
+        {
+            stub->breakpoints[address >> 4] |= (byte_t)(1 << ((address >> 1) & 7));
+        }
+        else
+        {
+            stub->breakpoints[address >> 4] &= (byte_t)~(1 << ((address >> 1) & 7));
+        }
+        return send_reply(stub, "OK");
+
+    case 'H':
+        return send_reply(stub, "OK");
+
+    case 'D':
+        stub->attached = 0;
+        return send_reply(stub, "OK");
+
+    case 'k':
+        stub->attached = 0;
+        return 0;
+
+    case 'q':
+        return handle_query(stub, packet);
+
+    case 'Q':
+        if(strcmp(packet, "QStartNoAckMode") == 0)
+        {
+            int error_status = send_reply(stub, "OK");
+            stub->acknowledge = 0;
+            return error_status;
+        }
+        return send_reply(stub, "");
+
+    default:
+        /* Unsupported */
+        return send_reply(stub, "");
+    }
+}
+
+/**
+ * @brief Listen on a TCP port or Unix socket path and accept one debugger
+ *
+ * @param endpoint TCP port number, or Unix socket path
+ * @return socket_t Connected socket, INVALID_SOCKET = FAILURE
+ */
+static socket_t accept_debugger(char *endpoint)
+{
+    socket_t listener;
+    int is_port = (*endpoint != NUL);
+    for(char *character = endpoint; *character != NUL; character++)
+    {
+        is_port &= (isdigit((unsigned char)*character) != 0);
+    }
+
+    if(is_port)
+    {
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((unsigned short)atoi(endpoint));
+        /* Local connections only */
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if(listener == INVALID_SOCKET)
+        {
+            return INVALID_SOCKET;
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+        if(bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0)
+        {
+            close_socket(listener);
+            return INVALID_SOCKET;
+        }
+    }
+    else
+    {
+#ifdef WINDOWS
+        /* Unix sockets unavailable */
+        return INVALID_SOCKET;
+#else
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(strlen(endpoint) >= sizeof(address.sun_path))
+        {
+            return INVALID_SOCKET;
+        }
+        strcpy_s(address.sun_path, sizeof(address.sun_path), endpoint);
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listener == INVALID_SOCKET)
+        {
+            return INVALID_SOCKET;
+        }
+        (void) unlink(endpoint);
+        if(bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0)
+        {
+            close_socket(listener);
+            return INVALID_SOCKET;
+        }
+#endif
+    }
+
+    if(listen(listener, 1) != 0)
+    {
+        close_socket(listener);
+        return INVALID_SOCKET;
+    }
+    printf("Waiting for GDB on %s\n", endpoint);
+    fflush(stdout);
+    socket_t connection = accept(listener, NULL, NULL);
+    close_socket(listener);
+    if(connection != INVALID_SOCKET && is_port)
+    {
+        /* Replies are complete packets - send immediately */
+        int no_delay = 1;
+        setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, (const char *)&no_delay, sizeof(no_delay));
+    }
+    return connection;
+}
+
+/**
+ * @brief Serve a GDB remote protocol session until the debugger detaches
+ *
+ * @param program Program context
+ * @param endpoint TCP port number, or Unix socket path
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int run_gdb_stub(program_t *program, char *endpoint)
+{
+    if(program == NULL || endpoint == NULL)
+    {
+        return -1;
+    }
+#ifdef WINDOWS
+    WSADATA wsa_data;
+    if(WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+    {
+        return -1;
+    }
+#endif
+    gdb_stub_t *stub = calloc(1, sizeof(gdb_stub_t));
+    if(stub == NULL)
+    {
+        return -1;
+    }
+    stub->connection = accept_debugger(endpoint);
+    if(stub->connection == INVALID_SOCKET)
+    {
+        printf("Error Opening Debugger Connection\n");
+        free(stub);
+        return -2;
+    }
+    printf("Debugger Connected\n");
+    stub->acknowledge = 1;
+    stub->attached = 1;
+
+    /* Breakpoints are held by the stub */
+    int breakpoint = program->breakpoint;
+    program->breakpoint = NO_BREAKPOINT;
+    /* Stops may land on any instruction - pairs execute separately */
+    int fusion_disabled = program->settings.fusion_disabled;
+    program->settings.fusion_disabled = 1;
+    int error_status = 0;
+    while(stub->attached)
+    {
+        int length = receive_packet(stub);
+        if(length < 0)
+        {
+            break;
+        }
+        error_status = handle_packet(stub, program, length);
+        if(error_status < 0)
+        {
+            break;
+        }
+    }
+    program->breakpoint = breakpoint;
+    program->settings.fusion_disabled = fusion_disabled;
+    printf("Debugger Disconnected\n");
+
+    close_socket(stub->connection);
+    free(stub);
+#ifdef WINDOWS
+    WSACleanup();
+#else
+    if(!isdigit((unsigned char)*endpoint))
+    {
+        (void) unlink(endpoint);
+    }
+#endif
+    return error_status;
+}
@@ -9,21 +9,15 @@
 #include "definitions.h"
 
 /**
- * @brief Insert bubble/no_bubble into bubble queue
+ * @brief Append a predicate mask to the bubble queue
  * @param bubble_queue Pointer to the bubble queue
- * @param value 1 for bubble, 0 for no_bubble
+ * @param skip_mask 1 bits skip the matching decode, first decode in bit 0
+ * @param length Number of decodes covered by the mask
  */
-void insert_bubble(bubble_queue_t *bubble_queue, int value)
+void predicate_pipeline(bubble_queue_t *bubble_queue, unsigned int skip_mask, int length)
 {
-    if(value)
-    {
-        bubble_queue->bubble_flag |= (1 << bubble_queue->size);
-    }
-    else
-    {
-        bubble_queue->bubble_flag &= ~(1 << bubble_queue->size);
-    }
-    bubble_queue->size++;
+    bubble_queue->skip_mask |= skip_mask << bubble_queue->size;
+    bubble_queue->size += length;
 }
 
 /**
@@ -33,8 +27,8 @@ void insert_bubble(bubble_queue_t *bubble_queue, int value)
  */
 int remove_bubble(bubble_queue_t *bubble_queue)
 {
-    int value = (bubble_queue->bubble_flag & 1);
-    bubble_queue->bubble_flag >>= 1;
+    int value = (bubble_queue->skip_mask & 1);
+    bubble_queue->skip_mask >>= 1;
     bubble_queue->size--;
     return value;
 }
@@ -45,6 +39,30 @@ int remove_bubble(bubble_queue_t *bubble_queue)
  */
 void clear_bubble_queue(bubble_queue_t *bubble_queue)
 {
-    bubble_queue->bubble_flag = 0;
+    bubble_queue->skip_mask = 0;
     bubble_queue->size = 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Flush the pipeline - the fetched instruction is replaced with a bubble
+ * @param program Pointer to the program context
+ * @param cause Reason for the flush
+ * @param source_address Address of the instruction causing the flush
+ */
+void flush_pipeline(program_t *program, bubble_cause_t cause, word_t source_address)
+{
+    program->bubble_queue.skip_mask = BUBBLE;
+    program->bubble_queue.size = 1;
+    program->bubble_queue.cause = cause;
+    program->bubble_queue.source_address = source_address;
+}
+
+/**
+ * @brief Check the next decode starts a new instruction - no bubbles queued and no fused pair in progress
+ * @param program Pointer to the program context
+ * @return int [1 = Drained, 0 = Pending]
+ */
+int pipeline_drained(program_t *program)
+{
+    return program->bubble_queue.size == 0 && !program->fusion_pending;
+}
@@ -18,70 +18,65 @@ control_state_t control_table[READ_WRITE][WORD_BYTE] =
     {WRITE_WORD,    WRITE_BYTE}
 };
 
+/* Condition truth over the 32 combinations of C (bit 0), Z, N, SLP and V (bit 4) */
+#define CARRY_SET       0xAAAAAAAAu
+#define ZERO_SET        0xCCCCCCCCu
+#define NEGATIVE_SET    0xF0F0F0F0u
+#define OVERFLOW_SET    0xFFFF0000u
+
+/**
+ * @brief Condition truth table - bit n of each entry is the result for PSW flags n
+ * 
+ */
+static const unsigned int condition_table[FALSE_ALWAYS + 1] =
+{
+    ZERO_SET,                                   /* Z = 1 */
+    ~ZERO_SET,                                  /* Z = 0 */
+    CARRY_SET,                                  /* C = 1 */
+    ~CARRY_SET,                                 /* C = 0 */
+    NEGATIVE_SET,                               /* N = 1 */
+    ~NEGATIVE_SET,                              /* N = 0 */
+    OVERFLOW_SET,                               /* V = 1 */
+    ~OVERFLOW_SET,                              /* V = 0 */
+    CARRY_SET & ~ZERO_SET,                      /* C = 1 & Z = 0 */
+    ~CARRY_SET | ZERO_SET,                      /* C = 0 | Z = 1 */
+    ~(NEGATIVE_SET ^ OVERFLOW_SET),             /* N == V */
+    NEGATIVE_SET ^ OVERFLOW_SET,                /* N != V */
+    ~(NEGATIVE_SET ^ OVERFLOW_SET) & ~ZERO_SET, /* (N == V) & Z = 0 */
+    (NEGATIVE_SET ^ OVERFLOW_SET) | ZERO_SET,   /* (N != V) | Z = 1 */
+    0xFFFFFFFFu,                                /* Always True */
+    0x00000000u                                 /* Always False */
+};
+
 /**
  * @brief Decode Condition Code and Return Result
  * @param condition_code Condition Code
  * @param program_status_word Program Status Word
  * @return int [0|1]
  */
-int check_condition(condition_code_t condition_code, status_register_t program_status_word)
+int check_condition(condition_code_t condition_code, word_t program_status_word)
 {
-    switch(condition_code)
-    {
-        /* Z = 1 */
-        case EQUAL:
-            return program_status_word.zero;
-        /* Z = 0 */
-        case NOT_EQUAL:
-            return !program_status_word.zero;
-        /* C = 1 */
-        case CARRY:
-            return program_status_word.carry;
-        /* C = 0 */
-        case NOT_CARRY:
-            return !program_status_word.carry;
-        /* N = 1 */
-        case NEGATIVE:
-            return program_status_word.negative;
-        /* N = 0 */
-        case NOT_NEGATIVE:
-            return !program_status_word.negative;
-        /* V = 1 */
-        case OVERFLOW:
-            return program_status_word.overflow;
-        /* V = 0 */
-        case NOT_OVERFLOW:
-            return !program_status_word.overflow;
-        /* C = 1 & Z = 0 */
-        case UNSIGNED_GREATER:
-            return !program_status_word.zero && program_status_word.carry;
-        /* C = 0 | Z = 1 */
-        case UNSIGNED_LESS_EQUAL:
-            return program_status_word.zero || !program_status_word.carry;
-        /* N == V */
-        case SIGNED_GREATER_EQUAL:
-            return (program_status_word.negative == program_status_word.overflow);
-        /* N != V*/
-        case SIGNED_LESS:
-            return (program_status_word.negative != program_status_word.overflow);
-        /* (N == V) & Z = 0 */
-        case SIGNED_GREATER:
-            return !program_status_word.zero && (program_status_word.negative == program_status_word.overflow);
-        /* (N != V) | Z = 1 */
-        case SIGNED_LESS_EQUAL:
-            return program_status_word.zero || (program_status_word.negative != program_status_word.overflow);
-        /* Always True */
-        case TRUE_ALWAYS:
-            return 1;
-        /* Always False */
-        case FALSE_ALWAYS:
-            return 0;
-        default:
-            return -1;
-    }
+    return (condition_table[condition_code & FOUR_BITS] >> (program_status_word & PSW_CONDITION_MASK)) & ONE_BIT;
 }
- 
- /**
+
+/**
+ * @brief Set Carry, Zero, Negative and Overflow in one update
+ * 
+ * @param program Program context
+ * @param carry Carry Flag
+ * @param zero Zero Flag
+ * @param negative Negative Flag
+ * @param overflow Overflow Flag
+ */
+static void set_arithmetic_status(program_t *program, int carry, int zero, int negative, int overflow)
+{
+    program->program_status_word = (word_t)((program->program_status_word
+        & ~((ONE_BIT << PSW_CARRY_BIT) | (ONE_BIT << PSW_ZERO_BIT) | (ONE_BIT << PSW_NEGATIVE_BIT) | (ONE_BIT << PSW_OVERFLOW_BIT)))
+        | ((carry != 0) << PSW_CARRY_BIT) | ((zero != 0) << PSW_ZERO_BIT)
+        | ((negative != 0) << PSW_NEGATIVE_BIT) | ((overflow != 0) << PSW_OVERFLOW_BIT));
+}
+
+/**
   * @brief Restore Branch Offset
   * @param offset Encoded offset
   * @param number_of_bits Number of bits in offset
@@ -128,12 +123,10 @@ void branch(program_t *program, signed short offset)
 #endif
     if(offset != 0x0000)
     {
+        /* Flush Pipeline - Bubble attributed to the branch */
+        flush_pipeline(program, BUBBLE_BRANCH, program->PROGRAM_COUNTER - 2 * WORD_LENGTH);
         /* Set PC to Effective Address */
         program->PROGRAM_COUNTER = effective_address;
-        /* Clear Bubble Queue */
-        clear_bubble_queue(&program->bubble_queue);
-        /* Insert Bubble */
-        insert_bubble(&program->bubble_queue, 1);
     }
 }
 
@@ -171,11 +164,79 @@ int execute_undefined(instruction_t *instruction, program_t *program)
     instruction;
     program;
 #ifdef DEBUG
-    printf("%04x:\t%04x - Undefined Instruction\n", instruction->address, instruction->opcode);
+    printf("%04x:\t%04x - Undefined Instruction\n", instruction->address, program->instruction_opcode);
 #endif
     return -1;
 }
 
+/**
+ * @brief Report a branch outcome to the prediction model, then branch if taken
+ * 
+ * @param instruction 
+ * @param program 
+ * @param taken Branch condition met
+ * @return int [0 = Branch Taken, 1 = Branch not taken]
+ */
+static int conditional_branch(instruction_t *instruction, program_t *program, int taken)
+{
+    signed short offset = restore_offset(BRANCH_OFFSET(instruction), BRANCH_OFFSET_LENGTH);
+    if(offset != 0x0000)
+    {
+        /* Offset 0 continues in sequence - never flushes */
+        predict_branch(program, instruction->address, program->PROGRAM_COUNTER - WORD_LENGTH + offset,
+            instruction->type != BRA, taken);
+    }
+    if(!taken)
+    {
+        return 1;
+    }
+    branch(program, offset);
+
+    return 0;
+}
+
+/**
+ * @brief Instruction dropped by CEX or a flush - occupies its pipeline slot only
+ * 
+ * @param instruction 
+ * @param program 
+ * @return int [0 = success]
+ */
+int execute_skipped(instruction_t *instruction, program_t *program)
+{
+    (void) instruction;
+    (void) program;
+    return 0;
+}
+
+/**
+ * @brief CMP followed by a conditional branch, fused at decode
+ * 
+ * @param instruction 
+ * @param program 
+ * @return int [0 = Branch Taken, 1 = Branch not taken]
+ */
+int execute_fused_cmp_branch(instruction_t *instruction, program_t *program)
+{
+    execute_cmp(instruction, program);
+    return conditional_branch(instruction, program, check_condition((condition_code_t)FUSED_CONDITION(instruction), program->program_status_word));
+}
+
+/**
+ * @brief MOVL, MOVLZ or MOVLS followed by MOVH of the same register, fused at decode
+ * 
+ * @param instruction 
+ * @param program 
+ * @return int [0 = success]
+ */
+int execute_fused_move(instruction_t *instruction, program_t *program)
+{
+    /* MOVH replaces the high byte any of the low byte moves set */
+    program->register_file[REGISTER][instruction->destination] = (word_t)((instruction->argument << 8) | instruction->source);
+
+    return 0;
+}
+
 /**
  * @brief Branch with Link Instruction
  * 
@@ -185,13 +246,16 @@ int execute_undefined(instruction_t *instruction, program_t *program)
  */
 int execute_bl(instruction_t *instruction, program_t *program)
 {
-    if(instruction->offset != 0x0000)
+    if(instruction->argument != 0x0000)
     {
     /* Set Link Register to First Instruction after Branch */
     program->LINK_REGISTER = program->PROGRAM_COUNTER - WORD_LENGTH;
+    /* BL +0 is the pipeline NOOP - not a branch site */
+    predict_branch(program, instruction->address,
+        program->PROGRAM_COUNTER - WORD_LENGTH + restore_offset(instruction->argument, LINK_OFFSET_LENGTH), 0, 1);
     }
     /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, LINK_OFFSET_LENGTH));
+    branch(program, restore_offset(instruction->argument, LINK_OFFSET_LENGTH));
 
     return 0;
 }
@@ -205,16 +269,8 @@ int execute_bl(instruction_t *instruction, program_t *program)
  */
 int execute_beq(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(EQUAL, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(EQUAL, program->program_status_word));
 }
 
 /**
@@ -226,16 +282,8 @@ int execute_beq(instruction_t *instruction, program_t *program)
  */
 int execute_bne(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(NOT_EQUAL, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(NOT_EQUAL, program->program_status_word));
 }
 
 /**
@@ -247,16 +295,8 @@ int execute_bne(instruction_t *instruction, program_t *program)
  */
 int execute_bc(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(CARRY, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(CARRY, program->program_status_word));
 }
 
 /**
@@ -268,16 +308,8 @@ int execute_bc(instruction_t *instruction, program_t *program)
  */
 int execute_bnc(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(NOT_CARRY, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(NOT_CARRY, program->program_status_word));
 }
 
 /**
@@ -289,16 +321,8 @@ int execute_bnc(instruction_t *instruction, program_t *program)
  */
 int execute_bn(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(NEGATIVE, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(NEGATIVE, program->program_status_word));
 }
 
 /**
@@ -310,16 +334,8 @@ int execute_bn(instruction_t *instruction, program_t *program)
  */
 int execute_bge(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(SIGNED_GREATER_EQUAL, program->program_status_word))
-    {
-        return 1;
-    }
-
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(SIGNED_GREATER_EQUAL, program->program_status_word));
 }
 
 /**
@@ -331,16 +347,8 @@ int execute_bge(instruction_t *instruction, program_t *program)
  */
 int execute_blt(instruction_t *instruction, program_t *program)
 {
-    /* If condition not met, return 1 */
-    if(!check_condition(SIGNED_LESS, program->program_status_word))
-    {
-        return 1;
-    }
-    
-    /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
-
-    return 0;
+    /* Branch to Offset if condition met */
+    return conditional_branch(instruction, program, check_condition(SIGNED_LESS, program->program_status_word));
 }
 
 /**
@@ -353,7 +361,7 @@ int execute_blt(instruction_t *instruction, program_t *program)
 int execute_bra(instruction_t *instruction, program_t *program)
 {
     /* Branch to Offset */
-    branch(program, restore_offset(instruction->offset, BRANCH_OFFSET_LENGTH));
+    conditional_branch(instruction, program, 1);
 
     return 0;
 }
@@ -367,22 +375,23 @@ int execute_bra(instruction_t *instruction, program_t *program)
  */
 int execute_add(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     word_t destination = program->register_file[REGISTER][instruction->destination];
     int result;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         result = source + destination;
          program->register_file[REGISTER][instruction->destination] = (word_t)result;
         
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFFFF); /* Test Result exceeds word */
-        program->program_status_word.zero = ((short)result == 0); /* Test Low Word for Zero */
-        program->program_status_word.negative = (word_t)((result >> 15) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFFFF), /* Test Result exceeds word */
+            ((short)result == 0), /* Test Low Word for Zero */
+            (word_t)((result >> 15) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         source &= 0x00FF;
         destination &= 0x00FF;
@@ -394,10 +403,11 @@ int execute_add(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= (word_t)(result & EIGHT_BITS);
 
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFF); /* Test Result exceeds byte */
-        program->program_status_word.zero = ((byte_t)result == 0); /* Test Low Byte for Zero */
-        program->program_status_word.negative = (word_t)((result >> 7) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFF), /* Test Result exceeds byte */
+            ((byte_t)result == 0), /* Test Low Byte for Zero */
+            (word_t)((result >> 7) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
 
     return 0;
@@ -412,26 +422,27 @@ int execute_add(instruction_t *instruction, program_t *program)
  */
 int execute_addc(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     word_t destination = program->register_file[REGISTER][instruction->destination];
     int result;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
-        result = source + destination + program->program_status_word.carry;
+        result = source + destination + PSW_BIT(program->program_status_word, PSW_CARRY_BIT);
          program->register_file[REGISTER][instruction->destination] = (word_t)result;
         
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFFFF); /* Test Result exceeds word */
-        program->program_status_word.zero = ((short)result == 0); /* Test Low Word for Zero */
-        program->program_status_word.negative = (word_t)((result >> 15) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFFFF), /* Test Result exceeds word */
+            ((short)result == 0), /* Test Low Word for Zero */
+            (word_t)((result >> 15) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         source &= 0x00FF;
         destination &= 0x00FF;
-        result = source + destination + program->program_status_word.carry;
+        result = source + destination + PSW_BIT(program->program_status_word, PSW_CARRY_BIT);
         
         /* Clear Low Byte of Destination */
         program->register_file[REGISTER][instruction->destination] &= 0xFF00;
@@ -439,10 +450,11 @@ int execute_addc(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= (word_t)(result & EIGHT_BITS);
 
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFF); /* Test Result exceeds byte */
-        program->program_status_word.zero = ((byte_t)result == 0); /* Test Low Byte for Zero */
-        program->program_status_word.negative = (word_t)((result >> 7) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFF), /* Test Result exceeds byte */
+            ((byte_t)result == 0), /* Test Low Byte for Zero */
+            (word_t)((result >> 7) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
 
     return 0;
@@ -457,24 +469,25 @@ int execute_addc(instruction_t *instruction, program_t *program)
  */
 int execute_sub(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     /* 2's Compliment Source */
     source = ~source + 1;
     word_t destination = program->register_file[REGISTER][instruction->destination];
     int result;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         result = source + destination;
          program->register_file[REGISTER][instruction->destination] = (word_t)result;
         
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFFFF); /* Test Result exceeds word */
-        program->program_status_word.zero = ((short)result == 0); /* Test Low Word for Zero */
-        program->program_status_word.negative = (word_t)((result >> 15) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFFFF), /* Test Result exceeds word */
+            ((short)result == 0), /* Test Low Word for Zero */
+            (word_t)((result >> 15) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         source &= 0x00FF;
         destination &= 0x00FF;
@@ -486,10 +499,11 @@ int execute_sub(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= (word_t)(result & EIGHT_BITS);
 
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFF); /* Test Result exceeds byte */
-        program->program_status_word.zero = ((byte_t)result == 0); /* Test Low Byte for Zero */
-        program->program_status_word.negative = (word_t)((result >> 7) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFF), /* Test Result exceeds byte */
+            ((byte_t)result == 0), /* Test Low Byte for Zero */
+            (word_t)((result >> 7) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
 
     return 0;
@@ -504,25 +518,26 @@ int execute_sub(instruction_t *instruction, program_t *program)
  */
 int execute_subc(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     /* 1's Compliment Source */
     source = ~source;
     word_t destination = program->register_file[REGISTER][instruction->destination];
-    word_t carry = program->program_status_word.carry;
+    word_t carry = PSW_BIT(program->program_status_word, PSW_CARRY_BIT);
     int result;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         result = source + destination + carry;
         program->register_file[REGISTER][instruction->destination] = (word_t)result;
         
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFFFF); /* Test Result exceeds word */
-        program->program_status_word.zero = ((short)result == 0); /* Test Low Word for Zero */
-        program->program_status_word.negative = (word_t)((result >> 15) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFFFF), /* Test Result exceeds word */
+            ((short)result == 0), /* Test Low Word for Zero */
+            (word_t)((result >> 15) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         source &= 0x00FF;
         destination &= 0x00FF;
@@ -534,10 +549,11 @@ int execute_subc(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= (word_t)(result & EIGHT_BITS);
 
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFF); /* Test Result exceeds byte */
-        program->program_status_word.zero = ((byte_t)result == 0); /* Test Low Byte for Zero */
-        program->program_status_word.negative = (word_t)((result >> 7) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFF), /* Test Result exceeds byte */
+            ((byte_t)result == 0), /* Test Low Byte for Zero */
+            (word_t)((result >> 7) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
 
     return 0;
@@ -552,96 +568,29 @@ int execute_subc(instruction_t *instruction, program_t *program)
  */
 int execute_dadd(instruction_t *instruction, program_t *program)
 {
-    /* Refactor to use a loop */
-    word_t source = program->register_file[instruction->rc][instruction->source];
-    word_t destination = program->register_file[REGISTER][instruction->destination];
-
-    byte_t source_digit = source & 0x000F;
-    byte_t destination_digit = destination & 0x000F;
-    word_t sum = 0x0000;
-    word_t result = 0x0000;
-
-    /* Add 1's Digits */
-    result = source_digit + destination_digit + program->program_status_word.carry;
-    if(result > 0x0009)
-    {
-        result -= 0x000A;
-        program->program_status_word.carry = 1;
-    }
-    else
-    {
-        program->program_status_word.carry = 0;
-    }
-    
-    sum |= result;
-    /* Add 10's Digits */
-    source_digit = (source >> 4) & 0x000F;
-    destination_digit = (destination >> 4) & 0x000F;
-    result = source_digit + destination_digit + program->program_status_word.carry;
-    if(result > 0x0009)
-    {
-        result -= 0x000A;
-        program->program_status_word.carry = 1;
-    }
-    else
-    {
-        program->program_status_word.carry = 0;
-    }
-    
-    sum |= result << 4;
-
-    if(instruction->wb == 0) /* Word Operation */
-    {    
-        /* Add 100's Digits */
-        source_digit = (source >> 8) & 0x000F;
-        destination_digit = (destination >> 8) & 0x000F;
-        result = source_digit + destination_digit + program->program_status_word.carry;
-        if(result > 0x0009)
-        {
-            result -= 0x000A;
-            program->program_status_word.carry = 1;
-        }
-        else
-        {
-            program->program_status_word.carry = 0;
-        }
-        
-        sum |= result << 8;
-        /* Add 1000's Digits */
-        source_digit = (source >> 12) & 0x000F;
-        destination_digit = (destination >> 12) & 0x000F;
-        result = source_digit + destination_digit + program->program_status_word.carry;
-        if(result > 0x0009)
-        {
-            result -= 0x000A;
-            program->program_status_word.carry = 1;
-        }
-        else
-        {
-            program->program_status_word.carry = 0;
-        }
-        
-        sum |= result << 12;
-
-        /* Set Destination */
-        program->register_file[REGISTER][instruction->destination] = sum;
-
-        /* Test for Zero */
-        program->program_status_word.zero = (sum == 0);
-    }
-    else if(instruction->wb == 1) /* Byte Operation */
-    {
-        /* Clear Low Byte of Destination */
-        program->register_file[REGISTER][instruction->destination] &= 0xFF00;
-        /* Set Low Byte of Destination */
-        program->register_file[REGISTER][instruction->destination] |= (sum & 0x00FF);
-        /* Test for Zero */
-        program->program_status_word.zero = ((sum & 0x00FF) == 0);
-    }
-    /* Clear Negative */
-    program->program_status_word.negative = 0;
-    /* Clear Overflow */
-    program->program_status_word.overflow = 0;
+    /* Byte operations add the low two digits, word operations all four */
+    unsigned int digit_mask = INSTRUCTION_WB(instruction) ? 0x00FF : 0xFFFF;
+    /* Carry out of each digit lands on bit 4, 8, 12 or 16 */
+    unsigned int carry_bits = INSTRUCTION_WB(instruction) ? 0x00110 : 0x11110;
+    unsigned int source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source] & digit_mask;
+    unsigned int destination = program->register_file[REGISTER][instruction->destination] & digit_mask;
+
+    /* Bias every digit by 6 so a decimal carry is a binary carry out of the nibble */
+    unsigned int biased = source + (0x6666 & digit_mask);
+    unsigned int sum = biased + destination + PSW_BIT(program->program_status_word, PSW_CARRY_BIT);
+    /* Carry into each bit of the sum */
+    unsigned int carries = sum ^ biased ^ destination;
+    /* Remove the bias from digits that did not carry */
+    unsigned int no_carry = ~carries & carry_bits;
+    sum -= (no_carry >> 2) | (no_carry >> 3);
+    sum &= digit_mask;
+
+    /* Set Destination - the high byte is kept by byte operations */
+    program->register_file[REGISTER][instruction->destination] &= (word_t)~digit_mask;
+    program->register_file[REGISTER][instruction->destination] |= (word_t)sum;
+
+    /* Carry out of the top digit, Zero from the digits written, Negative and Overflow clear */
+    set_arithmetic_status(program, (carries & (digit_mask + 1)) != 0, sum == 0, 0, 0);
 
     return 0;
 }
@@ -655,33 +604,35 @@ int execute_dadd(instruction_t *instruction, program_t *program)
  */
 int execute_cmp(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     /* 2's Compliment Source */
     source = ~source + 1;
     word_t destination = program->register_file[REGISTER][instruction->destination];
     int result;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         result = source + destination;
         
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFFFF); /* Test Result exceeds word */
-        program->program_status_word.zero = ((short)result == 0); /* Test Low Word for Zero */
-        program->program_status_word.negative = (word_t)((result >> 15) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFFFF), /* Test Result exceeds word */
+            ((short)result == 0), /* Test Low Word for Zero */
+            (word_t)((result >> 15) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         source &= 0x00FF;
         destination &= 0x00FF;
         result = source + destination;
 
         /* Test for PSW Flags */
-        program->program_status_word.carry = (result > 0xFF); /* Test Result exceeds byte */
-        program->program_status_word.zero = ((byte_t)result == 0); /* Test Low Byte for Zero */
-        program->program_status_word.negative = (word_t)((result >> 7) & 0x01); /* Test MSb */
-        program->program_status_word.overflow = test_overflow(source, destination, (word_t)result, instruction->wb); /* Test for incorrectly flipped sign */
+        set_arithmetic_status(program,
+            (result > 0xFF), /* Test Result exceeds byte */
+            ((byte_t)result == 0), /* Test Low Byte for Zero */
+            (word_t)((result >> 7) & 0x01), /* Test MSb */
+            test_overflow(source, destination, (word_t)result, INSTRUCTION_WB(instruction))); /* Test for incorrectly flipped sign */
     }
 
     return 0;
@@ -696,20 +647,19 @@ int execute_cmp(instruction_t *instruction, program_t *program)
  */
 int execute_xor(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         /* DST = DST OR SRC */
         program->register_file[REGISTER][instruction->destination] ^= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] == 0));
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] == 0)));
         /* Test MSb */
-        program->program_status_word.negative = 
-            (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01));
     } 
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -717,10 +667,9 @@ int execute_xor(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] ^= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0));
         /* Test MSb */
-        program->program_status_word.negative =
-            (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01));
     }
     
     return 0;
@@ -735,20 +684,19 @@ int execute_xor(instruction_t *instruction, program_t *program)
  */
 int execute_and(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         /* DST = DST AND SRC */
         program->register_file[REGISTER][instruction->destination] &= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] == 0));
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] == 0)));
         /* Test MSb */
-        program->program_status_word.negative = 
-            (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01));
     } 
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -757,10 +705,9 @@ int execute_and(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] &= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0));
         /* Test MSb */
-        program->program_status_word.negative =
-            (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01));
     }
     
     return 0;
@@ -775,20 +722,19 @@ int execute_and(instruction_t *instruction, program_t *program)
  */
 int execute_or(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         /* DST = DST OR SRC */
         program->register_file[REGISTER][instruction->destination] |= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] == 0));
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] == 0)));
         /* Test MSb */
-        program->program_status_word.negative = 
-            (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01));
     } 
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -796,10 +742,9 @@ int execute_or(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= source;
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0));
         /* Test MSb */
-        program->program_status_word.negative =
-            (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01));
     }
     
     return 0;
@@ -814,10 +759,10 @@ int execute_or(instruction_t *instruction, program_t *program)
  */
 int execute_bit(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
     word_t destination = program->register_file[REGISTER][instruction->destination];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         if(source > 15 || source < 0)
         {
@@ -826,9 +771,9 @@ int execute_bit(instruction_t *instruction, program_t *program)
         }
 
         /* Test if Bit is Set */
-        program->program_status_word.zero = ((destination & (1 << source)) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((destination & (1 << source)) == 0));
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -840,7 +785,7 @@ int execute_bit(instruction_t *instruction, program_t *program)
         }
 
         /* Test if Bit is Set */
-        program->program_status_word.zero = ((destination & (1 << source)) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((destination & (1 << source)) == 0));
     }
     return 0;
 }
@@ -854,9 +799,9 @@ int execute_bit(instruction_t *instruction, program_t *program)
  */
 int execute_bic(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         if(source > 15 || source < 0)
         {
@@ -868,13 +813,12 @@ int execute_bic(instruction_t *instruction, program_t *program)
             ~(1 << program->register_file[REGISTER][instruction->source]);
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] == 0));
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] == 0)));
         /* Test MSb */
-        program->program_status_word.negative = 
-        (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01));
 
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -889,10 +833,9 @@ int execute_bic(instruction_t *instruction, program_t *program)
             ~(1 << program->register_file[REGISTER][instruction->source]);
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0));
         /* Test MSb */
-        program->program_status_word.negative =
-            (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01));
     }
 
     return 0;
@@ -907,9 +850,9 @@ int execute_bic(instruction_t *instruction, program_t *program)
  */
 int execute_bis(instruction_t *instruction, program_t *program)
 {
-    word_t source = program->register_file[instruction->rc][instruction->source];
+    word_t source = program->register_file[INSTRUCTION_RC(instruction)][instruction->source];
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         if(source > 15 || source < 0)
         {
@@ -922,13 +865,12 @@ int execute_bis(instruction_t *instruction, program_t *program)
             (1 << program->register_file[REGISTER][instruction->source]);
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] == 0));
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] == 0)));
         /* Test MSb */
-        program->program_status_word.negative = 
-        (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (word_t)((program->register_file[REGISTER][instruction->destination] >> 15) & 0x01));
 
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Clear MSB of Source */
         source &= 0x00FF;
@@ -944,10 +886,9 @@ int execute_bis(instruction_t *instruction, program_t *program)
             (1 << program->register_file[REGISTER][instruction->source]);
 
         /* Test Zero */
-        program->program_status_word.zero = ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, ((program->register_file[REGISTER][instruction->destination] & 0x00FF) == 0));
         /* Test MSb */
-        program->program_status_word.negative =
-            (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01);
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (byte_t)((program->register_file[REGISTER][instruction->destination] >> 7) & 0x01));
     }
 
     return 0;
@@ -962,13 +903,13 @@ int execute_bis(instruction_t *instruction, program_t *program)
  */
 int execute_mov(instruction_t *instruction, program_t *program)
 {
-    if(instruction->wb == 0)/* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0)/* Word Operation */
     {
         /* DST = SRC */
         program->register_file[REGISTER][instruction->destination] = 
             program->register_file[REGISTER][instruction->source];
     }
-    else if(instruction->wb == 1)/* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1)/* Byte Operation */
     {
         /* Clear DST LSB */
         program->register_file[REGISTER][instruction->destination] &= 0xFF00;
@@ -978,8 +919,7 @@ int execute_mov(instruction_t *instruction, program_t *program)
     }
     if(instruction->destination == PC)
         {
-            clear_bubble_queue(&program->bubble_queue);
-            insert_bubble(&program->bubble_queue, BUBBLE);
+            flush_pipeline(program, BUBBLE_REGISTER_PC, instruction->address);
         }
     return 0;
 }
@@ -1004,8 +944,7 @@ int execute_swap(instruction_t *instruction, program_t *program)
 
     if(instruction->destination == PC)
         {
-            clear_bubble_queue(&program->bubble_queue);
-            insert_bubble(&program->bubble_queue, BUBBLE);
+            flush_pipeline(program, BUBBLE_REGISTER_PC, instruction->address);
         }
 
     return 0;
@@ -1020,7 +959,7 @@ int execute_swap(instruction_t *instruction, program_t *program)
  */
 int execute_sra(instruction_t *instruction, program_t *program)
 {
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         short temp = program->register_file[REGISTER][instruction->destination];
         /* Arithmetic Shift Right */
@@ -1028,11 +967,11 @@ int execute_sra(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] = (word_t)temp;
 
         /* Test Zero */
-        program->program_status_word.zero = (temp == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, (temp == 0));
         /* Test MSb */
-        program->program_status_word.negative = (temp >> 15) & 0x01;
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (temp >> 15) & 0x01);
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         signed char temp = (signed char)program->register_file[REGISTER][instruction->destination];
         /* Arithmetic Shift Right */
@@ -1043,9 +982,9 @@ int execute_sra(instruction_t *instruction, program_t *program)
         program->register_file[REGISTER][instruction->destination] |= (word_t)(temp & 0x00FF);
 
         /* Test Zero */
-        program->program_status_word.zero = (temp == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, (temp == 0));
         /* Test MSb */
-        program->program_status_word.negative = (temp >> 7) & 0x01;
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (temp >> 7) & 0x01);
     } 
     
     return 0;
@@ -1063,22 +1002,21 @@ int execute_rrc(instruction_t *instruction, program_t *program)
     /* Save LSb */
     byte_t new_carry = program->register_file[REGISTER][instruction->destination] & 0x0001;
 
-    if(instruction->wb == 0) /* Word Operation */
+    if(INSTRUCTION_WB(instruction) == 0) /* Word Operation */
     {
         /* Arithmetic Shift Right */
         program->register_file[REGISTER][instruction->destination] >>= 1;
         /* Set MSb */
-        program->register_file[REGISTER][instruction->destination] |= (program->program_status_word.carry << 15);
+        program->register_file[REGISTER][instruction->destination] |= (PSW_BIT(program->program_status_word, PSW_CARRY_BIT) << 15);
         
         /* Set Carry */
-        program->program_status_word.carry = new_carry;
+        SET_PSW_BIT(program->program_status_word, PSW_CARRY_BIT, new_carry);
         /* Test Zero */
-        program->program_status_word.zero = (program->register_file[REGISTER][instruction->destination] == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, (program->register_file[REGISTER][instruction->destination] == 0));
         /* Test MSb */
-        program->program_status_word.negative = 
-            (program->register_file[REGISTER][instruction->destination] >> 15) & 0x01;
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
     }
-    else if(instruction->wb == 1) /* Byte Operation */
+    else if(INSTRUCTION_WB(instruction) == 1) /* Byte Operation */
     {
         /* Save LSB */
         byte_t temp = program->register_file[REGISTER][instruction->destination] & 0x00FF;
@@ -1087,16 +1025,16 @@ int execute_rrc(instruction_t *instruction, program_t *program)
         /* Arithmetic Shift Right */
         temp >>= 1;
         /* Set MSb */
-        program->register_file[REGISTER][instruction->destination] |= (program->program_status_word.carry << 7);
+        program->register_file[REGISTER][instruction->destination] |= (PSW_BIT(program->program_status_word, PSW_CARRY_BIT) << 7);
         /* set LSB */
         program->register_file[REGISTER][instruction->destination] |= (temp & 0x00FF);
         
         /* Set Carry */
-        program->program_status_word.carry = new_carry;
+        SET_PSW_BIT(program->program_status_word, PSW_CARRY_BIT, new_carry);
         /* Test Zero */
-        program->program_status_word.zero = (temp == 0);
+        SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, (temp == 0));
         /* Test MSb */
-        program->program_status_word.negative = (temp >> 7) & 0x01;
+        SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (temp >> 7) & 0x01);
     } 
     
     return 0;
@@ -1145,10 +1083,9 @@ int execute_sxt(instruction_t *instruction, program_t *program)
     }
 
     /* Test Zero */
-    program->program_status_word.zero = (program->register_file[REGISTER][instruction->destination] == 0);
+    SET_PSW_BIT(program->program_status_word, PSW_ZERO_BIT, (program->register_file[REGISTER][instruction->destination] == 0));
     /* Test MSb */
-    program->program_status_word.negative = 
-        (program->register_file[REGISTER][instruction->destination] >> 15) & 0x01;
+    SET_PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT, (program->register_file[REGISTER][instruction->destination] >> 15) & 0x01);
 
     return 0;
 }
@@ -1158,14 +1095,15 @@ int execute_sxt(instruction_t *instruction, program_t *program)
  * 
  * @param instruction 
  * @param program 
- * @return int 
+ * @return int [0 = success, <= 0 failure]
  */
 int execute_setpri(instruction_t *instruction, program_t *program)
 {
-    instruction;
-    program;
-    //printf("%04x\tSet Priority\n", instruction->address);
-    return -1;
+    /* Set Current Priority */
+    SET_PSW_PRIORITY(program->program_status_word, PSW_CURRENT_PRIORITY_BIT, SETPRI_PRIORITY(instruction));
+    /* Lower priority may unmask pending interrupts */
+    update_event_cycle(program);
+    return 0;
 }
 
 /**
@@ -1173,14 +1111,12 @@ int execute_setpri(instruction_t *instruction, program_t *program)
  * 
  * @param instruction 
  * @param program 
- * @return int 
+ * @return int [0 = success, <= 0 failure]
  */
 int execute_svc(instruction_t *instruction, program_t *program)
 {
-    instruction;
-    program;
-    //printf("%04x\tSoftware Interrupt\n", instruction->address);
-    return -1;
+    /* Return to First Instruction after SVC */
+    return enter_exception(program, SVC_ADDRESS(instruction), program->PROGRAM_COUNTER - WORD_LENGTH);
 }
 
 /**
@@ -1192,11 +1128,8 @@ int execute_svc(instruction_t *instruction, program_t *program)
  */
 int execute_setcc(instruction_t *instruction, program_t *program)
 {
-    program->program_status_word.negative |= instruction->status.negative;
-    program->program_status_word.zero |= instruction->status.zero;
-    program->program_status_word.overflow |= instruction->status.overflow;
-    program->program_status_word.sleep |= instruction->status.sleep;
-    program->program_status_word.carry |= instruction->status.carry;
+    /* V, SLP, N, Z, C share the PSW bit positions */
+    program->program_status_word |= instruction->argument & PSW_CONDITION_MASK;
     return 0;
 }
 
@@ -1209,11 +1142,8 @@ int execute_setcc(instruction_t *instruction, program_t *program)
  */
 int execute_clrcc(instruction_t *instruction, program_t *program)
 {
-    program->program_status_word.negative &= ~(instruction->status.negative);
-    program->program_status_word.zero &= ~(instruction->status.zero);
-    program->program_status_word.overflow &= ~(instruction->status.overflow);
-    program->program_status_word.sleep &= ~(instruction->status.sleep);
-    program->program_status_word.carry &= ~(instruction->status.carry);
+    /* V, SLP, N, Z, C share the PSW bit positions */
+    program->program_status_word &= ~(instruction->argument & PSW_CONDITION_MASK);
     return 0;
 }
 
@@ -1226,32 +1156,15 @@ int execute_clrcc(instruction_t *instruction, program_t *program)
  */
 int execute_cex(instruction_t *instruction, program_t *program)
 {
-    if(check_condition(instruction->condition_code, program->program_status_word))
-    {
-        /* Execute True, Skip False*/
-        /* Add True_Count No_Bubbles then False_Count Bubbles to bubble queue */
-        for(int i = 0; i < instruction->t_count; i++)
-        {
-            insert_bubble(&program->bubble_queue, NO_BUBBLE);
-        }
-        for(int i = 0; i < instruction->f_count; i++)
-        {
-            insert_bubble(&program->bubble_queue, BUBBLE);
-        }
-    }
-    else
-    {
-        /* Skip True, Execute False */
-        /* Add False_Count No_Bubbles then True_Count Bubbles to bubble queue */
-        for(int i = 0; i < instruction->t_count; i++)
-        {
-            insert_bubble(&program->bubble_queue, BUBBLE);
-        }
-        for(int i = 0; i < instruction->f_count; i++)
-        {
-            insert_bubble(&program->bubble_queue, NO_BUBBLE);
-        }
-    }
+    /* True block in the low bits, false block above it */
+    unsigned int true_mask = (1u << CEX_TRUE_COUNT(instruction)) - 1;
+    unsigned int false_mask = ((1u << CEX_FALSE_COUNT(instruction)) - 1) << CEX_TRUE_COUNT(instruction);
+    /* Condition decides once which block decode drops */
+    predicate_pipeline(&program->bubble_queue,
+        check_condition((condition_code_t)CEX_CONDITION(instruction), program->program_status_word) ? false_mask : true_mask,
+        CEX_TRUE_COUNT(instruction) + CEX_FALSE_COUNT(instruction));
+    program->bubble_queue.cause = BUBBLE_CEX;
+    program->bubble_queue.source_address = instruction->address;
     
     return 0;
 }
@@ -1266,15 +1179,15 @@ int execute_cex(instruction_t *instruction, program_t *program)
 int execute_ld(instruction_t *instruction, program_t *program)
 {
 
-    word_t increment_size = 2 - instruction->wb;
+    word_t increment_size = 2 - INSTRUCTION_WB(instruction);
     /* Handle Pre Inc/Dec */
-    if(instruction->prpo == PRE)
+    if(INSTRUCTION_PRPO(instruction) == PRE)
     {
-        if(instruction->increment == 1)
+        if(INSTRUCTION_INCREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->source]+=increment_size;
         }
-        else if(instruction->decrement == 1)
+        else if(INSTRUCTION_DECREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->source]-=increment_size;
         }
@@ -1282,21 +1195,21 @@ int execute_ld(instruction_t *instruction, program_t *program)
     /* Copy Memory Source Address to DMAR */
     program->data_memory_address_register = program->register_file[REGISTER][instruction->source];
     /* Handle Pose Inc/Dec */
-    if(instruction->prpo == POST)
+    if(INSTRUCTION_PRPO(instruction) == POST)
     {
-        if(instruction->increment == 1)
+        if(INSTRUCTION_INCREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->source]+=increment_size;
         }
-        else if(instruction->decrement == 1)
+        else if(INSTRUCTION_DECREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->source]-=increment_size;
         }
     }
     /* Set DCTRL to Read */
-    program->data_control_register = control_table[READ][instruction->wb];
+    program->data_control_register = control_table[READ][INSTRUCTION_WB(instruction)];
     /* Set Data Flag*/
-    instruction->data_flag = 1;
+    instruction->flags |= OPERAND_DATA;
 
     return 0;
 }
@@ -1310,15 +1223,15 @@ int execute_ld(instruction_t *instruction, program_t *program)
  */
 int execute_st(instruction_t *instruction, program_t *program)
 {
-    word_t increment_size = 2 - instruction->wb;
+    word_t increment_size = 2 - INSTRUCTION_WB(instruction);
     /* Handle Pre Inc/Dec */
-    if(instruction->prpo == PRE)
+    if(INSTRUCTION_PRPO(instruction) == PRE)
     {
-        if(instruction->increment == 1)
+        if(INSTRUCTION_INCREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->destination]+=increment_size;
         }
-        else if(instruction->decrement == 1)
+        else if(INSTRUCTION_DECREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->destination]-=increment_size;
         }
@@ -1328,21 +1241,21 @@ int execute_st(instruction_t *instruction, program_t *program)
     /* Copy Source Data to Data Memory Buffer */
     program->data_memory_buffer_register = program->register_file[REGISTER][instruction->source];
     /* Handle Pose Inc/Dec */
-    if(instruction->prpo == POST)
+    if(INSTRUCTION_PRPO(instruction) == POST)
     {
-        if(instruction->increment == 1)
+        if(INSTRUCTION_INCREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->destination]-=increment_size;
         }
-        else if(instruction->decrement == 1)
+        else if(INSTRUCTION_DECREMENT(instruction) == 1)
         {
             program->register_file[REGISTER][instruction->destination]-=increment_size;
         }
     }
     /* Set DCTRL to Write */
-    program->data_control_register = control_table[WRITE][instruction->wb];
+    program->data_control_register = control_table[WRITE][INSTRUCTION_WB(instruction)];
     /* Set Data Flag*/
-    instruction->data_flag = 1;
+    instruction->flags |= OPERAND_DATA;
 
     return 0;
 }
@@ -1426,15 +1339,15 @@ int execute_movh(instruction_t *instruction, program_t *program)
 int execute_ldr(instruction_t *instruction, program_t *program)
 {
     /* Sign Extend Offset */
-    signed short offset = (signed short)((signed char)(instruction->offset << 1) >> 1);
+    signed short offset = (signed short)((signed char)(instruction->argument << 1) >> 1);
     /* Calculate Effective Address */
     word_t effective_address = program->register_file[REGISTER][instruction->source] + offset;
     /* Copy Memory Source Address to DMAR */
     program->data_memory_address_register = effective_address;
     /* Set DCTRL to Read */
-    program->data_control_register = control_table[READ][instruction->wb];
+    program->data_control_register = control_table[READ][INSTRUCTION_WB(instruction)];
     /* Set Data Flag*/
-    instruction->data_flag = 1;
+    instruction->flags |= OPERAND_DATA;
 
     return 0;
 }
@@ -1449,7 +1362,7 @@ int execute_ldr(instruction_t *instruction, program_t *program)
 int execute_str(instruction_t *instruction, program_t *program)
 {
     /* Sign Extend Offset */
-    signed short offset = (signed short)((signed char)(instruction->offset << 1) >> 1);
+    signed short offset = (signed short)((signed char)(instruction->argument << 1) >> 1);
     /* Calculate Effective Address */
     word_t effective_address = program->register_file[REGISTER][instruction->destination] + offset;
     /* Copy Memory Source Address to DMAR */
@@ -1457,9 +1370,9 @@ int execute_str(instruction_t *instruction, program_t *program)
     /* Copy Source Data to Data Memory Buffer */
     program->data_memory_buffer_register = program->register_file[REGISTER][instruction->source];
     /* Set DCTRL to Read */
-    program->data_control_register = control_table[WRITE][instruction->wb];
+    program->data_control_register = control_table[WRITE][INSTRUCTION_WB(instruction)];
     /* Set Data Flag*/
-    instruction->data_flag = 1;
+    instruction->flags |= OPERAND_DATA;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+/**
+ * @file interrupts.c
+ * @brief Priority based interrupt and exception model for the XM23P
+ *
+ * Interrupts are vectored through a table at the top of data memory.  Each
+ * vector holds the PSW and PC loaded on entry to its handler.  Entry pushes
+ * PC, LR and PSW to the stack and loads LR with the return address #FFFF,
+ * loading PC with #FFFF then pulls PSW, LR and PC to return.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-12
+ */
+
+#include "interrupts.h"
+
+/**
+ * @brief Push a word onto the stack - SP is pre-decremented
+ *
+ * @param program Program context
+ * @param value Word to push
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int push_word(program_t *program, word_t value)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+    program->STACK_POINTER -= WORD_LENGTH;
+    write_memory_word(data_memory_of(program), program->STACK_POINTER, value);
+    return 0;
+}
+
+/**
+ * @brief Pull a word from the stack - SP is post-incremented
+ *
+ * @param program Program context
+ * @param value Pointer to destination word
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int pull_word(program_t *program, word_t *value)
+{
+    if(program == NULL || value == NULL)
+    {
+        return -1;
+    }
+    *value = read_memory_word(data_memory_of(program), program->STACK_POINTER);
+    program->STACK_POINTER += WORD_LENGTH;
+    return 0;
+}
+
+/**
+ * @brief Mark an interrupt vector as pending - serviced at the next instruction boundary
+ *
+ * @param program Program context
+ * @param vector Vector number [0 - 15]
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int raise_interrupt(program_t *program, int vector)
+{
+    if(program == NULL || vector < 0 || vector >= VECTOR_COUNT)
+    {
+        return -1;
+    }
+    program->pending_interrupts |= (word_t)(1 << vector);
+    /* Service at next instruction boundary */
+    program->next_event_cycle = 0;
+    return 0;
+}
+
+/**
+ * @brief Enter an exception handler through the vector table
+ *
+ * Pushes PC, LR and PSW, then loads PSW and PC from the vector.
+ * The pipeline is flushed as for a taken branch.
+ *
+ * @param program Program context
+ * @param vector Vector number [0 - 15]
+ * @param return_address Address of the first instruction to execute on return
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int enter_exception(program_t *program, int vector, word_t return_address)
+{
+    if(program == NULL || vector < 0 || vector >= VECTOR_COUNT)
+    {
+        return -1;
+    }
+    word_t vector_address = VECTOR_TABLE_ADDRESS + vector * VECTOR_LENGTH;
+    word_t vector_psw = read_memory_word(data_memory_of(program), vector_address);
+    word_t vector_pc = read_memory_word(data_memory_of(program), vector_address + WORD_LENGTH);
+    byte_t current_priority = PSW_PRIORITY(program->program_status_word, PSW_CURRENT_PRIORITY_BIT);
+
+    /* Save Context */
+    push_word(program, return_address);
+    push_word(program, program->LINK_REGISTER);
+    push_word(program, program->program_status_word);
+
+    /* Load Handler Context */
+    program->program_status_word = vector_psw & PSW_DEFINED_MASK;
+    SET_PSW_PRIORITY(program->program_status_word, PSW_PREVIOUS_PRIORITY_BIT, current_priority);
+    program->LINK_REGISTER = EXCEPTION_RETURN_ADDRESS;
+    program->PROGRAM_COUNTER = vector_pc;
+#ifdef DEBUG
+    printf("Exception Vector %d from %04x to %04x\n", vector, return_address, vector_pc);
+#endif
+    /* Flush Pipeline */
+    flush_pipeline(program, BUBBLE_EXCEPTION, return_address);
+
+    program->exception_depth++;
+    update_event_cycle(program);
+    return 0;
+}
+
+/**
+ * @brief Return from an exception handler by pulling PSW, LR and PC
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int return_from_exception(program_t *program)
+{
+    if(program == NULL || program->exception_depth <= 0)
+    {
+        return -1;
+    }
+    word_t program_status_word;
+    pull_word(program, &program_status_word);
+    pull_word(program, &program->LINK_REGISTER);
+    pull_word(program, &program->PROGRAM_COUNTER);
+    program->program_status_word = program_status_word & PSW_DEFINED_MASK;
+#ifdef DEBUG
+    printf("Exception Return to %04x\n", program->PROGRAM_COUNTER);
+#endif
+    /* Flush Pipeline */
+    flush_pipeline(program, BUBBLE_EXCEPTION, EXCEPTION_RETURN_ADDRESS);
+
+    program->exception_depth--;
+    update_event_cycle(program);
+    return 0;
+}
+
+/**
+ * @brief Service pending interrupts and handler returns at an instruction boundary
+ *
+ * Called from the run loop only when clock_cycles reaches next_event_cycle.
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int service_events(program_t *program)
+{
+    if(program == NULL)
+    {
+        return -1;
+    }
+
+    /* Advance devices with events due */
+    if(program->clock_cycles >= program->device_event_cycle)
+    {
+        update_devices(program);
+    }
+
+    /* Handler loaded PC with the return address */
+    if(program->exception_depth > 0 && program->PROGRAM_COUNTER == EXCEPTION_RETURN_ADDRESS)
+    {
+        return return_from_exception(program);
+    }
+
+    /* Defer interrupts until queued bubbles and fused pairs have drained */
+    if(program->pending_interrupts != 0 && pipeline_drained(program))
+    {
+        int selected_vector = -1;
+        int selected_priority = PSW_PRIORITY(program->program_status_word, PSW_CURRENT_PRIORITY_BIT);
+        for(int vector = 0; vector < VECTOR_COUNT; vector++)
+        {
+            if(program->pending_interrupts & (1 << vector))
+            {
+                /* Priority is held in the vector's PSW */
+                word_t vector_address = VECTOR_TABLE_ADDRESS + vector * VECTOR_LENGTH;
+                int priority = (data_memory_of(program)[vector_address] >> PSW_CURRENT_PRIORITY_BIT) & THREE_BITS;
+                if(priority > selected_priority)
+                {
+                    selected_vector = vector;
+                    selected_priority = priority;
+                }
+            }
+        }
+        if(selected_vector >= 0)
+        {
+            program->pending_interrupts &= (word_t)~(1 << selected_vector);
+            /* Instruction in IR has not been decoded - resume at its address */
+            word_t return_address = program->PROGRAM_COUNTER;
+            if(program->cycle_state != CYCLE_START)
+            {
+                return_address -= WORD_LENGTH;
+            }
+            return enter_exception(program, selected_vector, return_address);
+        }
+    }
+    update_event_cycle(program);
+    return 0;
+}
+
+/**
+ * @brief Recalculate the cycle at which events must next be serviced
+ *
+ * @param program Program context
+ */
+void update_event_cycle(program_t *program)
+{
+    if(program->pending_interrupts != 0 || program->exception_depth > 0)
+    {
+        /* Check at every instruction boundary */
+        program->next_event_cycle = 0;
+    }
+    else
+    {
+        /* Next device event, or NO_EVENT */
+        program->next_event_cycle = program->device_event_cycle;
+    }
+}
+
+/**
+ * @brief Clear pending interrupts and active handlers
+ *
+ * @param program Program context
+ */
+void reset_interrupts(program_t *program)
+{
+    program->pending_interrupts = 0;
+    program->exception_depth = 0;
+    update_event_cycle(program);
+}
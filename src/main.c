@@ -11,21 +11,241 @@
 /* Program context */
 program_t program;
 
+/**
+ * @brief Write pending output and close the files and logs held by the session
+ * 
+ * @param program Program context
+ */
+static void shutdown_program(program_t *program)
+{
+    close_console(program);
+    close_metrics(program);
+    close_input_log(program);
+    set_console_input(program, NULL);
+    close_trace(program);
+}
+
 /**
  * @brief XM23P CPU Emulator Entry Point
  * 
  * @param argc Number of entrypoint arguments
- * @param argv Entrypoint arguments - argv[0] = executable name, argv[1] = file path
+ * @param argv Entrypoint arguments - argv[0] = executable name, argv[1] = file path,
+ * -s <script> runs a command script instead of the utilities prompt (- for stdin),
+ * -g <port|socket path> serves a GDB remote protocol session,
+ * -d <socket path> runs the daemon serving warm contexts,
+ * -m <file|port|unix:socket path> exports run metrics, -mf prometheus|json selects their format,
+ * -mi <seconds> sets the export interval while running (0 = at exit only),
+ * -ci <file> feeds the console device receiver (- for stdin),
+ * -rr <log> records console input with its clock cycle, -rp <log> replays a recorded log in place of the input,
+ * -t <trace> writes a compressed execution trace for trace_query,
+ * -cfg <dot file> builds the static control flow graph on load and writes it as DOT,
+ * -mc <cores> <cycles> runs the program on cores sharing data memory for a number of clock cycles,
+ * -mq <cycles> sets the cycles between core synchronizations, -md runs the cores in turn for repeatable runs,
+ * -b <lanes> <instructions> runs instances of the program in lockstep for a number of instructions each,
+ * -bs <sweep> sets the initial registers and data of each instance, -bb <address> stops each instance at a breakpoint
  * @return Exit Status - [0 = success, 1 = failure]
  */
 int main(int argc, char **argv)
 {
+    char *program_path = NULL;
+    char *script_path = NULL;
+    char *gdb_endpoint = NULL;
+    char *server_path = NULL;
+    char *metrics_destination = NULL;
+    char *metrics_format = NULL;
+    double metrics_interval = METRICS_DEFAULT_INTERVAL;
+    char *console_input = NULL;
+    char *input_log = NULL;
+    replay_mode_t replay_mode = REPLAY_RECORD;
+    char *trace_path = NULL;
+    char *control_flow_path = NULL;
+    int core_count = 0;
+    int core_cycles = 0;
+    int quantum = DEFAULT_QUANTUM;
+    int deterministic = 0;
+    int lane_count = 0;
+    int lane_instructions = 0;
+    char *sweep_path = NULL;
+    int lane_breakpoint = NO_BREAKPOINT;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], SCRIPT_OPTION) == 0 && i + 1 < argc)
+        {
+            script_path = argv[++i];
+        }
+        else if(strcmp(argv[i], GDB_OPTION) == 0 && i + 1 < argc)
+        {
+            gdb_endpoint = argv[++i];
+        }
+        else if(strcmp(argv[i], SERVER_OPTION) == 0 && i + 1 < argc)
+        {
+            server_path = argv[++i];
+        }
+        else if(strcmp(argv[i], METRICS_OPTION) == 0 && i + 1 < argc)
+        {
+            metrics_destination = argv[++i];
+        }
+        else if(strcmp(argv[i], METRICS_FORMAT_OPTION) == 0 && i + 1 < argc)
+        {
+            metrics_format = argv[++i];
+        }
+        else if(strcmp(argv[i], METRICS_INTERVAL_OPTION) == 0 && i + 1 < argc)
+        {
+            metrics_interval = atof(argv[++i]);
+        }
+        else if(strcmp(argv[i], CONSOLE_INPUT_OPTION) == 0 && i + 1 < argc)
+        {
+            console_input = argv[++i];
+        }
+        else if((strcmp(argv[i], RECORD_OPTION) == 0 || strcmp(argv[i], REPLAY_OPTION) == 0) && i + 1 < argc)
+        {
+            replay_mode = (strcmp(argv[i], RECORD_OPTION) == 0) ? REPLAY_RECORD : REPLAY_PLAYBACK;
+            input_log = argv[++i];
+        }
+        else if(strcmp(argv[i], TRACE_OPTION) == 0 && i + 1 < argc)
+        {
+            trace_path = argv[++i];
+        }
+        else if(strcmp(argv[i], CONTROL_FLOW_OPTION) == 0 && i + 1 < argc)
+        {
+            control_flow_path = argv[++i];
+        }
+        else if(strcmp(argv[i], MULTICORE_OPTION) == 0 && i + 2 < argc)
+        {
+            core_count = atoi(argv[++i]);
+            core_cycles = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], QUANTUM_OPTION) == 0 && i + 1 < argc)
+        {
+            quantum = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], DETERMINISTIC_OPTION) == 0)
+        {
+            deterministic = 1;
+        }
+        else if(strcmp(argv[i], BATCH_OPTION) == 0 && i + 2 < argc)
+        {
+            lane_count = atoi(argv[++i]);
+            lane_instructions = atoi(argv[++i]);
+        }
+        else if(strcmp(argv[i], SWEEP_OPTION) == 0 && i + 1 < argc)
+        {
+            sweep_path = argv[++i];
+        }
+        else if(strcmp(argv[i], BATCH_BREAKPOINT_OPTION) == 0 && i + 1 < argc)
+        {
+            lane_breakpoint = (int)strtol(argv[++i], NULL, 16);
+        }
+        else if(program_path == NULL)
+        {
+            program_path = argv[i];
+        }
+    }
+
+    /* Daemon contexts are loaded by request */
+    if(server_path != NULL)
+    {
+        return (run_server(server_path) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Metrics cover the load supplied to the executable */
+    if(metrics_destination != NULL && set_metrics(&program, metrics_destination, metrics_format, metrics_interval) != 0)
+    {
+        printf("Invalid Metrics Option\n");
+        return EXIT_FAILURE;
+    }
+
+    if(console_input != NULL && set_console_input(&program, console_input) != 0)
+    {
+        printf("Invalid Console Input\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Inputs are logged from the first clock cycle */
+    if(input_log != NULL && open_input_log(&program, input_log, replay_mode) != 0)
+    {
+        printf("Invalid Input Log\n");
+        return EXIT_FAILURE;
+    }
+
+    if(trace_path != NULL && open_trace(&program, trace_path) != 0)
+    {
+        printf("Invalid Trace File\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Graph is built by the load */
+    if(control_flow_path != NULL && set_control_flow(&program, control_flow_path) != 0)
+    {
+        printf("Invalid Control Flow Option\n");
+        return EXIT_FAILURE;
+    }
+
+    /* Inter-core device is registered by the load */
+    if(core_count != 0 && set_multicore(&program, core_count, core_cycles, quantum, deterministic) != 0)
+    {
+        printf("Invalid Multi-Core Option\n");
+        return EXIT_FAILURE;
+    }
     /* Automatically load file supplied to executable */
-    if(argc > 1)
+    if(program_path != NULL)
+    {
+        load_memory(&program, program_path);
+    }
+    /* Run the cores without prompts */
+    if(program.settings.multicore != NULL)
+    {
+        int error_status = (program_path != NULL) ? run_multicore(&program) : -1;
+        release_multicore(&program);
+        shutdown_program(&program);
+        return (error_status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Run the instances without prompts */
+    if(lane_count != 0)
+    {
+        batch_t batch;
+        /* Set after the load clears the program */
+        program.breakpoint = lane_breakpoint;
+        int error_status = (program_path != NULL) ? create_batch(&batch, &program, lane_count, lane_instructions) : -1;
+        if(error_status != 0)
+        {
+            printf("Invalid Batch Option\n");
+        }
+        else
+        {
+            if(sweep_path != NULL)
+            {
+                error_status = load_sweep(&batch, sweep_path);
+            }
+            if(error_status == 0)
+            {
+                error_status = run_batch(&batch);
+                print_batch(&batch, stdout);
+            }
+            release_batch(&batch);
+        }
+        shutdown_program(&program);
+        return (error_status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Serve debugger session */
+    if(gdb_endpoint != NULL)
+    {
+        int error_status = run_gdb_stub(&program, gdb_endpoint);
+        shutdown_program(&program);
+        return (error_status == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Run script without prompts - fails if any expectation fails */
+    if(script_path != NULL)
     {
-        load_memory(&program, argv[1]);
+        int failures = run_script(&program, script_path);
+        shutdown_program(&program);
+        return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
     
     run_operating_system(&program);
+    shutdown_program(&program);
     return EXIT_SUCCESS;
 }
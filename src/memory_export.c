@@ -0,0 +1,524 @@
+/**
+ * @file memory_export.c
+ * @brief Bulk export and import of memory ranges
+ *
+ * Ranges follow display_memory - start address inclusive, end address exclusive.
+ * Each format builds whole lines in a buffer and writes them with one call.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-16
+ */
+
+#include "memory_export.h"
+
+/**
+ * @brief Lookup table of hexadecimal digits
+ */
+static const char hex_digits[] = "0123456789ABCDEF";
+
+/**
+ * @brief Append a byte to a line buffer as two hexadecimal digits
+ *
+ * @param line Line buffer - advanced by two characters
+ * @param byte Byte to append
+ * @return char* Position after the appended digits
+ */
+static char *append_hex_byte(char *line, byte_t byte)
+{
+    *line++ = hex_digits[byte >> 4];
+    *line++ = hex_digits[byte & FOUR_BITS];
+    return line;
+}
+
+/**
+ * @brief Value of a hexadecimal character
+ *
+ * @param character Hexadecimal digit - checked by the caller
+ * @return int [0 - 15]
+ */
+static int hex_nibble(char character)
+{
+    return isdigit((unsigned char)character) ? character - '0' : toupper((unsigned char)character) - 'A' + 10;
+}
+
+/**
+ * @brief Read two hexadecimal characters as a byte
+ *
+ * @param characters Pointer to the first character
+ * @param byte Pointer to destination byte
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_hex_byte(char *characters, byte_t *byte)
+{
+    if(!isxdigit((unsigned char)characters[0]) || !isxdigit((unsigned char)characters[1]))
+    {
+        return -1;
+    }
+    *byte = (byte_t)((hex_nibble(characters[0]) << 4) | hex_nibble(characters[1]));
+    return 0;
+}
+
+/**
+ * @brief Write a range as Intel HEX data records followed by an EOF record
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param file Output file
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int export_intel_hex(byte_t *memory, int start_address, int end_address, FILE *file)
+{
+    char line[MAX_RECORD_LENGTH];
+    for(int address = start_address; address < end_address; address += EXPORT_BYTES_PER_RECORD)
+    {
+        int length = end_address - address;
+        if(length > EXPORT_BYTES_PER_RECORD)
+        {
+            length = EXPORT_BYTES_PER_RECORD;
+        }
+        byte_t sum = (byte_t)(length + (address >> 8) + (address & EIGHT_BITS) + INTEL_HEX_DATA_TYPE);
+        char *position = line;
+        *position++ = ':';
+        position = append_hex_byte(position, (byte_t)length);
+        position = append_hex_byte(position, (byte_t)(address >> 8));
+        position = append_hex_byte(position, (byte_t)(address & EIGHT_BITS));
+        position = append_hex_byte(position, INTEL_HEX_DATA_TYPE);
+        for(int i = 0; i < length; i++)
+        {
+            position = append_hex_byte(position, memory[address + i]);
+            sum += memory[address + i];
+        }
+        /* Two's complement checksum */
+        position = append_hex_byte(position, (byte_t)(-sum));
+        *position++ = '\n';
+        fwrite(line, 1, position - line, file);
+    }
+    fputs(":00000001FF\n", file);
+    return 0;
+}
+
+/**
+ * @brief Write a range as S-Records readable by load_memory
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param record_type INSTRUCTION_TYPE or DATA_TYPE
+ * @param file Output file
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int export_s_record(byte_t *memory, int start_address, int end_address, record_type_t record_type, FILE *file)
+{
+    char line[MAX_RECORD_LENGTH];
+    for(int address = start_address; address < end_address; address += EXPORT_BYTES_PER_RECORD)
+    {
+        int length = end_address - address;
+        if(length > EXPORT_BYTES_PER_RECORD)
+        {
+            length = EXPORT_BYTES_PER_RECORD;
+        }
+        /* Record length includes address and checksum */
+        byte_t record_length = (byte_t)(length + ADDRESS_LENGTH + CHECKSUM_LENGTH);
+        byte_t sum = (byte_t)(record_length + (address >> 8) + (address & EIGHT_BITS));
+        char *position = line;
+        *position++ = 'S';
+        *position++ = (char)record_type;
+        position = append_hex_byte(position, record_length);
+        position = append_hex_byte(position, (byte_t)(address >> 8));
+        position = append_hex_byte(position, (byte_t)(address & EIGHT_BITS));
+        for(int i = 0; i < length; i++)
+        {
+            position = append_hex_byte(position, memory[address + i]);
+            sum += memory[address + i];
+        }
+        /* Sum of all bytes including checksum is CHECKSUM_VALUE */
+        position = append_hex_byte(position, (byte_t)(CHECKSUM_VALUE - sum));
+        *position++ = '\n';
+        fwrite(line, 1, position - line, file);
+    }
+    return 0;
+}
+
+/**
+ * @brief Write each range that differs from the baseline image
+ *
+ * Lines have the form "#start-#end: bytes" with end inclusive,
+ * with at most EXPORT_BYTES_PER_RECORD bytes per line.
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param baseline Baseline image of the full memory
+ * @param file Output file
+ * @return int Number of changed bytes, < 0 = FAILURE
+ */
+static int export_diff(byte_t *memory, int start_address, int end_address, byte_t *baseline, FILE *file)
+{
+    char line[MAX_RECORD_LENGTH];
+    int changed_bytes = 0;
+    int address = start_address;
+    while(address < end_address)
+    {
+        /* Skip unchanged bytes */
+        if(memory[address] == baseline[address])
+        {
+            address++;
+            continue;
+        }
+        /* Collect run of changed bytes */
+        int length = 0;
+        while(address + length < end_address && length < EXPORT_BYTES_PER_RECORD
+            && memory[address + length] != baseline[address + length])
+        {
+            length++;
+        }
+        int written = sprintf_s(line, MAX_RECORD_LENGTH, "#%04x-#%04x:", address, address + length - 1);
+        char *position = line + written;
+        for(int i = 0; i < length; i++)
+        {
+            *position++ = ' ';
+            position = append_hex_byte(position, memory[address + i]);
+        }
+        *position++ = '\n';
+        fwrite(line, 1, position - line, file);
+        changed_bytes += length;
+        address += length;
+    }
+    return changed_bytes;
+}
+
+/**
+ * @brief Export a memory range to a file
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param format Output format
+ * @param record_type S-Record type for FORMAT_S_RECORD
+ * @param baseline Baseline image for FORMAT_DIFF - unused otherwise
+ * @param file Output file
+ * @return int [>= 0 = SUCCESS, < 0 = FAILURE]
+ */
+int export_memory(byte_t *memory, int start_address, int end_address,
+    export_format_t format, record_type_t record_type, byte_t *baseline, FILE *file)
+{
+    if(memory == NULL || file == NULL)
+    {
+        return -1;
+    }
+    if(start_address < 0 || end_address > DATA_MEMORY_LENGTH || start_address > end_address)
+    {
+        /* Invalid Range */
+        return -2;
+    }
+
+    switch(format)
+    {
+    case FORMAT_BINARY:
+        if(fwrite(memory + start_address, 1, end_address - start_address, file) != (size_t)(end_address - start_address))
+        {
+            return -3;
+        }
+        return 0;
+    case FORMAT_INTEL_HEX:
+        return export_intel_hex(memory, start_address, end_address, file);
+    case FORMAT_S_RECORD:
+        return export_s_record(memory, start_address, end_address, record_type, file);
+    case FORMAT_DIFF:
+        if(baseline == NULL)
+        {
+            return -1;
+        }
+        return export_diff(memory, start_address, end_address, baseline, file);
+    default:
+        /* Invalid Format */
+        return -4;
+    }
+}
+
+/**
+ * @brief Write a byte to memory if it lies within the import range
+ *
+ * @param memory Memory array
+ * @param address Destination address
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param byte Byte to write
+ * @return int [1 = Written, 0 = Outside the range]
+ */
+static int import_byte(byte_t *memory, int address, int start_address, int end_address, byte_t byte)
+{
+    if(address >= start_address && address < end_address)
+    {
+        memory[address] = byte;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parse and verify one Intel HEX record
+ *
+ * The record must hold exactly its length in data bytes, followed only by
+ * the line ending, and its bytes must sum to zero.
+ *
+ * @param line Line starting with ':'
+ * @param type Pointer to the record type
+ * @param address Pointer to the record address
+ * @param data Data bytes - at least EIGHT_BITS + 1 long
+ * @return int Number of data bytes, < 0 = FAILURE
+ */
+static int parse_intel_hex_record(char *line, byte_t *type, int *address, byte_t *data)
+{
+    byte_t length, address_high, address_low, checksum;
+    if(line[0] != ':' || parse_hex_byte(line + 1, &length) || parse_hex_byte(line + 3, &address_high)
+        || parse_hex_byte(line + 5, &address_low) || parse_hex_byte(line + 7, type))
+    {
+        return -1;
+    }
+    byte_t sum = (byte_t)(length + address_high + address_low + *type);
+    char *position = line + 9;
+    for(int i = 0; i < length; i++, position += 2)
+    {
+        if(parse_hex_byte(position, &data[i]) != 0)
+        {
+            /* Shorter than its length */
+            return -1;
+        }
+        sum += data[i];
+    }
+    if(parse_hex_byte(position, &checksum) != 0)
+    {
+        return -1;
+    }
+    position += 2;
+    /* Nothing after the checksum but the line ending */
+    while(*position == '\r' || *position == '\n')
+    {
+        position++;
+    }
+    if(*position != NUL || (byte_t)(sum + checksum) != 0)
+    {
+        return -1;
+    }
+    *address = (address_high << 8) | address_low;
+    return length;
+}
+
+/**
+ * @brief Import Intel HEX data records up to the EOF record
+ *
+ * Only 16-bit data records are accepted - extended address records have no
+ * meaning below 64 KiB.  Records are staged and memory is written only
+ * once every record has been verified.
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param file Input file
+ * @return int Number of bytes written, IMPORT_RECORD_ERROR = Invalid Record, < 0 = FAILURE
+ */
+static int import_intel_hex(byte_t *memory, int start_address, int end_address, FILE *file)
+{
+    byte_t *staged = malloc(DATA_MEMORY_LENGTH);
+    if(staged == NULL)
+    {
+        return -1;
+    }
+    memcpy(staged + start_address, memory + start_address, end_address - start_address);
+
+    char line[4 * MAX_RECORD_LENGTH];
+    byte_t data[EIGHT_BITS + 1];
+    int imported_bytes = 0;
+    while(fgets(line, sizeof(line), file))
+    {
+        if(line[0] == '\n' || (line[0] == '\r' && line[1] == '\n'))
+        {
+            continue;
+        }
+        byte_t type;
+        int address;
+        int length = parse_intel_hex_record(line, &type, &address, data);
+        if(length < 0 || (type != INTEL_HEX_DATA_TYPE && type != INTEL_HEX_EOF_TYPE))
+        {
+            free(staged);
+            return IMPORT_RECORD_ERROR;
+        }
+        if(type == INTEL_HEX_EOF_TYPE)
+        {
+            break;
+        }
+        for(int i = 0; i < length; i++)
+        {
+            imported_bytes += import_byte(staged, address + i, start_address, end_address, data[i]);
+        }
+    }
+    memcpy(memory + start_address, staged + start_address, end_address - start_address);
+    free(staged);
+    return imported_bytes;
+}
+
+/**
+ * @brief Import a memory range from a file
+ *
+ * Binary images are placed at start_address.  Record formats are placed at
+ * the addresses they contain, ignoring bytes outside the range.
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param format Input format
+ * @param file Input file
+ * @return int Number of bytes written, IMPORT_RECORD_ERROR = Invalid Record, < 0 = FAILURE
+ */
+int import_memory(byte_t *memory, int start_address, int end_address,
+    export_format_t format, FILE *file)
+{
+    if(memory == NULL || file == NULL)
+    {
+        return -1;
+    }
+    if(start_address < 0 || end_address > DATA_MEMORY_LENGTH || start_address > end_address)
+    {
+        /* Invalid Range */
+        return -2;
+    }
+
+    char line[4 * MAX_RECORD_LENGTH];
+    int imported_bytes = 0;
+    s_record_t s_record;
+    switch(format)
+    {
+    case FORMAT_BINARY:
+        return (int)fread(memory + start_address, 1, end_address - start_address, file);
+    case FORMAT_INTEL_HEX:
+        return import_intel_hex(memory, start_address, end_address, file);
+    case FORMAT_S_RECORD:
+        while(fgets(line, MAX_RECORD_LENGTH, file))
+        {
+            if(parse_record(line, &s_record) != 0 || (s_record.type != INSTRUCTION_TYPE && s_record.type != DATA_TYPE))
+            {
+                continue;
+            }
+            int address = (s_record.address[0] << 8) | s_record.address[1];
+            int length = s_record.length - ADDRESS_LENGTH - CHECKSUM_LENGTH;
+            for(int i = 0; i < length; i++)
+            {
+                imported_bytes += import_byte(memory, address + i, start_address, end_address, s_record.data[i]);
+            }
+        }
+        return imported_bytes;
+    case FORMAT_DIFF:
+        while(fgets(line, sizeof(line), file))
+        {
+            unsigned int first_address, last_address;
+            int offset;
+            if(sscanf_s(line, "#%x-#%x:%n", &first_address, &last_address, &offset) < 2)
+            {
+                continue;
+            }
+            char *position = line + offset;
+            for(unsigned int address = first_address; address <= last_address; address++)
+            {
+                byte_t byte;
+                while(*position == ' ')
+                {
+                    position++;
+                }
+                if(parse_hex_byte(position, &byte) != 0)
+                {
+                    break;
+                }
+                position += 2;
+                imported_bytes += import_byte(memory, (int)address, start_address, end_address, byte);
+            }
+        }
+        return imported_bytes;
+    default:
+        /* Invalid Format */
+        return -4;
+    }
+}
+
+/**
+ * @brief Read a full memory baseline image from a raw binary file
+ *
+ * @param path Path of the baseline image
+ * @param baseline Destination array of DATA_MEMORY_LENGTH bytes
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int read_baseline(char *path, byte_t *baseline)
+{
+    FILE *file;
+    if(fopen_s(&file, path, "rb") != 0)
+    {
+        return -1;
+    }
+    /* Missing bytes compare as zero */
+    memset(baseline, 0, DATA_MEMORY_LENGTH);
+    (void) fread(baseline, 1, DATA_MEMORY_LENGTH, file);
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Export a memory range to a file path
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param format Output format
+ * @param record_type S-Record type for FORMAT_S_RECORD
+ * @param path Output path
+ * @param baseline_path Baseline image path for FORMAT_DIFF - unused otherwise
+ * @return int [>= 0 = SUCCESS, EXPORT_FILE_ERROR = Open Failed, < 0 = FAILURE]
+ */
+int export_memory_file(byte_t *memory, int start_address, int end_address,
+    export_format_t format, record_type_t record_type, char *path, char *baseline_path)
+{
+    byte_t *baseline = NULL;
+    if(format == FORMAT_DIFF)
+    {
+        baseline = malloc(DATA_MEMORY_LENGTH);
+        if(baseline == NULL || baseline_path == NULL || read_baseline(baseline_path, baseline) != 0)
+        {
+            free(baseline);
+            return EXPORT_FILE_ERROR;
+        }
+    }
+
+    FILE *file;
+    if(fopen_s(&file, path, format == FORMAT_BINARY ? "wb" : "w") != 0)
+    {
+        free(baseline);
+        return EXPORT_FILE_ERROR;
+    }
+    int error_status = export_memory(memory, start_address, end_address, format, record_type, baseline, file);
+    fclose(file);
+    free(baseline);
+    return error_status;
+}
+
+/**
+ * @brief Import a memory range from a file path
+ *
+ * @param memory Memory array
+ * @param start_address First address
+ * @param end_address Address after the last byte
+ * @param format Input format
+ * @param path Input path
+ * @return int Number of bytes imported, EXPORT_FILE_ERROR = Open Failed, < 0 = FAILURE
+ */
+int import_memory_file(byte_t *memory, int start_address, int end_address,
+    export_format_t format, char *path)
+{
+    FILE *file;
+    if(fopen_s(&file, path, format == FORMAT_BINARY ? "rb" : "r") != 0)
+    {
+        return EXPORT_FILE_ERROR;
+    }
+    int imported_bytes = import_memory(memory, start_address, end_address, format, file);
+    fclose(file);
+    return imported_bytes;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file metrics.c
+ * @brief Run metrics export for monitoring many emulations
+ *
+ * Instructions retired, clock cycles, bubbles, host run and load time,
+ * emulated MIPS and the reason the last run stopped are written in the
+ * Prometheus text format or as JSON. Each export replaces the file, or is
+ * sent as one message to a TCP port on loopback or a Unix socket. Exports
+ * happen at exit and, while running, once the interval has elapsed - the
+ * run loop only reads the host clock every METRICS_CHECK_CYCLES cycles.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-03
+ */
+
+#include "metrics.h"
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL     /* Closed connections return an error instead of SIGPIPE */
+#else
+#define SEND_FLAGS 0
+#endif
+
+/* Names accepted on selection */
+static const char *metrics_format_names[NUM_OF_METRICS_FORMATS] =
+{
+    "prometheus", "json"
+};
+
+/* Label values for each exit reason */
+static const char *exit_reason_names[NUM_OF_EXIT_REASONS] =
+{
+    "none", "running", "breakpoint", "cycle_limit", "exit"
+};
+
+/* Label values for each bubble cause */
+static const char *bubble_cause_labels[NUM_OF_BUBBLE_CAUSES] =
+{
+    "branch", "load_pc", "register_pc", "cex", "exception", "restart"
+};
+
+/**
+ * @brief Read the host wall clock
+ *
+ * @return double Seconds since the epoch
+ */
+double host_seconds(void)
+{
+    struct timespec now;
+    if(timespec_get(&now, TIME_UTC) == 0)
+    {
+        return 0.0;
+    }
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Select the export destination and format, allocating on first use
+ *
+ * @param program Program context
+ * @param destination File path, TCP port on loopback, or unix:socket path
+ * @param format prometheus or json - NULL keeps the current format
+ * @param interval Seconds between exports while running - 0 exports only at exit
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_metrics(program_t *program, char *destination, char *format, double interval)
+{
+    int format_index = METRICS_PROMETHEUS;
+    if(format != NULL)
+    {
+        while(format_index < NUM_OF_METRICS_FORMATS && strcmp(format, metrics_format_names[format_index]) != 0)
+        {
+            format_index++;
+        }
+    }
+    if(destination == NULL || strlen(destination) >= MAX_PATH_LENGTH
+        || format_index == NUM_OF_METRICS_FORMATS || interval < 0)
+    {
+        return -1;
+    }
+    if(program->settings.metrics == NULL)
+    {
+        program->settings.metrics = calloc(1, sizeof(metrics_t));
+        if(program->settings.metrics == NULL)
+        {
+            return -2;
+        }
+        program->settings.metrics->format = METRICS_PROMETHEUS;
+    }
+    metrics_t *metrics = program->settings.metrics;
+    strcpy_s(metrics->destination, MAX_PATH_LENGTH, destination);
+    if(format != NULL)
+    {
+        metrics->format = (metrics_format_t)format_index;
+    }
+    metrics->interval = interval;
+    metrics->last_export = host_seconds();
+    reset_metrics(program);
+    return 0;
+}
+
+/**
+ * @brief Start timing a run
+ *
+ * @param program Program context
+ */
+void begin_run_metrics(program_t *program)
+{
+    metrics_t *metrics = program->settings.metrics;
+    if(metrics == NULL)
+    {
+        return;
+    }
+    metrics->run_start = host_seconds();
+    metrics->exit_reason = EXIT_REASON_RUNNING;
+    metrics->next_check_cycle = program->clock_cycles + METRICS_CHECK_CYCLES;
+}
+
+/**
+ * @brief Export if the interval has elapsed - called by the run loop at next_check_cycle
+ *
+ * @param program Program context
+ */
+void check_metrics(program_t *program)
+{
+    metrics_t *metrics = program->settings.metrics;
+    metrics->next_check_cycle = program->clock_cycles + METRICS_CHECK_CYCLES;
+    if(metrics->interval > 0 && host_seconds() - metrics->last_export >= metrics->interval)
+    {
+        (void) export_metrics(program);
+    }
+}
+
+/**
+ * @brief Stop timing a run, exporting if the interval has elapsed
+ *
+ * @param program Program context
+ * @param exit_reason Reason the run stopped
+ */
+void end_run_metrics(program_t *program, exit_reason_t exit_reason)
+{
+    metrics_t *metrics = program->settings.metrics;
+    if(metrics == NULL)
+    {
+        return;
+    }
+    double now = host_seconds();
+    if(metrics->exit_reason == EXIT_REASON_RUNNING)
+    {
+        metrics->run_seconds += now - metrics->run_start;
+    }
+    metrics->exit_reason = exit_reason;
+    if(metrics->interval > 0 && now - metrics->last_export >= metrics->interval)
+    {
+        (void) export_metrics(program);
+    }
+}
+
+/**
+ * @brief Clear run timing, keeping the destination and load time
+ *
+ * @param program Program context
+ */
+void reset_metrics(program_t *program)
+{
+    metrics_t *metrics = program->settings.metrics;
+    if(metrics == NULL)
+    {
+        return;
+    }
+    metrics->run_seconds = 0;
+    metrics->exit_reason = EXIT_REASON_NONE;
+    metrics->next_check_cycle = METRICS_CHECK_CYCLES;
+}
+
+/**
+ * @brief Append formatted text to the export buffer, truncating when full
+ *
+ * @param buffer Export buffer of METRICS_BUFFER_LENGTH bytes
+ * @param length Characters written so far
+ * @param format printf format
+ */
+static void append(char *buffer, int *length, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    int written = vsnprintf(buffer + *length, METRICS_BUFFER_LENGTH - *length, format, arguments);
+    va_end(arguments);
+    if(written > 0)
+    {
+        *length += (*length + written < METRICS_BUFFER_LENGTH) ? written : METRICS_BUFFER_LENGTH - 1 - *length;
+    }
+}
+
+/**
+ * @brief Copy the executable name as a quoted label or string value
+ *
+ * @param program Program context
+ * @param name Destination of MAX_RECORD_LENGTH characters
+ */
+static void escape_name(program_t *program, char *name)
+{
+    int length = 0;
+    for(int i = 0; i < MAX_RECORD_LENGTH - 1 && program->executable_name[i] != NUL && length < MAX_RECORD_LENGTH - 2; i++)
+    {
+        char character = (char)program->executable_name[i];
+        if(!isprint((unsigned char)character))
+        {
+            continue;
+        }
+        if(character == '"' || character == '\\')
+        {
+            name[length++] = '\\';
+        }
+        name[length++] = character;
+    }
+    name[length] = NUL;
+}
+
+/**
+ * @brief Send a complete export to a TCP port on loopback or a Unix socket
+ *
+ * @param destination Port number or unix:socket path
+ * @param text Export text
+ * @param length Export length
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int send_metrics(char *destination, char *text, int length)
+{
+    int is_unix = (strncmp(destination, METRICS_SOCKET_PREFIX, strlen(METRICS_SOCKET_PREFIX)) == 0);
+#ifdef WINDOWS
+    WSADATA wsa_data;
+    /* Unix sockets unavailable */
+    if(is_unix || WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+    {
+        return -1;
+    }
+    SOCKET connection;
+#else
+    int connection;
+#endif
+    int error_status;
+    if(!is_unix)
+    {
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((unsigned short)atoi(destination));
+        /* Local collectors only */
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connection = socket(AF_INET, SOCK_STREAM, 0);
+        error_status = connect(connection, (struct sockaddr *)&address, sizeof(address));
+    }
+#ifndef WINDOWS
+    else
+    {
+        struct sockaddr_un address;
+        char *path = destination + strlen(METRICS_SOCKET_PREFIX);
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if(strlen(path) >= sizeof(address.sun_path))
+        {
+            return -1;
+        }
+        strcpy_s(address.sun_path, sizeof(address.sun_path), path);
+        connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        error_status = connect(connection, (struct sockaddr *)&address, sizeof(address));
+    }
+#endif
+    while(error_status == 0 && length > 0)
+    {
+        int sent = (int)send(connection, text, length, SEND_FLAGS);
+        if(sent <= 0)
+        {
+            error_status = -1;
+            break;
+        }
+        text += sent;
+        length -= sent;
+    }
+#ifdef WINDOWS
+    closesocket(connection);
+    WSACleanup();
+#else
+    close(connection);
+#endif
+    return (error_status == 0) ? 0 : -2;
+}
+
+/**
+ * @brief Write the current metrics to the destination
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int export_metrics(program_t *program)
+{
+    metrics_t *metrics = program->settings.metrics;
+    if(metrics == NULL)
+    {
+        return -1;
+    }
+    double now = host_seconds();
+    metrics->last_export = now;
+    double run_seconds = metrics->run_seconds;
+    if(metrics->exit_reason == EXIT_REASON_RUNNING)
+    {
+        run_seconds += now - metrics->run_start;
+    }
+    double mips = (run_seconds > 0) ? program->statistics.instructions_retired / run_seconds / 1e6 : 0.0;
+
+    char name[MAX_RECORD_LENGTH];
+    escape_name(program, name);
+    char buffer[METRICS_BUFFER_LENGTH];
+    int length = 0;
+    if(metrics->format == METRICS_JSON)
+    {
+        append(buffer, &length, "{\"program\":\"%s\",\"timestamp\":%.3f,\"instructions_retired\":%d,\"clock_cycles\":%d,\"bubbles\":{",
+            name, now, program->statistics.instructions_retired, program->clock_cycles);
+        for(int cause = 0; cause < NUM_OF_BUBBLE_CAUSES; cause++)
+        {
+            append(buffer, &length, "%s\"%s\":%d", (cause == 0) ? "" : ",", bubble_cause_labels[cause],
+                program->statistics.bubbles[cause]);
+        }
+        append(buffer, &length, "},\"run_seconds\":%.6f,\"load_seconds\":%.6f,\"emulated_mips\":%.3f,\"exit_reason\":\"%s\"}\n",
+            run_seconds, metrics->load_seconds, mips, exit_reason_names[metrics->exit_reason]);
+    }
+    else
+    {
+        append(buffer, &length, "# HELP xm23p_instructions_retired_total Instructions executed, excluding bubbles.\n"
+            "# TYPE xm23p_instructions_retired_total counter\n"
+            "xm23p_instructions_retired_total{program=\"%s\"} %d\n", name, program->statistics.instructions_retired);
+        append(buffer, &length, "# HELP xm23p_clock_cycles_total Emulated clock cycles.\n"
+            "# TYPE xm23p_clock_cycles_total counter\n"
+            "xm23p_clock_cycles_total{program=\"%s\"} %d\n", name, program->clock_cycles);
+        append(buffer, &length, "# HELP xm23p_bubbles_total Pipeline slots lost to bubbles.\n"
+            "# TYPE xm23p_bubbles_total counter\n");
+        for(int cause = 0; cause < NUM_OF_BUBBLE_CAUSES; cause++)
+        {
+            append(buffer, &length, "xm23p_bubbles_total{program=\"%s\",cause=\"%s\"} %d\n", name,
+                bubble_cause_labels[cause], program->statistics.bubbles[cause]);
+        }
+        append(buffer, &length, "# HELP xm23p_run_seconds_total Host time spent running.\n"
+            "# TYPE xm23p_run_seconds_total counter\n"
+            "xm23p_run_seconds_total{program=\"%s\"} %.6f\n", name, run_seconds);
+        append(buffer, &length, "# HELP xm23p_load_seconds Host time taken by the last load.\n"
+            "# TYPE xm23p_load_seconds gauge\n"
+            "xm23p_load_seconds{program=\"%s\"} %.6f\n", name, metrics->load_seconds);
+        append(buffer, &length, "# HELP xm23p_emulated_mips Instructions retired per host microsecond of running.\n"
+            "# TYPE xm23p_emulated_mips gauge\n"
+            "xm23p_emulated_mips{program=\"%s\"} %.3f\n", name, mips);
+        append(buffer, &length, "# HELP xm23p_exit_reason Reason the last run stopped.\n"
+            "# TYPE xm23p_exit_reason gauge\n");
+        for(int reason = 0; reason < NUM_OF_EXIT_REASONS; reason++)
+        {
+            append(buffer, &length, "xm23p_exit_reason{program=\"%s\",reason=\"%s\"} %d\n", name,
+                exit_reason_names[reason], reason == (int)metrics->exit_reason);
+        }
+        append(buffer, &length, "# HELP xm23p_export_timestamp_seconds Host time of this export.\n"
+            "# TYPE xm23p_export_timestamp_seconds gauge\n"
+            "xm23p_export_timestamp_seconds{program=\"%s\"} %.3f\n", name, now);
+    }
+
+    /* Socket destinations are a port number or carry the socket prefix */
+    int is_port = (metrics->destination[0] != NUL);
+    for(char *character = metrics->destination; *character != NUL; character++)
+    {
+        is_port &= (isdigit((unsigned char)*character) != 0);
+    }
+    if(is_port || strncmp(metrics->destination, METRICS_SOCKET_PREFIX, strlen(METRICS_SOCKET_PREFIX)) == 0)
+    {
+        return send_metrics(metrics->destination, buffer, length);
+    }
+    FILE *file;
+    if(fopen_s(&file, metrics->destination, "w") != 0)
+    {
+        return -2;
+    }
+    fputs(buffer, file);
+    fclose(file);
+    return 0;
+}
+
+/**
+ * @brief Write the final export as the emulator exits, then free the export
+ *
+ * @param program Program context
+ */
+void close_metrics(program_t *program)
+{
+    if(program->settings.metrics == NULL)
+    {
+        return;
+    }
+    /* Keep the reason the last run stopped */
+    if(program->settings.metrics->exit_reason == EXIT_REASON_RUNNING)
+    {
+        program->settings.metrics->exit_reason = EXIT_REASON_EXIT;
+    }
+    if(export_metrics(program) != 0)
+    {
+        printf("Error Exporting Metrics\n");
+    }
+    release_metrics(program);
+}
+
+/**
+ * @brief Free the metrics export, disabling it
+ *
+ * @param program Program context
+ */
+void release_metrics(program_t *program)
+{
+    free(program->settings.metrics);
+    program->settings.metrics = NULL;
+}
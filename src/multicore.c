@@ -0,0 +1,382 @@
+/**
+ * @file multicore.c
+ * @brief Multi-core XM23P systems sharing data memory
+ *
+ * Each core has its own program context - registers, PSW, pipeline
+ * latches, instruction memory and devices - and reads and writes the data
+ * memory of the first core. The loaded program is copied to every core,
+ * which tells itself apart through the inter-core ID register.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-13
+ */
+
+#include "multicore.h"
+
+/* Final core states - indexed by core_state_t */
+static const char *core_state_names[] = {"Cycle Limit", "Waiting", "Breakpoint"};
+
+/**
+ * @brief Make a program a multi-core system - called before the program is loaded
+ *
+ * @param program Program context - becomes the first core
+ * @param core_count Number of cores [1 - MAX_CORES]
+ * @param cycle_budget Clock cycles to run
+ * @param quantum Clock cycles between synchronizations
+ * @param deterministic Run the cores in turn on the calling thread
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int set_multicore(program_t *program, int core_count, int cycle_budget, int quantum, int deterministic)
+{
+    if(program == NULL || core_count < 1 || core_count > MAX_CORES || cycle_budget <= 0 || quantum <= 0)
+    {
+        return -1;
+    }
+    release_multicore(program);
+    multicore_t *system = calloc(1, sizeof(multicore_t));
+    if(system == NULL)
+    {
+        return -2;
+    }
+    system->core_count = core_count;
+    system->cycle_budget = cycle_budget;
+    system->quantum = quantum;
+    system->deterministic = deterministic;
+    system->cores[0].program = program;
+    program->settings.multicore = system;
+    program->settings.core_number = 0;
+    program->settings.shared_data_memory = NULL;
+    return 0;
+}
+
+/**
+ * @brief Inter-core register access
+ *
+ * @param program Program context
+ * @param address Accessed address
+ * @param control Access type
+ * @param value Value read or written
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int intercore_access(program_t *program, word_t address, control_state_t control, word_t *value)
+{
+    multicore_t *system = program->settings.multicore;
+    core_t *core = &system->cores[program->settings.core_number];
+    int write = (control == WRITE_BYTE || control == WRITE_WORD);
+    word_t written = write ? write_lane(0, address, control, *value) : 0;
+    int owner = 0;
+    switch(address & ~BYTE_LENGTH)
+    {
+    case INTERCORE_ID_ADDRESS:
+        if(!write)
+        {
+            *value = read_lane((word_t)(program->settings.core_number | system->core_count << 8), address, control);
+        }
+        break;
+    case INTERCORE_SEND_ADDRESS:
+        for(int target = 0; write && target < system->core_count; target++)
+        {
+            if(written & (1 << target))
+            {
+                atomic_fetch_or(&system->cores[target].incoming, 1u << program->settings.core_number);
+            }
+        }
+        break;
+    case INTERCORE_PENDING_ADDRESS:
+        if(write)
+        {
+            core->pending &= (word_t)~written;
+        }
+        else
+        {
+            *value = read_lane(core->pending, address, control);
+        }
+        break;
+    case INTERCORE_LOCK_ADDRESS:
+        owner = program->settings.core_number + 1;
+        if(write)
+        {
+            /* Only the holder releases */
+            atomic_compare_exchange_strong(&system->lock_owner, &owner, 0);
+        }
+        else
+        {
+            int expected = 0;
+            int acquired = atomic_compare_exchange_strong(&system->lock_owner, &expected, owner) || expected == owner;
+            *value = read_lane(acquired ? 0 : 1, address, control);
+        }
+        break;
+    case INTERCORE_HALT_ADDRESS:
+        if(write)
+        {
+            core->state = CORE_WAITING;
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Run a core to the end of the quantum, a breakpoint or a halt
+ *
+ * @param core Core to run
+ */
+static void run_quantum(core_t *core)
+{
+    program_t *program = core->program;
+    while(core->state == CORE_RUNNING && program->clock_cycles < core->system->quantum_end)
+    {
+        if(run_cycle(program, NO_CYCLE_LIMIT) == CYCLE_BREAKPOINT)
+        {
+            core->state = CORE_STOPPED;
+        }
+    }
+}
+
+/**
+ * @brief Host thread running one core a quantum at a time
+ *
+ * @param argument Core to run
+ * @return int 0
+ */
+static int core_thread(void *argument)
+{
+    core_t *core = argument;
+    multicore_t *system = core->system;
+    int generation = 0;
+    for(;;)
+    {
+        mtx_lock(&system->mutex);
+        while(system->generation == generation)
+        {
+            cnd_wait(&system->start, &system->mutex);
+        }
+        generation = system->generation;
+        int stopping = system->stopping;
+        mtx_unlock(&system->mutex);
+        if(stopping)
+        {
+            return 0;
+        }
+
+        run_quantum(core);
+
+        mtx_lock(&system->mutex);
+        if(--system->running == 0)
+        {
+            cnd_signal(&system->finished);
+        }
+        mtx_unlock(&system->mutex);
+    }
+}
+
+/**
+ * @brief Deliver the inter-core interrupts sent during the last quantum
+ *
+ * A waiting core is woken at the current quantum boundary.
+ *
+ * @param system Multi-core system
+ * @return int Number of running cores
+ */
+static int deliver_interrupts(multicore_t *system)
+{
+    int running = 0;
+    for(int index = 0; index < system->core_count; index++)
+    {
+        core_t *core = &system->cores[index];
+        word_t incoming = (word_t)atomic_exchange(&core->incoming, 0u);
+        if(incoming != 0 && core->state != CORE_STOPPED)
+        {
+            core->pending |= incoming;
+            raise_interrupt(core->program, INTERCORE_VECTOR);
+            if(core->state == CORE_WAITING)
+            {
+                core->state = CORE_RUNNING;
+                if(core->program->clock_cycles < system->quantum_end)
+                {
+                    core->program->clock_cycles = system->quantum_end;
+                }
+            }
+        }
+        running += (core->state == CORE_RUNNING);
+    }
+    return running;
+}
+
+/**
+ * @brief Run every core for one quantum
+ *
+ * @param system Multi-core system
+ */
+static void run_system_quantum(multicore_t *system)
+{
+    if(system->deterministic)
+    {
+        for(int index = 0; index < system->core_count; index++)
+        {
+            run_quantum(&system->cores[index]);
+        }
+        return;
+    }
+    /* First core runs on the calling thread */
+    mtx_lock(&system->mutex);
+    system->running = system->core_count - 1;
+    system->generation++;
+    cnd_broadcast(&system->start);
+    mtx_unlock(&system->mutex);
+    run_quantum(&system->cores[0]);
+    mtx_lock(&system->mutex);
+    while(system->running > 0)
+    {
+        cnd_wait(&system->finished, &system->mutex);
+    }
+    mtx_unlock(&system->mutex);
+}
+
+/**
+ * @brief Copy the loaded program to the other cores and run the system
+ *
+ * Runs until every core has stopped or waits without an interrupt to
+ * wake it, or until the cycle budget is spent.
+ *
+ * @param program Program context of the first core - loaded
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int run_multicore(program_t *program)
+{
+    multicore_t *system = program->settings.multicore;
+    if(system == NULL)
+    {
+        return -1;
+    }
+    for(int index = 1; index < system->core_count; index++)
+    {
+        program_t *core_program = malloc(sizeof(program_t));
+        if(core_program == NULL)
+        {
+            return -2;
+        }
+        *core_program = *program;
+        /* Models, logs and traces follow the first core only */
+        memset(&core_program->settings, 0, sizeof(emulator_settings_t));
+        core_program->settings.console_output = program->settings.console_output;
+        core_program->settings.fusion_disabled = program->settings.fusion_disabled;
+        core_program->settings.multicore = system;
+        core_program->settings.core_number = index;
+        core_program->settings.shared_data_memory = program->data_memory;
+        system->cores[index].program = core_program;
+    }
+    for(int index = 0; index < system->core_count; index++)
+    {
+        core_t *core = &system->cores[index];
+        core->system = system;
+        core->state = CORE_RUNNING;
+        core->pending = 0;
+        atomic_init(&core->incoming, 0u);
+        core->program->cycle_state = CYCLE_START;
+    }
+    atomic_init(&system->lock_owner, 0);
+    system->quantum_end = program->clock_cycles;
+    system->quantum_count = 0;
+
+    int threads_started = 0;
+    int error_status = 0;
+    int synchronized = !system->deterministic;
+    if(synchronized)
+    {
+        if(mtx_init(&system->mutex, mtx_plain) != thrd_success || cnd_init(&system->start) != thrd_success
+            || cnd_init(&system->finished) != thrd_success)
+        {
+            return -3;
+        }
+        system->generation = 0;
+        system->stopping = 0;
+        for(threads_started = 1; threads_started < system->core_count; threads_started++)
+        {
+            if(thrd_create(&system->cores[threads_started].thread, core_thread, &system->cores[threads_started]) != thrd_success)
+            {
+                /* Remaining cores run in turn */
+                printf("Unable to start core thread - running deterministic\n");
+                system->deterministic = 1;
+                error_status = -4;
+                break;
+            }
+        }
+    }
+
+    printf("Multi-Core: %d Cores, Quantum %d Cycles, %s\n", system->core_count, system->quantum,
+        system->deterministic ? "Deterministic" : "Parallel");
+    double run_start = host_seconds();
+    while(deliver_interrupts(system) > 0 && system->quantum_end < system->cycle_budget)
+    {
+        system->quantum_end = (system->cycle_budget - system->quantum_end > system->quantum)
+            ? system->quantum_end + system->quantum : system->cycle_budget;
+        run_system_quantum(system);
+        system->quantum_count++;
+        /* Output appears in core order at each boundary */
+        for(int index = 0; index < system->core_count; index++)
+        {
+            flush_console(system->cores[index].program);
+        }
+    }
+    double run_seconds = host_seconds() - run_start;
+
+    if(threads_started > 1)
+    {
+        mtx_lock(&system->mutex);
+        system->stopping = 1;
+        system->generation++;
+        cnd_broadcast(&system->start);
+        mtx_unlock(&system->mutex);
+        for(int index = 1; index < threads_started; index++)
+        {
+            thrd_join(system->cores[index].thread, NULL);
+        }
+    }
+    if(synchronized)
+    {
+        mtx_destroy(&system->mutex);
+        cnd_destroy(&system->start);
+        cnd_destroy(&system->finished);
+    }
+
+    long long instructions = 0;
+    for(int index = 0; index < system->core_count; index++)
+    {
+        program_t *core_program = system->cores[index].program;
+        printf("Core %d: PC %04x, %d Cycles, %d Instructions, %s\n", index, core_program->PROGRAM_COUNTER,
+            core_program->clock_cycles, core_program->statistics.instructions_retired,
+            core_state_names[system->cores[index].state]);
+        instructions += core_program->statistics.instructions_retired;
+    }
+    printf("%d Quantums, %lld Instructions in %.3f Seconds\n", system->quantum_count, instructions, run_seconds);
+    return error_status;
+}
+
+/**
+ * @brief Free the other cores and the system, leaving a single core
+ *
+ * @param program Program context of the first core
+ */
+void release_multicore(program_t *program)
+{
+    multicore_t *system = program->settings.multicore;
+    if(system == NULL)
+    {
+        return;
+    }
+    for(int index = 1; index < system->core_count; index++)
+    {
+        program_t *core_program = system->cores[index].program;
+        if(core_program != NULL)
+        {
+            release_statistics(core_program);
+            free(core_program);
+        }
+    }
+    free(system);
+    program->settings.multicore = NULL;
+    program->settings.core_number = 0;
+}
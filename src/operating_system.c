@@ -22,8 +22,15 @@ void display_utilities()
         printf("b - Set Breakpoint\n");
         printf("m - Memory Dump\n");
         printf("w - Memory Write\n");
+        printf("e - Memory Export\n");
+        printf("i - Memory Import\n");
         printf("r - Register Dump\n");
         printf("s - Register Set\n");
+        printf("c - Console Output\n");
+        printf("p - Pipeline Statistics\n");
+        printf("n - Branch Predictor\n");
+        printf("k - Cache Configuration\n");
+        printf("f - Data Profile\n");
         printf("x - Exit\n");
         printf("h - Help\n");
 }
@@ -41,7 +48,11 @@ void run_operating_system(program_t *program)
     {
         char utility;
         printf("User> ");
-        scanf_s(" %c", &utility, 1);
+        if(scanf_s(" %c", &utility, 1) != 1)
+        {
+            /* End of Input */
+            utility = EXIT;
+        }
         switch(utility)
         {
         case LOAD:
@@ -66,13 +77,39 @@ void run_operating_system(program_t *program)
         case MEMORY_WRITE:
             memory_write(program->instruction_memory, program->data_memory);
             break;
+        case MEMORY_EXPORT:
+            memory_export(program);
+            break;
+        case MEMORY_IMPORT:
+            memory_import(program);
+            break;
         case REGISTER_DUMP:
             register_dump(program->register_file[REGISTER]);
             break;
         case REGISTER_SET:
             register_set(program->register_file[REGISTER]);
             break;
+        case CONSOLE_OUTPUT:
+            console_output(program);
+            break;
+        case PIPELINE_STATISTICS:
+            display_statistics(program);
+            display_branch_predictor(program);
+            display_caches(program);
+            display_data_profile(program, PROFILE_DEFAULT_TOP);
+            break;
+        case BRANCH_PREDICTOR:
+            branch_predictor(program);
+            break;
+        case CACHE_CONFIGURATION:
+            cache_configuration(program);
+            break;
+        case DATA_PROFILE:
+            data_profile_configuration(program);
+            break;
         case EXIT:
+            /* Write Pending Console Output */
+            close_console(program);
             exit = 1;
             break;
         case HELP:
@@ -0,0 +1,219 @@
+/**
+ * @file replay.c
+ * @brief Deterministic record and replay of external inputs
+ *
+ * Emulation is deterministic apart from inputs taken from the host. In
+ * record mode each input is logged with the clock cycle it was observed
+ * at. In playback mode inputs come only from the log and become visible at
+ * the same clock cycle, so the guest sees the same values at the same
+ * points and the run repeats exactly without host I/O. Cycle differences
+ * are stored as variable length integers to keep logs compact.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-05
+ */
+
+#include "replay.h"
+
+/**
+ * @brief Write a clock cycle difference seven bits per byte
+ *
+ * @param file Log file
+ * @param value Non-negative difference
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int write_varint(FILE *file, unsigned int value)
+{
+    while(value >= VARINT_CONTINUE)
+    {
+        if(fputc((int)((value & SEVEN_BITS) | VARINT_CONTINUE), file) == EOF)
+        {
+            return -1;
+        }
+        value >>= VARINT_SHIFT;
+    }
+    return (fputc((int)value, file) == EOF) ? -1 : 0;
+}
+
+/**
+ * @brief Read a clock cycle difference
+ *
+ * @param file Log file
+ * @param value Difference read
+ * @return int [0 = SUCCESS, < 0 = End of Log]
+ */
+static int read_varint(FILE *file, unsigned int *value)
+{
+    *value = 0;
+    for(int shift = 0; shift < (int)(sizeof(unsigned int) * CHAR_BIT); shift += VARINT_SHIFT)
+    {
+        int character = fgetc(file);
+        if(character == EOF)
+        {
+            return -1;
+        }
+        *value |= (unsigned int)(character & SEVEN_BITS) << shift;
+        if(!(character & VARINT_CONTINUE))
+        {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Read the next playback entry - NO_EVENT once the log is exhausted
+ *
+ * @param log Input log
+ */
+static void read_entry(input_log_t *log)
+{
+    unsigned int difference;
+    int source;
+    int value;
+    if(read_varint(log->file, &difference) != 0 || (source = fgetc(log->file)) == EOF
+        || (value = fgetc(log->file)) == EOF || source >= NUM_OF_INPUT_SOURCES)
+    {
+        log->next_cycle = NO_EVENT;
+        return;
+    }
+    log->next_cycle = log->last_cycle + (int)difference;
+    log->next_source = (input_source_t)source;
+    log->next_value = (byte_t)value;
+}
+
+/**
+ * @brief Open a log to record host inputs to, or to replay inputs from
+ *
+ * @param program Program context
+ * @param path Log path
+ * @param mode Record or playback
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int open_input_log(program_t *program, char *path, replay_mode_t mode)
+{
+    close_input_log(program);
+    input_log_t *log = calloc(1, sizeof(input_log_t));
+    if(log == NULL)
+    {
+        return -1;
+    }
+    if(fopen_s(&log->file, path, (mode == REPLAY_RECORD) ? "wb" : "rb") != 0)
+    {
+        free(log);
+        return -2;
+    }
+    log->mode = mode;
+    if(mode == REPLAY_RECORD)
+    {
+        fwrite(INPUT_LOG_MAGIC, 1, INPUT_LOG_MAGIC_LENGTH, log->file);
+        fputc(INPUT_LOG_VERSION, log->file);
+    }
+    else
+    {
+        char header[INPUT_LOG_MAGIC_LENGTH];
+        if(fread(header, 1, INPUT_LOG_MAGIC_LENGTH, log->file) != INPUT_LOG_MAGIC_LENGTH
+            || memcmp(header, INPUT_LOG_MAGIC, INPUT_LOG_MAGIC_LENGTH) != 0 || fgetc(log->file) != INPUT_LOG_VERSION)
+        {
+            fclose(log->file);
+            free(log);
+            return -3;
+        }
+        read_entry(log);
+    }
+    program->settings.input_log = log;
+    return 0;
+}
+
+/**
+ * @brief Log a host input at the current clock cycle - ignored unless recording
+ *
+ * @param program Program context
+ * @param source Input source
+ * @param value Input value
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int record_input(program_t *program, input_source_t source, byte_t value)
+{
+    input_log_t *log = program->settings.input_log;
+    if(log == NULL || log->mode != REPLAY_RECORD)
+    {
+        return 0;
+    }
+    if(write_varint(log->file, (unsigned int)(program->clock_cycles - log->last_cycle)) != 0
+        || fputc(source, log->file) == EOF || fputc(value, log->file) == EOF)
+    {
+        return -1;
+    }
+    log->last_cycle = program->clock_cycles;
+    log->entries++;
+    return 0;
+}
+
+/**
+ * @brief Take the next logged input if it is from the source and due
+ *
+ * @param program Program context
+ * @param source Input source polled
+ * @param value Logged value
+ * @return int [1 = Input Replayed, 0 = None Due]
+ */
+int replay_input(program_t *program, input_source_t source, byte_t *value)
+{
+    input_log_t *log = program->settings.input_log;
+    if(log->next_cycle > program->clock_cycles || log->next_source != source)
+    {
+        return 0;
+    }
+    *value = log->next_value;
+    log->last_cycle = log->next_cycle;
+    log->entries++;
+    read_entry(log);
+    return 1;
+}
+
+/**
+ * @brief Mark a restart in the log - clock cycles return to 0
+ *
+ * Called before the clock is cleared, so recorded and replayed sessions
+ * stay aligned across loads and restarts.
+ *
+ * @param program Program context
+ */
+void restart_input_log(program_t *program)
+{
+    input_log_t *log = program->settings.input_log;
+    if(log == NULL)
+    {
+        return;
+    }
+    if(log->mode == REPLAY_RECORD)
+    {
+        (void) record_input(program, INPUT_RESTART, 0);
+        log->last_cycle = 0;
+    }
+    else if(log->next_cycle != NO_EVENT && log->next_source == INPUT_RESTART)
+    {
+        log->last_cycle = 0;
+        log->entries++;
+        read_entry(log);
+    }
+}
+
+/**
+ * @brief Close the input log, reporting the entries recorded or replayed
+ *
+ * @param program Program context
+ */
+void close_input_log(program_t *program)
+{
+    input_log_t *log = program->settings.input_log;
+    if(log == NULL)
+    {
+        return;
+    }
+    printf("Input Log: %u Entries %s\n", log->entries, (log->mode == REPLAY_RECORD) ? "Recorded" : "Replayed");
+    fclose(log->file);
+    free(log);
+    program->settings.input_log = NULL;
+}
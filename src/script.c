@@ -0,0 +1,911 @@
+/**
+ * @file script.c
+ * @brief Line-oriented command script interpreter
+ *
+ * Scripts hold one command per line, read from a file or stdin with no
+ * prompts.  Addresses and values are hexadecimal with an optional # or 0x
+ * prefix, cycle counts are decimal.  Lines starting with # are comments.
+ *
+ *     load tests/Execute_Tests/Test18_Addition.xme
+ *     break add 1000
+ *     run 500
+ *     dump data 0 ff
+ *     expect r0 == 0x1234
+ *
+ * Each expect command reports PASS or FAIL, followed by a summary.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-18
+ */
+
+#include "script.h"
+
+static int script_load(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_reset(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_break(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_run(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_dump(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_write(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_register(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_expect(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_debug(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_export(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_import(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_console(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_statistics(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_predictor(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_cache(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_profile(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_fusion(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_control_flow(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_echo(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_exit(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+static int script_help(program_t *program, int argument_count, char **argument_values, script_result_t *result);
+
+#define SCRIPT_USAGE_ERROR (-1)         /* Print command usage */
+#define SCRIPT_COMMAND_ERROR (-2)       /* Command printed its own error */
+
+/**
+ * @brief Table of Script Commands
+ *
+ */
+static const script_command_entry_t script_commands[] =
+{
+    {"load",    script_load,        "load <path>"},
+    {"reset",   script_reset,       "reset"},
+    {"break",   script_break,       "break [add] <address> | break clear"},
+    {"run",     script_run,         "run [cycles]"},
+    {"dump",    script_dump,        "dump prog|data <start> <end>"},
+    {"write",   script_write,       "write prog|data <address> <word>"},
+    {"reg",     script_register,    "reg | reg set <register> <value>"},
+    {"expect",  script_expect,      "expect <r0-r7|pc|sp|lr|psw|cycles|instructions|prog <address>|data <address>> ==|!= <value>"},
+    {"debug",   script_debug,       "debug on|off"},
+    {"export",  script_export,      "export prog|data b|i|s|d <start> <end> <path> [baseline]"},
+    {"import",  script_import,      "import prog|data b|i|s|d <start> <end> <path>"},
+    {"console", script_console,     "console <path|->"},
+    {"stats",   script_statistics,  "stats"},
+    {"predictor", script_predictor, "predictor none|nottaken|btfn|bimodal|gshare|btb"},
+    {"cache",   script_cache,       "cache i|d off | cache i|d <size> <ways> <line size> lru|fifo|random <miss penalty>"},
+    {"profile", script_profile,     "profile off | profile <block size> [window cycles] | profile top [count] | profile heatmap <path> [all|reads|writes] | profile ws <path>"},
+    {"fusion",  script_fusion,      "fusion on|off"},
+    {"cfg",     script_control_flow, "cfg [dot path]"},
+    {"echo",    script_echo,        "echo <text>"},
+    {"exit",    script_exit,        "exit"},
+    {"help",    script_help,        "help"}
+};
+
+#define NUM_OF_SCRIPT_COMMANDS (int)(sizeof(script_commands) / sizeof(script_commands[0]))
+
+/**
+ * @brief Parse a hexadecimal value with an optional # or 0x prefix
+ *
+ * @param token Token to parse
+ * @param value Pointer to parsed value
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_value(char *token, int *value)
+{
+    if(*token == '#')
+    {
+        token++;
+    }
+    else if(token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+    {
+        token += 2;
+    }
+    if(*token == NUL)
+    {
+        return -1;
+    }
+    char *end;
+    long parsed_value = strtol(token, &end, 16);
+    if(*end != NUL || parsed_value < 0 || parsed_value > DATA_MEMORY_LENGTH)
+    {
+        return -1;
+    }
+    *value = (int)parsed_value;
+    return 0;
+}
+
+/**
+ * @brief Parse a decimal count
+ *
+ * @param token Token to parse
+ * @param count Pointer to parsed count
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_count(char *token, int *count)
+{
+    char *end;
+    long parsed_count = strtol(token, &end, 10);
+    if(*token == NUL || *end != NUL || parsed_count < 0 || parsed_count >= NO_CYCLE_LIMIT)
+    {
+        return -1;
+    }
+    *count = (int)parsed_count;
+    return 0;
+}
+
+/**
+ * @brief Select program or data memory by name
+ *
+ * @param program Program context
+ * @param token prog|data, or 0|1 as in the memory utilities
+ * @param memory Pointer to selected memory array
+ * @param record_type Pointer to S-Record type of the memory - NULL if unused
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_memory(program_t *program, char *token, byte_t **memory, record_type_t *record_type)
+{
+    if(strcmp(token, "prog") == 0 || (token[0] == INSTRUCTION_MEMORY && token[1] == NUL))
+    {
+        *memory = program->instruction_memory;
+        if(record_type != NULL)
+        {
+            *record_type = INSTRUCTION_TYPE;
+        }
+        return 0;
+    }
+    if(strcmp(token, "data") == 0 || (token[0] == DATA_MEMORY && token[1] == NUL))
+    {
+        *memory = program->data_memory;
+        if(record_type != NULL)
+        {
+            *record_type = DATA_TYPE;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse a register name - r0 to r7, bp, lr, sp or pc
+ *
+ * @param token Token to parse
+ * @param register_number Pointer to register number
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_register(char *token, int *register_number)
+{
+    if((token[0] == 'r' || token[0] == 'R') && token[1] >= '0'
+        && token[1] < '0' + REGISTER_FILE_LENGTH && token[2] == NUL)
+    {
+        *register_number = token[1] - '0';
+        return 0;
+    }
+    const char *register_names[] = {"bp", "lr", "sp", "pc"};
+    const int register_numbers[] = {BP, LR, SP, PC};
+    for(int i = 0; i < 4; i++)
+    {
+        if(strcmp(token, register_names[i]) == 0)
+        {
+            *register_number = register_numbers[i];
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse a memory type, format and address range shared by export and import
+ *
+ * @param program Program context
+ * @param argument_values Arguments starting at the memory type
+ * @param memory Pointer to selected memory array
+ * @param record_type Pointer to S-Record type of the memory
+ * @param format Pointer to selected format
+ * @param start_address Pointer to first address
+ * @param end_address Pointer to address after the last byte
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int parse_transfer(program_t *program, char **argument_values, byte_t **memory, record_type_t *record_type,
+    export_format_t *format, int *start_address, int *end_address)
+{
+    char *format_token = argument_values[1];
+    if(parse_memory(program, argument_values[0], memory, record_type) != 0
+        || format_token[0] == NUL || format_token[1] != NUL
+        || parse_value(argument_values[2], start_address) != 0
+        || parse_value(argument_values[3], end_address) != 0)
+    {
+        return -1;
+    }
+    switch(format_token[0])
+    {
+    case FORMAT_BINARY:
+    case FORMAT_INTEL_HEX:
+    case FORMAT_S_RECORD:
+    case FORMAT_DIFF:
+        *format = (export_format_t)format_token[0];
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+/**
+ * @brief load <path> - Load an xme file
+ */
+static int script_load(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count != 2)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    return (load_memory(program, argument_values[1]) == 0) ? 0 : SCRIPT_COMMAND_ERROR;
+}
+
+/**
+ * @brief reset - Restart the loaded program
+ */
+static int script_reset(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) argument_values;
+    (void) result;
+    if(argument_count != 1)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    restart_program(program);
+    return 0;
+}
+
+/**
+ * @brief break [add] <address> | break clear - Set or clear the breakpoint
+ */
+static int script_break(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count == 2 && strcmp(argument_values[1], "clear") == 0)
+    {
+        program->breakpoint = NO_BREAKPOINT;
+        return 0;
+    }
+    char *address_token;
+    if(argument_count == 2)
+    {
+        address_token = argument_values[1];
+    }
+    else if(argument_count == 3 && strcmp(argument_values[1], "add") == 0)
+    {
+        address_token = argument_values[2];
+    }
+    else
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int breakpoint_address;
+    if(parse_value(address_token, &breakpoint_address) != 0 || breakpoint_address >= INSTRUCTION_MEMORY_LENGTH)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    program->breakpoint = breakpoint_address;
+    return 0;
+}
+
+/**
+ * @brief run [cycles] - Run until breakpoint, or until the cycle count elapses
+ */
+static int script_run(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    int cycle_count = NO_CYCLE_LIMIT;
+    if(argument_count > 2 || (argument_count == 2 && parse_count(argument_values[1], &cycle_count) != 0))
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int cycle_status = run_cycles(program, cycle_count);
+    printf("%s. PC: %04x Clock: %d CVNZ: %d%d%d%d\n",
+        cycle_status == CYCLE_BREAKPOINT ? "Breakpoint Reached" : "Cycle Limit Reached",
+        program->PROGRAM_COUNTER, program->clock_cycles,
+        PSW_BIT(program->program_status_word, PSW_CARRY_BIT), PSW_BIT(program->program_status_word, PSW_OVERFLOW_BIT),
+        PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT), PSW_BIT(program->program_status_word, PSW_ZERO_BIT));
+    return 0;
+}
+
+/**
+ * @brief dump prog|data <start> <end> - Print a memory range
+ */
+static int script_dump(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    byte_t *memory;
+    int start_address;
+    int end_address;
+    if(argument_count != 4 || parse_memory(program, argument_values[1], &memory, NULL) != 0
+        || parse_value(argument_values[2], &start_address) != 0
+        || parse_value(argument_values[3], &end_address) != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    if(display_memory(memory, start_address, end_address))
+    {
+        printf("Invalid Address\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief write prog|data <address> <word> - Write a word to memory
+ */
+static int script_write(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    byte_t *memory;
+    int address;
+    int word;
+    if(argument_count != 4 || parse_memory(program, argument_values[1], &memory, NULL) != 0
+        || parse_value(argument_values[2], &address) != 0
+        || parse_value(argument_values[3], &word) != 0 || word > 0xFFFF)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    if(address + 1 >= DATA_MEMORY_LENGTH)
+    {
+        printf("Invalid Address\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    write_memory_word(memory, (word_t)address, (word_t)word);
+    return 0;
+}
+
+/**
+ * @brief reg | reg set <register> <value> - Dump or set registers
+ */
+static int script_register(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count == 1)
+    {
+        register_dump(program->register_file[REGISTER]);
+        return 0;
+    }
+    int register_number;
+    int register_value;
+    if(argument_count != 4 || strcmp(argument_values[1], "set") != 0
+        || parse_register(argument_values[2], &register_number) != 0
+        || parse_value(argument_values[3], &register_value) != 0 || register_value > 0xFFFF)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    program->register_file[REGISTER][register_number] = (word_t) register_value;
+    return 0;
+}
+
+/**
+ * @brief expect <target> ==|!= <value> - Compare machine state against a value
+ */
+static int script_expect(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    int actual;
+    int argument = 1;
+    int register_number;
+    int address;
+    byte_t *memory;
+    if(argument_count < 4)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+
+    /* Read Target */
+    if(parse_register(argument_values[argument], &register_number) == 0)
+    {
+        actual = program->register_file[REGISTER][register_number];
+        argument++;
+    }
+    else if(strcmp(argument_values[argument], "psw") == 0)
+    {
+        actual = program->program_status_word;
+        argument++;
+    }
+    else if(strcmp(argument_values[argument], "cycles") == 0)
+    {
+        actual = program->clock_cycles;
+        argument++;
+    }
+    else if(strcmp(argument_values[argument], "instructions") == 0)
+    {
+        actual = program->statistics.instructions_retired;
+        argument++;
+    }
+    else if(argument_count == 5 && parse_memory(program, argument_values[argument], &memory, NULL) == 0
+        && parse_value(argument_values[argument + 1], &address) == 0 && address + 1 < DATA_MEMORY_LENGTH)
+    {
+        actual = read_memory_word(memory, (word_t)address);
+        argument += 2;
+    }
+    else
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+
+    /* Read Comparison */
+    int expected;
+    if(argument + 2 != argument_count || parse_value(argument_values[argument + 1], &expected) != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int equal = (strcmp(argument_values[argument], "==") == 0);
+    if(!equal && strcmp(argument_values[argument], "!=") != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int pass = ((actual == expected) == equal);
+
+    printf("%s line %d:", pass ? "PASS" : "FAIL", result->line_number);
+    for(int i = 1; i < argument_count; i++)
+    {
+        printf(" %s", argument_values[i]);
+    }
+    if(pass)
+    {
+        printf("\n");
+        result->passed++;
+    }
+    else
+    {
+        printf(" (actual %04x)\n", actual);
+        result->failed++;
+    }
+    return 0;
+}
+
+/**
+ * @brief debug on|off - Set debug mode
+ */
+static int script_debug(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count == 2 && strcmp(argument_values[1], "on") == 0)
+    {
+        program->debug_mode = 1;
+    }
+    else if(argument_count == 2 && strcmp(argument_values[1], "off") == 0)
+    {
+        program->debug_mode = 0;
+    }
+    else
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief export prog|data <format> <start> <end> <path> [baseline] - Export a memory range
+ */
+static int script_export(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    byte_t *memory;
+    record_type_t record_type;
+    export_format_t format;
+    int start_address;
+    int end_address;
+    if(argument_count < 6 || argument_count > 7
+        || parse_transfer(program, &argument_values[1], &memory, &record_type, &format, &start_address, &end_address) != 0
+        || (format == FORMAT_DIFF) != (argument_count == 7))
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int error_status = export_memory_file(memory, start_address, end_address, format, record_type,
+        argument_values[5], argument_count == 7 ? argument_values[6] : NULL);
+    if(error_status == EXPORT_FILE_ERROR)
+    {
+        printf("Error Opening File\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    if(error_status < 0)
+    {
+        printf("Invalid Export\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief import prog|data <format> <start> <end> <path> - Import a memory range
+ */
+static int script_import(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    byte_t *memory;
+    record_type_t record_type;
+    export_format_t format;
+    int start_address;
+    int end_address;
+    if(argument_count != 6
+        || parse_transfer(program, &argument_values[1], &memory, &record_type, &format, &start_address, &end_address) != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    int imported_bytes = import_memory_file(memory, start_address, end_address, format, argument_values[5]);
+    if(imported_bytes == EXPORT_FILE_ERROR)
+    {
+        printf("Error Opening File\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    if(imported_bytes == IMPORT_RECORD_ERROR)
+    {
+        printf("Invalid Record - Nothing Imported\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    if(imported_bytes < 0)
+    {
+        printf("Invalid Import\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    printf("Imported %d Bytes\n", imported_bytes);
+    return 0;
+}
+
+/**
+ * @brief console <path|-> - Select the console device output
+ */
+static int script_console(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count != 2)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    if(set_console_output(program, argument_values[1]) != 0)
+    {
+        printf("Error Opening File\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief stats - Print pipeline statistics
+ */
+static int script_statistics(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) argument_values;
+    (void) result;
+    if(argument_count != 1)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    display_statistics(program);
+    display_branch_predictor(program);
+    display_caches(program);
+    display_data_profile(program, PROFILE_DEFAULT_TOP);
+    return 0;
+}
+
+/**
+ * @brief predictor <scheme> - Select the branch prediction model
+ */
+static int script_predictor(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count != 2 || set_branch_predictor(program, argument_values[1]) != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief cache i|d <configuration> - Configure or disable a cache model
+ */
+static int script_cache(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    cache_select_t select;
+    if(argument_count < 3 || (strcmp(argument_values[1], "i") != 0 && strcmp(argument_values[1], "d") != 0))
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    select = (argument_values[1][0] == 'i') ? INSTRUCTION_CACHE : DATA_CACHE;
+    if(argument_count == 3 && strcmp(argument_values[2], "off") == 0)
+    {
+        set_cache(program, select, NULL);
+        return 0;
+    }
+
+    cache_config_t config;
+    int policy;
+    if(argument_count != 7 || parse_count(argument_values[2], &config.size) != 0
+        || parse_count(argument_values[3], &config.associativity) != 0
+        || parse_count(argument_values[4], &config.line_size) != 0
+        || (policy = parse_cache_policy(argument_values[5])) < 0
+        || parse_count(argument_values[6], &config.miss_penalty) != 0)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    config.policy = (cache_policy_t)policy;
+    if(set_cache(program, select, &config) != 0)
+    {
+        printf("Invalid Cache Configuration\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief profile <configuration> | profile top|heatmap|ws - Configure the data memory profile or report it
+ */
+static int script_profile(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count < 2)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    if(strcmp(argument_values[1], "off") == 0 && argument_count == 2)
+    {
+        set_data_profile(program, 0, 0);
+        return 0;
+    }
+
+    int export_status = 0;
+    if(strcmp(argument_values[1], "top") == 0)
+    {
+        int top_count = PROFILE_DEFAULT_TOP;
+        if(argument_count > 3 || (argument_count == 3 && parse_count(argument_values[2], &top_count) != 0))
+        {
+            return SCRIPT_USAGE_ERROR;
+        }
+        if(program->settings.data_profile == NULL)
+        {
+            printf("Data Profile Disabled\n");
+            return SCRIPT_COMMAND_ERROR;
+        }
+        display_data_profile(program, top_count);
+        return 0;
+    }
+    else if(strcmp(argument_values[1], "heatmap") == 0)
+    {
+        int select = PROFILE_ALL;
+        if(argument_count < 3 || argument_count > 4
+            || (argument_count == 4 && (select = parse_profile_select(argument_values[3])) < 0))
+        {
+            return SCRIPT_USAGE_ERROR;
+        }
+        export_status = export_profile_heatmap(program, argument_values[2], (profile_select_t)select);
+    }
+    else if(strcmp(argument_values[1], "ws") == 0)
+    {
+        if(argument_count != 3)
+        {
+            return SCRIPT_USAGE_ERROR;
+        }
+        export_status = export_working_set(program, argument_values[2]);
+    }
+    else
+    {
+        int block_size;
+        int window_cycles = PROFILE_DEFAULT_WINDOW;
+        if(argument_count > 3 || parse_count(argument_values[1], &block_size) != 0
+            || (argument_count == 3 && parse_count(argument_values[2], &window_cycles) != 0))
+        {
+            return SCRIPT_USAGE_ERROR;
+        }
+        if(set_data_profile(program, block_size, window_cycles) != 0)
+        {
+            printf("Invalid Data Profile Configuration\n");
+            return SCRIPT_COMMAND_ERROR;
+        }
+        return 0;
+    }
+
+    if(export_status == -1)
+    {
+        printf("Data Profile Disabled\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    else if(export_status != 0)
+    {
+        printf("Error Opening File\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief fusion on|off - Execute common instruction pairs as one operation
+ */
+static int script_fusion(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count != 2 || (strcmp(argument_values[1], "on") != 0 && strcmp(argument_values[1], "off") != 0))
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    program->settings.fusion_disabled = (strcmp(argument_values[1], "off") == 0);
+    return 0;
+}
+
+/**
+ * @brief cfg [dot path] - Build the control flow graph now and on each load, writing it as DOT
+ */
+static int script_control_flow(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) result;
+    if(argument_count > 2)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    if(set_control_flow(program, (argument_count == 2) ? argument_values[1] : NULL) != 0
+        || build_control_flow(program) != 0)
+    {
+        printf("Error Building Control Flow Graph\n");
+        return SCRIPT_COMMAND_ERROR;
+    }
+    return 0;
+}
+
+/**
+ * @brief echo <text> - Print text to the console
+ */
+static int script_echo(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) program;
+    (void) result;
+    for(int i = 1; i < argument_count; i++)
+    {
+        printf(i == 1 ? "%s" : " %s", argument_values[i]);
+    }
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief exit - Stop reading commands
+ */
+static int script_exit(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) program;
+    (void) argument_values;
+    if(argument_count != 1)
+    {
+        return SCRIPT_USAGE_ERROR;
+    }
+    result->exit = 1;
+    return 0;
+}
+
+/**
+ * @brief help - Print command usage
+ */
+static int script_help(program_t *program, int argument_count, char **argument_values, script_result_t *result)
+{
+    (void) program;
+    (void) argument_count;
+    (void) argument_values;
+    (void) result;
+    printf("Script Commands:\n");
+    for(int i = 0; i < NUM_OF_SCRIPT_COMMANDS; i++)
+    {
+        printf("%s\n", script_commands[i].usage);
+    }
+    return 0;
+}
+
+/**
+ * @brief Split a line into whitespace separated arguments in place
+ *
+ * @param line Line to split
+ * @param argument_values Array of MAX_SCRIPT_ARGUMENTS argument pointers
+ * @return int Number of arguments, < 0 = Too Many Arguments
+ */
+static int split_arguments(char *line, char **argument_values)
+{
+    int argument_count = 0;
+    char *position = line;
+    while(1)
+    {
+        while(isspace((unsigned char)*position))
+        {
+            position++;
+        }
+        if(*position == NUL)
+        {
+            return argument_count;
+        }
+        if(argument_count == MAX_SCRIPT_ARGUMENTS)
+        {
+            return -1;
+        }
+        argument_values[argument_count++] = position;
+        while(*position != NUL && !isspace((unsigned char)*position))
+        {
+            position++;
+        }
+        if(*position != NUL)
+        {
+            *position++ = NUL;
+        }
+    }
+}
+
+/**
+ * @brief Execute a single script line
+ *
+ * @param program Program context
+ * @param line Line to execute - modified in place
+ * @param result Script results
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int run_script_line(program_t *program, char *line, script_result_t *result)
+{
+    char *comment = line;
+    while(isspace((unsigned char)*comment))
+    {
+        comment++;
+    }
+    if(*comment == SCRIPT_COMMENT)
+    {
+        return 0;
+    }
+
+    char *argument_values[MAX_SCRIPT_ARGUMENTS];
+    int argument_count = split_arguments(line, argument_values);
+    if(argument_count < 0)
+    {
+        printf("ERROR line %d: Too Many Arguments\n", result->line_number);
+        result->errors++;
+        return -1;
+    }
+    if(argument_count == 0)
+    {
+        /* Blank Line */
+        return 0;
+    }
+
+    for(int i = 0; i < NUM_OF_SCRIPT_COMMANDS; i++)
+    {
+        if(strcmp(argument_values[0], script_commands[i].name) == 0)
+        {
+            int error_status = script_commands[i].handler(program, argument_count, argument_values, result);
+            if(error_status == SCRIPT_USAGE_ERROR)
+            {
+                printf("ERROR line %d: Usage: %s\n", result->line_number, script_commands[i].usage);
+            }
+            if(error_status < 0)
+            {
+                result->errors++;
+            }
+            return error_status;
+        }
+    }
+    printf("ERROR line %d: Unknown Command: %s\n", result->line_number, argument_values[0]);
+    result->errors++;
+    return -1;
+}
+
+/**
+ * @brief Run a command script without prompting
+ *
+ * @param program Program context
+ * @param path Script path - SCRIPT_STDIN to read from stdin
+ * @return int Number of failed expectations and errors, < 0 = Script Not Opened
+ */
+int run_script(program_t *program, char *path)
+{
+    FILE *file = stdin;
+    if(strcmp(path, SCRIPT_STDIN) != 0 && fopen_s(&file, path, "r") != 0)
+    {
+        printf("Error Opening Script: %s\n", path);
+        return -1;
+    }
+
+    script_result_t result = {0};
+    char line[MAX_SCRIPT_LINE_LENGTH];
+    while(!result.exit && fgets(line, sizeof(line), file))
+    {
+        result.line_number++;
+        (void) run_script_line(program, line, &result);
+    }
+    if(file != stdin)
+    {
+        fclose(file);
+    }
+
+    printf("Script Complete: %d Passed, %d Failed, %d Errors\n", result.passed, result.failed, result.errors);
+    return result.failed + result.errors;
+}
@@ -0,0 +1,651 @@
+/**
+ * @file server.c
+ * @brief Emulator daemon serving warm contexts over a Unix domain socket
+ *
+ * Contexts stay loaded between requests, so a harness can load an image once,
+ * snapshot it, and restore the snapshot before each test instead of starting
+ * a new process.  Clients send framed requests and may queue any number before
+ * reading replies; each batch of received requests is answered with a single
+ * send.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-22
+ */
+
+#include "server.h"
+
+#ifdef WINDOWS
+
+/**
+ * @brief Daemon mode requires Unix domain sockets
+ *
+ * @param socket_path Unused
+ * @return int -1
+ */
+int run_server(char *socket_path)
+{
+    (void) socket_path;
+    printf("Daemon Mode Unavailable\n");
+    return -1;
+}
+
+#else
+
+/**
+ * @brief Ensure a buffer can hold additional bytes
+ *
+ * @param buffer Buffer to grow
+ * @param additional Number of bytes to append
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int buffer_reserve(server_buffer_t *buffer, size_t additional)
+{
+    if(buffer->length + additional <= buffer->capacity)
+    {
+        return 0;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity : SERVER_RECEIVE_LENGTH;
+    while(capacity < buffer->length + additional)
+    {
+        capacity *= 2;
+    }
+    byte_t *data = realloc(buffer->data, capacity);
+    if(data == NULL)
+    {
+        return -1;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+/**
+ * @brief Discard bytes from the front of a buffer
+ *
+ * @param buffer Buffer to consume from
+ * @param length Number of bytes
+ */
+static void buffer_consume(server_buffer_t *buffer, size_t length)
+{
+    memmove(buffer->data, buffer->data + length, buffer->length - length);
+    buffer->length -= length;
+}
+
+/**
+ * @brief Read a little endian word
+ */
+static word_t read_u16(const byte_t *data)
+{
+    return (word_t)(data[0] | (data[1] << 8));
+}
+
+/**
+ * @brief Read a little endian 32 bit value
+ */
+static unsigned int read_u32(const byte_t *data)
+{
+    return (unsigned int)data[0] | ((unsigned int)data[1] << 8)
+        | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+}
+
+/**
+ * @brief Write a little endian word
+ */
+static void write_u16(byte_t *data, word_t value)
+{
+    data[0] = (byte_t)(value & EIGHT_BITS);
+    data[1] = (byte_t)(value >> 8);
+}
+
+/**
+ * @brief Write a little endian 32 bit value
+ */
+static void write_u32(byte_t *data, unsigned int value)
+{
+    write_u16(data, (word_t)(value & 0xFFFF));
+    write_u16(data + 2, (word_t)(value >> 16));
+}
+
+/**
+ * @brief Append a reply frame to a client's output
+ *
+ * @param client Client receiving the reply
+ * @param status Reply status
+ * @param context Context id
+ * @param tag Request tag
+ * @param payload Reply payload - NULL if reserved by the caller
+ * @param length Payload length
+ * @return byte_t* Payload in the output buffer, NULL = FAILURE
+ */
+static byte_t *append_reply(server_client_t *client, server_status_t status, int context, word_t tag,
+    const void *payload, size_t length)
+{
+    if(buffer_reserve(&client->output, FRAME_HEADER_LENGTH + length) != 0)
+    {
+        return NULL;
+    }
+    byte_t *header = client->output.data + client->output.length;
+    write_u32(header, (unsigned int)length);
+    header[4] = (byte_t)status;
+    header[5] = (byte_t)context;
+    write_u16(header + 6, tag);
+    if(payload != NULL)
+    {
+        memcpy(header + FRAME_HEADER_LENGTH, payload, length);
+    }
+    client->output.length += FRAME_HEADER_LENGTH + length;
+    return header + FRAME_HEADER_LENGTH;
+}
+
+/**
+ * @brief Pack the register space - R0 - R7, PSW, clock cycles
+ *
+ * @param program Program context
+ * @param registers Destination of REGISTER_SPACE_LENGTH bytes
+ */
+static void pack_registers(program_t *program, byte_t *registers)
+{
+    for(int i = 0; i < REGISTER_FILE_LENGTH; i++)
+    {
+        write_u16(registers + i * WORD_LENGTH, program->register_file[REGISTER][i]);
+    }
+    write_u16(registers + REGISTER_FILE_LENGTH * WORD_LENGTH, program->program_status_word);
+    write_u32(registers + (REGISTER_FILE_LENGTH + 1) * WORD_LENGTH, (unsigned int)program->clock_cycles);
+}
+
+/**
+ * @brief Read a memory space range
+ *
+ * @param program Program context
+ * @param payload Request payload - u8 space, u16 address, u32 length
+ * @param client Client receiving the reply
+ * @param context Context id
+ * @param tag Request tag
+ * @return server_status_t Status if no reply was appended, STATUS_OK otherwise
+ */
+static server_status_t dump_space(program_t *program, const byte_t *payload, server_client_t *client, int context, word_t tag)
+{
+    unsigned int address = read_u16(payload + 1);
+    unsigned int length = read_u32(payload + 3);
+    byte_t registers[REGISTER_SPACE_LENGTH];
+    const byte_t *source;
+    unsigned int space_length;
+    switch(payload[0])
+    {
+    case SPACE_INSTRUCTION:
+        source = program->instruction_memory;
+        space_length = INSTRUCTION_MEMORY_LENGTH;
+        break;
+    case SPACE_DATA:
+        source = program->data_memory;
+        space_length = DATA_MEMORY_LENGTH;
+        break;
+    case SPACE_REGISTERS:
+        pack_registers(program, registers);
+        source = registers;
+        space_length = REGISTER_SPACE_LENGTH;
+        break;
+    default:
+        return STATUS_BAD_REQUEST;
+    }
+    if(address > space_length || length > space_length - address)
+    {
+        return STATUS_BAD_REQUEST;
+    }
+    return append_reply(client, STATUS_OK, context, tag, source + address, length) != NULL ? STATUS_OK : STATUS_FAILED;
+}
+
+/**
+ * @brief Write bytes to a memory space
+ *
+ * @param program Program context
+ * @param payload Request payload - u8 space, u16 address, bytes
+ * @param payload_length Payload length
+ * @return server_status_t Reply status
+ */
+static server_status_t poke_space(program_t *program, const byte_t *payload, unsigned int payload_length)
+{
+    unsigned int address = read_u16(payload + 1);
+    unsigned int length = payload_length - 3;
+    const byte_t *data = payload + 3;
+    switch(payload[0])
+    {
+    case SPACE_INSTRUCTION:
+    case SPACE_DATA:
+        if(length > DATA_MEMORY_LENGTH - address)
+        {
+            return STATUS_BAD_REQUEST;
+        }
+        memcpy((payload[0] == SPACE_DATA ? program->data_memory : program->instruction_memory) + address, data, length);
+        return STATUS_OK;
+    case SPACE_REGISTERS:
+    {
+        /* Whole words of R0 - R7 and PSW - clock cycles are read only */
+        unsigned int writable_length = (REGISTER_FILE_LENGTH + 1) * WORD_LENGTH;
+        if((address | length) & BYTE_LENGTH || length > writable_length || address > writable_length - length)
+        {
+            return STATUS_BAD_REQUEST;
+        }
+        byte_t registers[REGISTER_SPACE_LENGTH];
+        pack_registers(program, registers);
+        memcpy(registers + address, data, length);
+        for(int i = 0; i < REGISTER_FILE_LENGTH; i++)
+        {
+            program->register_file[REGISTER][i] = read_u16(registers + i * WORD_LENGTH);
+        }
+        program->program_status_word = read_u16(registers + REGISTER_FILE_LENGTH * WORD_LENGTH) & PSW_DEFINED_MASK;
+        update_event_cycle(program);
+        return STATUS_OK;
+    }
+    default:
+        return STATUS_BAD_REQUEST;
+    }
+}
+
+/**
+ * @brief Process one request, appending its reply
+ *
+ * @param server Daemon state
+ * @param client Client sending the request
+ * @param frame Request frame
+ * @param payload_length Payload length
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int handle_request(server_t *server, server_client_t *client, const byte_t *frame, unsigned int payload_length)
+{
+    server_operation_t operation = (server_operation_t)frame[4];
+    int context = frame[5];
+    word_t tag = read_u16(frame + 6);
+    const byte_t *payload = frame + FRAME_HEADER_LENGTH;
+    server_status_t status = STATUS_OK;
+    program_t *program = (context < SERVER_MAX_CONTEXTS) ? server->contexts[context] : NULL;
+
+    /* Operations on an existing context */
+    if(program == NULL && operation != OPERATION_CREATE && operation != OPERATION_SHUTDOWN)
+    {
+        return append_reply(client, STATUS_NO_CONTEXT, context, tag, NULL, 0) != NULL ? 0 : -1;
+    }
+
+    switch(operation)
+    {
+    case OPERATION_CREATE:
+        for(context = 0; context < SERVER_MAX_CONTEXTS && server->contexts[context] != NULL; context++);
+        if(context == SERVER_MAX_CONTEXTS)
+        {
+            status = STATUS_FULL;
+            context = 0;
+            break;
+        }
+        server->contexts[context] = calloc(1, sizeof(program_t));
+        if(server->contexts[context] == NULL)
+        {
+            status = STATUS_FAILED;
+            break;
+        }
+        restart_program(server->contexts[context]);
+        break;
+
+    case OPERATION_DESTROY:
+        flush_console(program);
+        release_statistics(program);
+        release_branch_predictor(program);
+        release_caches(program);
+        release_data_profile(program);
+        free(server->contexts[context]);
+        free(server->snapshots[context]);
+        server->contexts[context] = NULL;
+        server->snapshots[context] = NULL;
+        break;
+
+    case OPERATION_LOAD:
+    {
+        char path[MAX_PATH_LENGTH];
+        if(payload_length == 0 || payload_length >= MAX_PATH_LENGTH)
+        {
+            status = STATUS_BAD_REQUEST;
+            break;
+        }
+        memcpy(path, payload, payload_length);
+        path[payload_length] = NUL;
+        status = (load_memory(program, path) == 0) ? STATUS_OK : STATUS_FAILED;
+        break;
+    }
+
+    case OPERATION_RESET:
+        restart_program(program);
+        break;
+
+    case OPERATION_RUN:
+    case OPERATION_STEP:
+    {
+        if(payload_length != 4)
+        {
+            status = STATUS_BAD_REQUEST;
+            break;
+        }
+        unsigned int count = read_u32(payload);
+        int limited_count = (count >= NO_CYCLE_LIMIT) ? NO_CYCLE_LIMIT : (int)count;
+        int cycle_status = (operation == OPERATION_RUN) ?
+            run_cycles(program, limited_count) : step_instructions(program, limited_count);
+        byte_t stop[STOP_REPLY_LENGTH];
+        stop[0] = (byte_t)cycle_status;
+        write_u16(stop + 1, program->PROGRAM_COUNTER);
+        write_u32(stop + 3, (unsigned int)program->clock_cycles);
+        return append_reply(client, STATUS_OK, context, tag, stop, STOP_REPLY_LENGTH) != NULL ? 0 : -1;
+    }
+
+    case OPERATION_BREAK:
+    {
+        unsigned int address = (payload_length == 4) ? read_u32(payload) : 0;
+        if(payload_length != 4 || (address >= INSTRUCTION_MEMORY_LENGTH && address != 0xFFFFFFFF))
+        {
+            status = STATUS_BAD_REQUEST;
+            break;
+        }
+        program->breakpoint = (address == 0xFFFFFFFF) ? NO_BREAKPOINT : (int)address;
+        break;
+    }
+
+    case OPERATION_SNAPSHOT:
+        if(server->snapshots[context] == NULL)
+        {
+            server->snapshots[context] = malloc(sizeof(program_t));
+            if(server->snapshots[context] == NULL)
+            {
+                status = STATUS_FAILED;
+                break;
+            }
+        }
+        /* Pending console output belongs to the run before the snapshot */
+        flush_console(program);
+        memcpy(server->snapshots[context], program, sizeof(program_t));
+        /* Models and files stay with the live context */
+        memset(&server->snapshots[context]->settings, 0, sizeof(emulator_settings_t));
+        break;
+
+    case OPERATION_RESTORE:
+    {
+        if(server->snapshots[context] == NULL)
+        {
+            status = STATUS_FAILED;
+            break;
+        }
+        flush_console(program);
+        /* Architectural state only - the live settings keep their models and files */
+        emulator_settings_t settings = program->settings;
+        memcpy(program, server->snapshots[context], sizeof(program_t));
+        program->settings = settings;
+        break;
+    }
+
+    case OPERATION_DUMP:
+        if(payload_length != 7)
+        {
+            status = STATUS_BAD_REQUEST;
+            break;
+        }
+        status = dump_space(program, payload, client, context, tag);
+        if(status == STATUS_OK)
+        {
+            /* Reply appended with data */
+            return 0;
+        }
+        break;
+
+    case OPERATION_POKE:
+        if(payload_length < 3)
+        {
+            status = STATUS_BAD_REQUEST;
+            break;
+        }
+        status = poke_space(program, payload, payload_length);
+        break;
+
+    case OPERATION_SHUTDOWN:
+        server->shutdown = 1;
+        break;
+
+    default:
+        status = STATUS_BAD_REQUEST;
+        break;
+    }
+    return append_reply(client, status, context, tag, NULL, 0) != NULL ? 0 : -1;
+}
+
+/**
+ * @brief Process every complete request frame received from a client
+ *
+ * @param server Daemon state
+ * @param client Client to process
+ * @return int [0 = SUCCESS, < 0 = Protocol Error]
+ */
+static int process_requests(server_t *server, server_client_t *client)
+{
+    size_t position = 0;
+    while(!server->shutdown && client->input.length - position >= FRAME_HEADER_LENGTH)
+    {
+        const byte_t *frame = client->input.data + position;
+        unsigned int payload_length = read_u32(frame);
+        if(payload_length > SERVER_MAX_FRAME)
+        {
+            return -1;
+        }
+        if(client->input.length - position < FRAME_HEADER_LENGTH + payload_length)
+        {
+            /* Wait for remainder of frame */
+            break;
+        }
+        if(handle_request(server, client, frame, payload_length) != 0)
+        {
+            return -1;
+        }
+        position += FRAME_HEADER_LENGTH + payload_length;
+    }
+    buffer_consume(&client->input, position);
+    return 0;
+}
+
+/**
+ * @brief Send as much pending output as the socket accepts
+ *
+ * @param client Client to send to
+ * @return int [0 = SUCCESS, < 0 = Connection Closed]
+ */
+static int send_output(server_client_t *client)
+{
+    while(client->output_position < client->output.length)
+    {
+        ssize_t sent = send(client->connection, client->output.data + client->output_position,
+            client->output.length - client->output_position, MSG_NOSIGNAL);
+        if(sent < 0)
+        {
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        client->output_position += (size_t)sent;
+    }
+    client->output.length = 0;
+    client->output_position = 0;
+    return 0;
+}
+
+/**
+ * @brief Close a client connection and release its buffers
+ *
+ * @param client Client to close
+ */
+static void close_client(server_client_t *client)
+{
+    close(client->connection);
+    free(client->input.data);
+    free(client->output.data);
+    memset(client, 0, sizeof(server_client_t));
+    client->connection = -1;
+}
+
+/**
+ * @brief Serve requests on a Unix domain socket until shut down
+ *
+ * @param socket_path Path of the socket to create
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int run_server(char *socket_path)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(socket_path == NULL || strlen(socket_path) >= sizeof(address.sun_path))
+    {
+        return -1;
+    }
+    strcpy_s(address.sun_path, sizeof(address.sun_path), socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0)
+    {
+        return -1;
+    }
+    (void) unlink(socket_path);
+    if(bind(listener, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listener, SERVER_MAX_CLIENTS) != 0)
+    {
+        printf("Error Opening Socket: %s\n", socket_path);
+        close(listener);
+        return -2;
+    }
+
+    server_t *server = calloc(1, sizeof(server_t));
+    if(server == NULL)
+    {
+        close(listener);
+        return -1;
+    }
+    for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+    {
+        server->clients[i].connection = -1;
+    }
+    printf("Serving on %s\n", socket_path);
+    fflush(stdout);
+
+    struct pollfd poll_set[SERVER_MAX_CLIENTS + 1];
+    while(1)
+    {
+        /* Stop once every reply has been sent */
+        int pending_output = 0;
+        for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+        {
+            pending_output |= (server->clients[i].connection >= 0 && server->clients[i].output.length > 0);
+        }
+        if(server->shutdown && !pending_output)
+        {
+            break;
+        }
+
+        poll_set[0].fd = server->shutdown ? -1 : listener;
+        poll_set[0].events = POLLIN;
+        for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+        {
+            server_client_t *client = &server->clients[i];
+            poll_set[i + 1].fd = client->connection;
+            poll_set[i + 1].events = (short)((server->shutdown ? 0 : POLLIN) | (client->output.length > 0 ? POLLOUT : 0));
+            poll_set[i + 1].revents = 0;
+        }
+        if(poll(poll_set, SERVER_MAX_CLIENTS + 1, -1) < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        /* Accept new clients */
+        if(poll_set[0].revents & POLLIN)
+        {
+            int connection = accept(listener, NULL, NULL);
+            int slot;
+            for(slot = 0; slot < SERVER_MAX_CLIENTS && server->clients[slot].connection >= 0; slot++);
+            if(connection >= 0 && slot == SERVER_MAX_CLIENTS)
+            {
+                close(connection);
+            }
+            else if(connection >= 0)
+            {
+                fcntl(connection, F_SETFL, fcntl(connection, F_GETFL) | O_NONBLOCK);
+                server->clients[slot].connection = connection;
+            }
+        }
+
+        for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+        {
+            server_client_t *client = &server->clients[i];
+            short events = poll_set[i + 1].revents;
+            if(client->connection < 0 || events == 0)
+            {
+                continue;
+            }
+            int error_status = 0;
+            if(events & (POLLIN | POLLHUP | POLLERR))
+            {
+                /* Read everything available, then answer the batch */
+                while(error_status == 0)
+                {
+                    if(buffer_reserve(&client->input, SERVER_RECEIVE_LENGTH) != 0)
+                    {
+                        error_status = -1;
+                        break;
+                    }
+                    ssize_t received = recv(client->connection, client->input.data + client->input.length, SERVER_RECEIVE_LENGTH, 0);
+                    if(received > 0)
+                    {
+                        client->input.length += (size_t)received;
+                        continue;
+                    }
+                    if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        break;
+                    }
+                    /* Closed by client - answer requests already received */
+                    error_status = 1;
+                }
+                if(error_status >= 0 && process_requests(server, client) != 0)
+                {
+                    error_status = -1;
+                }
+            }
+            if(error_status >= 0 && send_output(client) != 0)
+            {
+                error_status = -1;
+            }
+            if(error_status != 0)
+            {
+                close_client(client);
+            }
+        }
+    }
+
+    for(int i = 0; i < SERVER_MAX_CLIENTS; i++)
+    {
+        if(server->clients[i].connection >= 0)
+        {
+            close_client(&server->clients[i]);
+        }
+    }
+    for(int i = 0; i < SERVER_MAX_CONTEXTS; i++)
+    {
+        if(server->contexts[i] != NULL)
+        {
+            close_console(server->contexts[i]);
+            release_statistics(server->contexts[i]);
+            release_branch_predictor(server->contexts[i]);
+            release_caches(server->contexts[i]);
+            release_data_profile(server->contexts[i]);
+        }
+        free(server->contexts[i]);
+        free(server->snapshots[i]);
+    }
+    free(server);
+    close(listener);
+    (void) unlink(socket_path);
+    return 0;
+}
+
+#endif /* WINDOWS */
@@ -0,0 +1,132 @@
+/**
+ * @file statistics.c
+ * @brief Pipeline hazard and stall accounting
+ *
+ * Every decode slot either retires an instruction or is lost to a bubble.
+ * Bubbles are counted by cause and attributed to the address of the
+ * instruction that queued them, so lost throughput can be traced to code.
+ *
+ * @author Zach Fraser
+ * @date 2024-08-24
+ */
+
+#include "statistics.h"
+
+/* Names printed for each bubble cause */
+static const char *bubble_cause_names[NUM_OF_BUBBLE_CAUSES] =
+{
+    "Taken Branch", "Load PC", "Register PC", "CEX Skip", "Exception", "Restart"
+};
+
+/**
+ * @brief Count a bubble and attribute it to the instruction that caused it
+ *
+ * @param program Program context
+ * @param cause Reason for the bubble
+ * @param source_address Address of the instruction causing the bubble
+ */
+void record_bubble(program_t *program, bubble_cause_t cause, word_t source_address)
+{
+    program->statistics.bubbles[cause]++;
+    if(program->settings.stall_counts == NULL)
+    {
+        /* Allocated on first bubble - kept across loads */
+        program->settings.stall_counts = calloc(STALL_TABLE_LENGTH, sizeof(unsigned int));
+        if(program->settings.stall_counts == NULL)
+        {
+            return;
+        }
+    }
+    program->settings.stall_counts[source_address >> 1]++;
+}
+
+/**
+ * @brief Clear pipeline counters and stall attribution
+ *
+ * @param program Program context
+ */
+void reset_statistics(program_t *program)
+{
+    memset(&program->statistics, 0, sizeof(pipeline_statistics_t));
+    if(program->settings.stall_counts != NULL)
+    {
+        memset(program->settings.stall_counts, 0, STALL_TABLE_LENGTH * sizeof(unsigned int));
+    }
+}
+
+/**
+ * @brief Free the stall attribution table
+ *
+ * @param program Program context
+ */
+void release_statistics(program_t *program)
+{
+    free(program->settings.stall_counts);
+    program->settings.stall_counts = NULL;
+}
+
+/**
+ * @brief Print pipeline counters, CPI and the addresses causing the most bubbles
+ *
+ * @param program Program context
+ */
+void display_statistics(program_t *program)
+{
+    pipeline_statistics_t *statistics = &program->statistics;
+    int total_bubbles = 0;
+    for(int i = 0; i < NUM_OF_BUBBLE_CAUSES; i++)
+    {
+        total_bubbles += statistics->bubbles[i];
+    }
+
+    printf("Pipeline Statistics\n");
+    printf("Clock Cycles: %d\n", program->clock_cycles);
+    printf("Instructions Retired: %d\n", statistics->instructions_retired);
+    if(statistics->instructions_retired > 0)
+    {
+        printf("CPI: %.3f\n", (double)program->clock_cycles / statistics->instructions_retired);
+    }
+    else
+    {
+        printf("CPI: -\n");
+    }
+    printf("Memory Stage Cycles: %d\n", statistics->memory_cycles);
+    printf("Bubbles: %d (%d Cycles)\n", total_bubbles, total_bubbles * CYCLES_PER_INSTRUCTION);
+    for(int i = 0; i < NUM_OF_BUBBLE_CAUSES; i++)
+    {
+        printf("  %-14s %d\n", bubble_cause_names[i], statistics->bubbles[i]);
+    }
+
+    /* Select the addresses with the most bubbles, highest first */
+    if(program->settings.stall_counts == NULL)
+    {
+        return;
+    }
+    int top_index[STALL_REPORT_LENGTH];
+    int top_count = 0;
+    for(int index = 0; index < STALL_TABLE_LENGTH; index++)
+    {
+        unsigned int stalls = program->settings.stall_counts[index];
+        if(stalls == 0 || (top_count == STALL_REPORT_LENGTH
+            && stalls <= program->settings.stall_counts[top_index[top_count - 1]]))
+        {
+            continue;
+        }
+        /* Insertion into the sorted list */
+        int position = (top_count < STALL_REPORT_LENGTH) ? top_count++ : top_count - 1;
+        while(position > 0 && program->settings.stall_counts[top_index[position - 1]] < stalls)
+        {
+            top_index[position] = top_index[position - 1];
+            position--;
+        }
+        top_index[position] = index;
+    }
+    if(top_count > 0)
+    {
+        printf("Bubbles by Address:\n");
+    }
+    for(int i = 0; i < top_count; i++)
+    {
+        printf("  #%04x: %u\n", top_index[i] << 1, program->settings.stall_counts[top_index[i]]);
+    }
+}
@@ -0,0 +1,244 @@
+/**
+ * @file trace.c
+ * @brief Compressed execution trace writer
+ *
+ * Each executed instruction (E0) and data memory access (E1) appends a
+ * record with the clock cycle, the address, the opcode or data, and the
+ * registers and PSW that changed since the last record. Records are
+ * compressed a block at a time and the block index is written when the
+ * trace is closed. A disabled trace is a NULL pointer and costs one test
+ * per stage.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-07
+ */
+
+#include "trace.h"
+
+/**
+ * @brief Compress the block being encoded and add it to the index
+ *
+ * @param trace Trace writer
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int flush_trace_block(trace_t *trace)
+{
+    if(trace->block.records == 0)
+    {
+        return 0;
+    }
+    if(trace->index_length == trace->index_capacity)
+    {
+        trace_block_t *index = realloc(trace->index, 2 * trace->index_capacity * sizeof(trace_block_t));
+        if(index == NULL)
+        {
+            return -1;
+        }
+        trace->index = index;
+        trace->index_capacity *= 2;
+    }
+
+    int compressed_length = compress_trace_block(trace->buffer, trace->length, trace->compressed);
+    if(fwrite(trace->compressed, 1, compressed_length, trace->file) != (size_t)compressed_length)
+    {
+        return -2;
+    }
+    trace->block.offset = trace->offset;
+    trace->block.compressed_length = (uint32_t)compressed_length;
+    trace->block.length = (uint32_t)trace->length;
+    trace->index[trace->index_length++] = trace->block;
+    trace->offset += compressed_length;
+
+    /* Next block starts without delta state */
+    memset(&trace->block, 0, sizeof(trace_block_t));
+    memset(&trace->state, 0, sizeof(trace_state_t));
+    trace->length = 0;
+    return 0;
+}
+
+/**
+ * @brief Start a trace file
+ *
+ * @param program Program context
+ * @param path Trace file path
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int open_trace(program_t *program, char *path)
+{
+    if(program == NULL || path == NULL)
+    {
+        return -1;
+    }
+    close_trace(program);
+    trace_t *trace = calloc(1, sizeof(trace_t));
+    if(trace == NULL)
+    {
+        return -2;
+    }
+    trace->index = malloc(TRACE_INDEX_INITIAL_LENGTH * sizeof(trace_block_t));
+    if(trace->index == NULL || fopen_s(&trace->file, path, "wb") != 0)
+    {
+        free(trace->index);
+        free(trace);
+        return -3;
+    }
+    trace->index_capacity = TRACE_INDEX_INITIAL_LENGTH;
+
+    byte_t header[TRACE_HEADER_LENGTH];
+    memcpy(header, TRACE_MAGIC, TRACE_MAGIC_LENGTH);
+    header[TRACE_MAGIC_LENGTH] = TRACE_VERSION;
+    fwrite(header, 1, TRACE_HEADER_LENGTH, trace->file);
+    trace->offset = TRACE_HEADER_LENGTH;
+    program->settings.trace = trace;
+    return 0;
+}
+
+/**
+ * @brief Note the registers written since the last record
+ *
+ * @param trace Trace writer
+ * @param program Program context
+ * @param record Record receiving the written registers
+ */
+static void trace_registers(trace_t *trace, program_t *program, trace_record_t *record)
+{
+    record->register_mask = 0;
+    for(int index = 0; index < TRACE_REGISTER_COUNT; index++)
+    {
+        word_t value = program->register_file[REGISTER][index];
+        if(value != trace->registers[index])
+        {
+            record->register_mask |= (byte_t)(1 << index);
+            record->registers[index] = value;
+            trace->registers[index] = value;
+        }
+    }
+}
+
+/**
+ * @brief Encode a record into the current block
+ *
+ * @param trace Trace writer
+ * @param record Record to append
+ */
+static void append_trace_record(trace_t *trace, trace_record_t *record)
+{
+    /* Deltas are forward only - a restart begins a new block */
+    if(trace->block.records > 0 && record->cycle < trace->block.last_cycle)
+    {
+        (void) flush_trace_block(trace);
+    }
+    if(trace->block.records == 0)
+    {
+        trace->block.first_cycle = record->cycle;
+    }
+    trace->length += encode_trace_record(&trace->state, record, &trace->buffer[trace->length]);
+    trace->block.last_cycle = record->cycle;
+    trace->block.records++;
+    trace->records++;
+
+    if(record->type == TRACE_EXECUTE)
+    {
+        TRACE_REGION_SET(trace->block.pc_regions, record->address);
+    }
+    else
+    {
+        byte_t *regions = (record->control == READ_BYTE || record->control == READ_WORD)
+            ? trace->block.read_regions : trace->block.write_regions;
+        TRACE_REGION_SET(regions, record->address);
+        if(record->control == READ_WORD || record->control == WRITE_WORD)
+        {
+            TRACE_REGION_SET(regions, record->address + 1);
+        }
+    }
+
+    if(trace->length >= TRACE_BLOCK_LENGTH)
+    {
+        (void) flush_trace_block(trace);
+    }
+}
+
+/**
+ * @brief Record an executed instruction
+ *
+ * @param program Program context
+ * @param instruction Instruction executed
+ */
+void trace_execute(program_t *program, instruction_t *instruction)
+{
+    trace_t *trace = program->settings.trace;
+    trace_record_t record;
+    record.type = TRACE_EXECUTE;
+    record.cycle = (uint32_t)program->clock_cycles;
+    record.address = instruction->address;
+    record.value = program->instruction_opcode;
+    record.psw_changed = (program->program_status_word != trace->psw);
+    record.psw = program->program_status_word;
+    trace->psw = program->program_status_word;
+    trace_registers(trace, program, &record);
+    append_trace_record(trace, &record);
+}
+
+/**
+ * @brief Record the data memory access just performed
+ *
+ * @param program Program context
+ */
+void trace_memory(program_t *program)
+{
+    trace_t *trace = program->settings.trace;
+    trace_record_t record;
+    record.type = TRACE_MEMORY;
+    record.cycle = (uint32_t)program->clock_cycles;
+    record.address = program->data_memory_address_register;
+    record.control = program->data_control_register;
+    record.value = program->data_memory_buffer_register;
+    record.psw_changed = 0;
+    trace_registers(trace, program, &record);
+    append_trace_record(trace, &record);
+}
+
+/**
+ * @brief Write the last block, the index and the trailer, then close the trace
+ *
+ * @param program Program context
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+int close_trace(program_t *program)
+{
+    trace_t *trace = program->settings.trace;
+    if(trace == NULL)
+    {
+        return 0;
+    }
+    int error_status = flush_trace_block(trace);
+
+    byte_t entry[TRACE_INDEX_ENTRY_LENGTH];
+    for(int block = 0; block < trace->index_length && error_status == 0; block++)
+    {
+        write_trace_index_entry(&trace->index[block], entry);
+        if(fwrite(entry, 1, TRACE_INDEX_ENTRY_LENGTH, trace->file) != TRACE_INDEX_ENTRY_LENGTH)
+        {
+            error_status = -1;
+        }
+    }
+    byte_t trailer[TRACE_TRAILER_LENGTH];
+    write_trace_u64(trailer, trace->offset);
+    write_trace_u32(&trailer[8], (uint32_t)trace->index_length);
+    memcpy(&trailer[12], TRACE_MAGIC, TRACE_MAGIC_LENGTH);
+    if(error_status == 0 && fwrite(trailer, 1, TRACE_TRAILER_LENGTH, trace->file) != TRACE_TRAILER_LENGTH)
+    {
+        error_status = -2;
+    }
+    if(fclose(trace->file) != 0 && error_status == 0)
+    {
+        error_status = -3;
+    }
+
+    printf("Trace: %u Records, %d Blocks, %llu Bytes Compressed\n", trace->records, trace->index_length,
+        (unsigned long long)trace->offset);
+    free(trace->index);
+    free(trace);
+    program->settings.trace = NULL;
+    return error_status;
+}
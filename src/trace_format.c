@@ -0,0 +1,544 @@
+/**
+ * @file trace_format.c
+ * @brief Compressed execution trace format
+ *
+ * A trace is a header, a series of compressed blocks and an index. Records
+ * store the clock cycle, addresses and registers as differences from the
+ * previous record, so most take a few bytes. The encoded records are
+ * compressed a block at a time with a byte oriented LZ77 scheme. The index
+ * at the end of the file holds each block's cycle range and a bitmap of the
+ * address regions it executed, read and wrote, so a query only decompresses
+ * the blocks that can match.
+ *
+ * Built into both the emulator and the trace query tool.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-07
+ */
+
+#include "trace_format.h"
+
+#define VARINT_BITS 7                       /* Seven bits per byte, low first */
+#define VARINT_MORE 0x80
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 0xFFFF
+#define LZ_HASH_BITS 12
+#define LZ_HASH_MULTIPLIER 2654435761u
+#define LZ_LENGTH_MASK 0x0F                 /* Token holds literal length high, match length low */
+#define LZ_LENGTH_EXTENDED 15               /* Length continues in following bytes */
+#define LZ_EXTENSION_MAX 255
+
+/**
+ * @brief Write an unsigned value seven bits per byte
+ *
+ * @param buffer Output
+ * @param value Value to write
+ * @return int Bytes written
+ */
+static int put_varint(byte_t *buffer, uint32_t value)
+{
+    int length = 0;
+    while(value >= VARINT_MORE)
+    {
+        buffer[length++] = (byte_t)((value & SEVEN_BITS) | VARINT_MORE);
+        value >>= VARINT_BITS;
+    }
+    buffer[length++] = (byte_t)value;
+    return length;
+}
+
+/**
+ * @brief Read an unsigned value written by put_varint
+ *
+ * @param buffer Input
+ * @param length Bytes available
+ * @param value Value read
+ * @return int [> 0 = Bytes read, < 0 = FAILURE]
+ */
+static int get_varint(const byte_t *buffer, int length, uint32_t *value)
+{
+    *value = 0;
+    for(int index = 0, shift = 0; index < length && shift < 32; index++, shift += VARINT_BITS)
+    {
+        *value |= (uint32_t)(buffer[index] & SEVEN_BITS) << shift;
+        if(!(buffer[index] & VARINT_MORE))
+        {
+            return index + 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Write an address difference - small steps either way are short
+ *
+ * @param buffer Output
+ * @param previous Previous address
+ * @param address New address
+ * @return int Bytes written
+ */
+static int put_address(byte_t *buffer, word_t previous, word_t address)
+{
+    int16_t delta = (int16_t)(word_t)(address - previous);
+    /* Zigzag - sign in the lowest bit */
+    return put_varint(buffer, (word_t)(((word_t)delta << 1) ^ (word_t)(delta >> 15)));
+}
+
+/**
+ * @brief Read an address written by put_address
+ *
+ * @param buffer Input
+ * @param length Bytes available
+ * @param previous Previous address
+ * @param address Address read
+ * @return int [> 0 = Bytes read, < 0 = FAILURE]
+ */
+static int get_address(const byte_t *buffer, int length, word_t previous, word_t *address)
+{
+    uint32_t zigzag;
+    int read = get_varint(buffer, length, &zigzag);
+    if(read > 0)
+    {
+        *address = (word_t)(previous + (word_t)((zigzag >> 1) ^ (0u - (zigzag & 1))));
+    }
+    return read;
+}
+
+/**
+ * @brief Encode a record after the previous record in the block
+ *
+ * @param state Delta state - updated
+ * @param record Record to encode
+ * @param buffer Output - at least TRACE_RECORD_MAX bytes
+ * @return int Bytes written
+ */
+int encode_trace_record(trace_state_t *state, trace_record_t *record, byte_t *buffer)
+{
+    byte_t header = (byte_t)record->type;
+    int length = 1;
+    length += put_varint(&buffer[length], record->cycle - state->cycle);
+    state->cycle = record->cycle;
+
+    if(record->type == TRACE_EXECUTE)
+    {
+        if(record->address == state->pc)
+        {
+            header |= TRACE_PC_SEQUENTIAL;
+        }
+        else
+        {
+            length += put_address(&buffer[length], state->pc, record->address);
+        }
+        state->pc = (word_t)(record->address + WORD_LENGTH);
+        header |= record->psw_changed ? TRACE_PSW_CHANGED : 0;
+    }
+    else
+    {
+        header |= (byte_t)(record->control << TRACE_CONTROL_SHIFT);
+        length += put_address(&buffer[length], state->data_address, record->address);
+        state->data_address = record->address;
+    }
+
+    /* Opcode, or data - bytes accesses store one byte */
+    buffer[length++] = (byte_t)(record->value & EIGHT_BITS);
+    if(record->type == TRACE_EXECUTE || record->control == READ_WORD || record->control == WRITE_WORD)
+    {
+        buffer[length++] = (byte_t)(record->value >> 8);
+    }
+
+    if(record->register_mask != 0)
+    {
+        header |= TRACE_REGISTERS_WRITTEN;
+        buffer[length++] = record->register_mask;
+        for(int index = 0; index < TRACE_REGISTER_COUNT; index++)
+        {
+            if(record->register_mask & (1 << index))
+            {
+                buffer[length++] = (byte_t)(record->registers[index] & EIGHT_BITS);
+                buffer[length++] = (byte_t)(record->registers[index] >> 8);
+            }
+        }
+    }
+    if(record->type == TRACE_EXECUTE && record->psw_changed)
+    {
+        buffer[length++] = (byte_t)(record->psw & EIGHT_BITS);
+        buffer[length++] = (byte_t)(record->psw >> 8);
+    }
+    buffer[0] = header;
+    return length;
+}
+
+/**
+ * @brief Decode the next record in a block
+ *
+ * @param state Delta state - updated
+ * @param buffer Encoded records
+ * @param length Bytes available
+ * @param record Record decoded
+ * @return int [> 0 = Bytes read, < 0 = FAILURE]
+ */
+int decode_trace_record(trace_state_t *state, const byte_t *buffer, int length, trace_record_t *record)
+{
+    if(length < 1)
+    {
+        return -1;
+    }
+    memset(record, 0, sizeof(trace_record_t));
+    byte_t header = buffer[0];
+    int position = 1;
+    uint32_t delta;
+    int read = get_varint(&buffer[position], length - position, &delta);
+    if(read < 0)
+    {
+        return -2;
+    }
+    position += read;
+    state->cycle += delta;
+    record->cycle = state->cycle;
+    record->type = header & TRACE_TYPE_MASK;
+
+    int value_length = WORD_LENGTH;
+    if(record->type == TRACE_EXECUTE)
+    {
+        record->address = state->pc;
+        if(!(header & TRACE_PC_SEQUENTIAL))
+        {
+            read = get_address(&buffer[position], length - position, state->pc, &record->address);
+            if(read < 0)
+            {
+                return -3;
+            }
+            position += read;
+        }
+        state->pc = (word_t)(record->address + WORD_LENGTH);
+        record->psw_changed = (header & TRACE_PSW_CHANGED) != 0;
+    }
+    else if(record->type == TRACE_MEMORY)
+    {
+        record->control = (control_state_t)((header & TRACE_CONTROL_MASK) >> TRACE_CONTROL_SHIFT);
+        read = get_address(&buffer[position], length - position, state->data_address, &record->address);
+        if(read < 0)
+        {
+            return -3;
+        }
+        position += read;
+        state->data_address = record->address;
+        value_length = (record->control == READ_WORD || record->control == WRITE_WORD) ? WORD_LENGTH : BYTE_LENGTH;
+    }
+    else
+    {
+        return -4;
+    }
+
+    if(position + value_length > length)
+    {
+        return -5;
+    }
+    record->value = buffer[position];
+    if(value_length == WORD_LENGTH)
+    {
+        record->value |= (word_t)(buffer[position + 1] << 8);
+    }
+    position += value_length;
+
+    if(header & TRACE_REGISTERS_WRITTEN)
+    {
+        if(position >= length)
+        {
+            return -6;
+        }
+        record->register_mask = buffer[position++];
+        for(int index = 0; index < TRACE_REGISTER_COUNT; index++)
+        {
+            if(record->register_mask & (1 << index))
+            {
+                if(position + WORD_LENGTH > length)
+                {
+                    return -6;
+                }
+                record->registers[index] = (word_t)(buffer[position] | (buffer[position + 1] << 8));
+                position += WORD_LENGTH;
+            }
+        }
+    }
+    if(record->psw_changed)
+    {
+        if(position + WORD_LENGTH > length)
+        {
+            return -7;
+        }
+        record->psw = (word_t)(buffer[position] | (buffer[position + 1] << 8));
+        position += WORD_LENGTH;
+    }
+    return position;
+}
+
+/**
+ * @brief Write a literal or match length beyond the token
+ *
+ * @param output Compressed output
+ * @param written Bytes written so far
+ * @param length Length minus the part held in the token
+ * @return int Bytes written so far
+ */
+static int put_length(byte_t *output, int written, int length)
+{
+    while(length >= LZ_EXTENSION_MAX)
+    {
+        output[written++] = LZ_EXTENSION_MAX;
+        length -= LZ_EXTENSION_MAX;
+    }
+    output[written++] = (byte_t)length;
+    return written;
+}
+
+/**
+ * @brief Write a run of literals, then a match if match_length > 0
+ *
+ * @param output Compressed output
+ * @param written Bytes written so far
+ * @param literals Literal bytes
+ * @param literal_length Number of literal bytes
+ * @param offset Distance back to the match
+ * @param match_length Number of matched bytes - 0 for the final literals
+ * @return int Bytes written so far
+ */
+static int put_sequence(byte_t *output, int written, const byte_t *literals, int literal_length, int offset, int match_length)
+{
+    int literal_token = (literal_length < LZ_LENGTH_EXTENDED) ? literal_length : LZ_LENGTH_EXTENDED;
+    int match_token = 0;
+    if(match_length > 0)
+    {
+        match_token = (match_length - LZ_MIN_MATCH < LZ_LENGTH_EXTENDED) ? match_length - LZ_MIN_MATCH : LZ_LENGTH_EXTENDED;
+    }
+    output[written++] = (byte_t)((literal_token << 4) | match_token);
+    if(literal_token == LZ_LENGTH_EXTENDED)
+    {
+        written = put_length(output, written, literal_length - LZ_LENGTH_EXTENDED);
+    }
+    memcpy(&output[written], literals, literal_length);
+    written += literal_length;
+    if(match_length > 0)
+    {
+        output[written++] = (byte_t)(offset & EIGHT_BITS);
+        output[written++] = (byte_t)(offset >> 8);
+        if(match_token == LZ_LENGTH_EXTENDED)
+        {
+            written = put_length(output, written, match_length - LZ_MIN_MATCH - LZ_LENGTH_EXTENDED);
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief Compress a block of encoded records
+ *
+ * @param input Encoded records
+ * @param length Number of bytes
+ * @param output Compressed block - at least TRACE_COMPRESSED_MAX(length) bytes
+ * @return int Compressed length
+ */
+int compress_trace_block(const byte_t *input, int length, byte_t *output)
+{
+    int table[1 << LZ_HASH_BITS];
+    memset(table, -1, sizeof(table));
+    int position = 0;
+    int anchor = 0;
+    int written = 0;
+    while(position + LZ_MIN_MATCH <= length)
+    {
+        uint32_t sequence = (uint32_t)input[position] | ((uint32_t)input[position + 1] << 8)
+            | ((uint32_t)input[position + 2] << 16) | ((uint32_t)input[position + 3] << 24);
+        int hash = (int)((sequence * LZ_HASH_MULTIPLIER) >> (32 - LZ_HASH_BITS));
+        int candidate = table[hash];
+        table[hash] = position;
+        if(candidate < 0 || position - candidate > LZ_MAX_OFFSET || memcmp(&input[candidate], &input[position], LZ_MIN_MATCH) != 0)
+        {
+            position++;
+            continue;
+        }
+        int match_length = LZ_MIN_MATCH;
+        while(position + match_length < length && input[candidate + match_length] == input[position + match_length])
+        {
+            match_length++;
+        }
+        written = put_sequence(output, written, &input[anchor], position - anchor, position - candidate, match_length);
+        position += match_length;
+        anchor = position;
+    }
+    /* Final sequence is literals only */
+    return put_sequence(output, written, &input[anchor], length - anchor, 0, 0);
+}
+
+/**
+ * @brief Read a literal or match length beyond the token
+ *
+ * @param input Compressed block
+ * @param length Compressed length
+ * @param position Read position - updated
+ * @param value Length - extension is added
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int get_length(const byte_t *input, int length, int *position, int *value)
+{
+    byte_t extension;
+    do
+    {
+        if(*position >= length)
+        {
+            return -1;
+        }
+        extension = input[(*position)++];
+        *value += extension;
+    } while(extension == LZ_EXTENSION_MAX);
+    return 0;
+}
+
+/**
+ * @brief Decompress a block
+ *
+ * @param input Compressed block
+ * @param length Compressed length
+ * @param output Encoded records
+ * @param capacity Output size
+ * @return int [>= 0 = Decompressed length, < 0 = FAILURE]
+ */
+int decompress_trace_block(const byte_t *input, int length, byte_t *output, int capacity)
+{
+    int position = 0;
+    int written = 0;
+    while(position < length)
+    {
+        byte_t token = input[position++];
+        int literal_length = token >> 4;
+        if(literal_length == LZ_LENGTH_EXTENDED && get_length(input, length, &position, &literal_length) != 0)
+        {
+            return -1;
+        }
+        if(position + literal_length > length || written + literal_length > capacity)
+        {
+            return -2;
+        }
+        memcpy(&output[written], &input[position], literal_length);
+        position += literal_length;
+        written += literal_length;
+        if(position == length)
+        {
+            /* Final literals */
+            break;
+        }
+
+        if(position + WORD_LENGTH > length)
+        {
+            return -3;
+        }
+        int offset = input[position] | (input[position + 1] << 8);
+        position += WORD_LENGTH;
+        int match_length = (token & LZ_LENGTH_MASK) + LZ_MIN_MATCH;
+        if((token & LZ_LENGTH_MASK) == LZ_LENGTH_EXTENDED && get_length(input, length, &position, &match_length) != 0)
+        {
+            return -4;
+        }
+        if(offset == 0 || offset > written || written + match_length > capacity)
+        {
+            return -5;
+        }
+        /* Byte at a time - matches may overlap their output */
+        for(int index = 0; index < match_length; index++, written++)
+        {
+            output[written] = output[written - offset];
+        }
+    }
+    return written;
+}
+
+/**
+ * @brief Store a 32 bit value little endian
+ *
+ * @param buffer Output
+ * @param value Value to store
+ */
+void write_trace_u32(byte_t *buffer, uint32_t value)
+{
+    for(int index = 0; index < 4; index++)
+    {
+        buffer[index] = (byte_t)(value >> (8 * index));
+    }
+}
+
+/**
+ * @brief Load a 32 bit little endian value
+ *
+ * @param buffer Input
+ * @return uint32_t Value loaded
+ */
+uint32_t read_trace_u32(const byte_t *buffer)
+{
+    uint32_t value = 0;
+    for(int index = 0; index < 4; index++)
+    {
+        value |= (uint32_t)buffer[index] << (8 * index);
+    }
+    return value;
+}
+
+/**
+ * @brief Store a 64 bit value little endian
+ *
+ * @param buffer Output
+ * @param value Value to store
+ */
+void write_trace_u64(byte_t *buffer, uint64_t value)
+{
+    write_trace_u32(buffer, (uint32_t)value);
+    write_trace_u32(&buffer[4], (uint32_t)(value >> 32));
+}
+
+/**
+ * @brief Load a 64 bit little endian value
+ *
+ * @param buffer Input
+ * @return uint64_t Value loaded
+ */
+uint64_t read_trace_u64(const byte_t *buffer)
+{
+    return read_trace_u32(buffer) | ((uint64_t)read_trace_u32(&buffer[4]) << 32);
+}
+
+/**
+ * @brief Serialize a block index entry
+ *
+ * @param block Index entry
+ * @param buffer Output - TRACE_INDEX_ENTRY_LENGTH bytes
+ */
+void write_trace_index_entry(trace_block_t *block, byte_t *buffer)
+{
+    write_trace_u64(buffer, block->offset);
+    write_trace_u32(&buffer[8], block->compressed_length);
+    write_trace_u32(&buffer[12], block->length);
+    write_trace_u32(&buffer[16], block->records);
+    write_trace_u32(&buffer[20], block->first_cycle);
+    write_trace_u32(&buffer[24], block->last_cycle);
+    memcpy(&buffer[28], block->pc_regions, TRACE_BITMAP_LENGTH);
+    memcpy(&buffer[28 + TRACE_BITMAP_LENGTH], block->read_regions, TRACE_BITMAP_LENGTH);
+    memcpy(&buffer[28 + 2 * TRACE_BITMAP_LENGTH], block->write_regions, TRACE_BITMAP_LENGTH);
+}
+
+/**
+ * @brief Load a block index entry
+ *
+ * @param buffer Input - TRACE_INDEX_ENTRY_LENGTH bytes
+ * @param block Index entry
+ */
+void read_trace_index_entry(const byte_t *buffer, trace_block_t *block)
+{
+    block->offset = read_trace_u64(buffer);
+    block->compressed_length = read_trace_u32(&buffer[8]);
+    block->length = read_trace_u32(&buffer[12]);
+    block->records = read_trace_u32(&buffer[16]);
+    block->first_cycle = read_trace_u32(&buffer[20]);
+    block->last_cycle = read_trace_u32(&buffer[24]);
+    memcpy(block->pc_regions, &buffer[28], TRACE_BITMAP_LENGTH);
+    memcpy(block->read_regions, &buffer[28 + TRACE_BITMAP_LENGTH], TRACE_BITMAP_LENGTH);
+    memcpy(block->write_regions, &buffer[28 + 2 * TRACE_BITMAP_LENGTH], TRACE_BITMAP_LENGTH);
+}
@@ -76,10 +76,9 @@ void memory_write(byte_t *instruction_memory, byte_t *data_memory)
     switch (memory_type)
     {
     case INSTRUCTION_MEMORY:
-        if(address + 1 < INSTRUCTION_MEMORY_LENGTH)
+        if(address >= 0 && address < INSTRUCTION_MEMORY_LENGTH)
         {
-            instruction_memory[address + 1] = (byte_t) (word >> 8);
-            instruction_memory[address] = (byte_t) (word & EIGHT_BITS);
+            write_memory_word(instruction_memory, (word_t)address, (word_t)word);
         }
         else
         {
@@ -87,10 +86,9 @@ void memory_write(byte_t *instruction_memory, byte_t *data_memory)
         }
         break;
     case DATA_MEMORY:
-        if(address + 1 < DATA_MEMORY_LENGTH)
+        if(address >= 0 && address < DATA_MEMORY_LENGTH)
         {
-            data_memory[address + 1] = (byte_t) (word >> 8);
-            data_memory[address] = (byte_t) (word & EIGHT_BITS);
+            write_memory_word(data_memory, (word_t)address, (word_t)word);
         }
         else
         {
@@ -164,14 +162,103 @@ void set_breakpoint(int *breakpoint)
 }
 
 /**
- * @brief Run Utility - Start the pipelined instruction execution
+ * @brief Advance the pipelined instruction cycle by one clock cycle
  * 
  * @param program - Program context struct
+ * @param cycle_limit - Stop at the first instruction boundary at or after this clock cycle
+ * @return int [CYCLE_CONTINUE, CYCLE_BREAKPOINT, CYCLE_LIMIT]
  */
-void run(program_t *program)
+int run_cycle(program_t *program, int cycle_limit)
 {
-    printf("Run Utility\n");
-    int pause_cycle = 0;
+    switch(program->cycle_state)
+    {
+        case CYCLE_START:
+            /* Initialize with NOOP */
+            program->instruction_register = INSTRUCTION_NOOP;
+            program->fusion_pending = 0;
+            /* Perform Cycle_Wait_1 State */
+        case CYCLE_WAIT_1:
+            /* Pairs are only fused when the run cannot stop between them */
+            program->cycle_limit = cycle_limit;
+            /* Service Interrupts and Events at Instruction Boundary */
+            if(program->clock_cycles >= program->next_event_cycle)
+            {
+                service_events(program);
+            }
+            /* FETCH_0 */
+            fetch_instruction(program, F0);
+            /* DECODE_0 */
+            decode_instruction(&program->instruction, program);
+            /* EXECUTE_1 */
+            execute_instruction(&program->instruction, program, E1);
+            program->cycle_state = CYCLE_WAIT_0;
+            /* Copy stage to program context for debug logging */
+            if(program->debug_mode)
+            {
+                sprintf_s(program->instruction_decode, MAX_STAGE_LENGTH, "D0: %04x", program->instruction_opcode);
+            }
+            break;
+        case CYCLE_WAIT_0:
+            /* Set Current Instruction Address for Debugging */
+            program->instruction.address = program->PROGRAM_COUNTER - 2 * WORD_LENGTH;
+            /* FETCH_1 */
+            fetch_instruction(program, F1);
+            /* EXECUTE_0 */
+            execute_instruction(&program->instruction, program, E0);
+            program->cycle_state = CYCLE_WAIT_1;
+
+            /* Copy stage to program context for debug logging */
+            if(program->debug_mode)
+            {
+                /* Clear Decode Stage */
+                sprintf_s(program->instruction_decode, MAX_STAGE_LENGTH, "\t");
+            }
+
+            /* Check for Breakpoint - PC Incremented in previous cycle */
+            if(program->PROGRAM_COUNTER - 2 * WORD_LENGTH == (program->breakpoint & 0xFFFE))
+            {
+                /* Decrement PC for resuming execution */
+                program->PROGRAM_COUNTER -= 2 * WORD_LENGTH;
+                return CYCLE_BREAKPOINT;
+            }
+            /* Cycle Limit - Resume at the fetched instruction, not yet decoded.
+                Deferred while bubbles are queued, as the fetched instruction may be discarded */
+            if(program->clock_cycles >= cycle_limit && pipeline_drained(program))
+            {
+                program->PROGRAM_COUNTER -= WORD_LENGTH;
+                return CYCLE_LIMIT;
+            }
+            break;
+        default:
+            break;
+    }
+    if(program->debug_mode == 1)
+    {
+        printf("%04d\t\t%04x\t\t%04x\t\t%s\t%s\t%s\tCVNZ: %d%d%d%d\n", 
+        program->clock_cycles, program->PROGRAM_COUNTER - WORD_LENGTH, 
+        program->instruction_register, program->instruction_fetch, 
+        program->instruction_decode, program->instruction_execute,
+        PSW_BIT(program->program_status_word, PSW_CARRY_BIT), PSW_BIT(program->program_status_word, PSW_OVERFLOW_BIT),
+        PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT), PSW_BIT(program->program_status_word, PSW_ZERO_BIT));
+    }
+    program->clock_cycles++;
+    return CYCLE_CONTINUE;
+}
+
+/**
+ * @brief Run the pipelined instruction cycle until a breakpoint or cycle limit is reached
+ * 
+ * @param program - Program context struct
+ * @param cycle_count - Maximum number of clock cycles to run - NO_CYCLE_LIMIT to run until breakpoint
+ * @return int [CYCLE_BREAKPOINT, CYCLE_LIMIT]
+ */
+int run_cycles(program_t *program, int cycle_count)
+{
+    int cycle_limit = NO_CYCLE_LIMIT;
+    if(cycle_count != NO_CYCLE_LIMIT && program->clock_cycles < NO_CYCLE_LIMIT - cycle_count)
+    {
+        cycle_limit = program->clock_cycles + cycle_count;
+    }
     /* Start XM23P Pipelined Instruction Cycle */
     program->cycle_state = CYCLE_START;
     /* Debug logging table headers */
@@ -179,71 +266,74 @@ void run(program_t *program)
     {
         printf("Clock\t\tPC\t\tInstruction\tFetch\t\tDecode\t\tExecute\n");
     }
-    /* Loop Until Breakpoint Reached */
-    while(pause_cycle == 0)
+    begin_run_metrics(program);
+    int cycle_status = CYCLE_CONTINUE;
+    while(cycle_status == CYCLE_CONTINUE)
+    {
+        cycle_status = run_cycle(program, cycle_limit);
+        /* Host clock is read only every METRICS_CHECK_CYCLES */
+        if(program->settings.metrics != NULL && program->clock_cycles >= program->settings.metrics->next_check_cycle)
+        {
+            check_metrics(program);
+        }
+    }
+    end_run_metrics(program, (cycle_status == CYCLE_BREAKPOINT) ? EXIT_REASON_BREAKPOINT : EXIT_REASON_CYCLE_LIMIT);
+    /* Write Console Output before Returning to User */
+    flush_console(program);
+    return cycle_status;
+}
+
+/**
+ * @brief Execute a number of instructions, stopping early at a breakpoint
+ * 
+ * Stops only at an instruction boundary with no queued bubbles, leaving PC
+ * at the next instruction to execute.
+ * 
+ * @param program - Program context struct
+ * @param instruction_count - Number of instructions to execute
+ * @return int [CYCLE_BREAKPOINT, CYCLE_LIMIT]
+ */
+int step_instructions(program_t *program, int instruction_count)
+{
+    /* First boundary completes the NOOP that restarts the pipeline */
+    int boundaries = -1;
+    int status = CYCLE_CONTINUE;
+    /* Every instruction is a boundary - pairs execute separately */
+    int fusion_disabled = program->settings.fusion_disabled;
+    program->settings.fusion_disabled = 1;
+    program->cycle_state = CYCLE_START;
+    while(status == CYCLE_CONTINUE)
     {
-        switch(program->cycle_state)
+        if(run_cycle(program, NO_CYCLE_LIMIT) == CYCLE_BREAKPOINT)
         {
-            case CYCLE_START:
-                /* Initialize with NOOP */
-                program->instruction_register = INSTRUCTION_NOOP;
-                /* Perform Cycle_Wait_1 State */
-            case CYCLE_WAIT_1:
-                /* FETCH_0 */
-                fetch_instruction(program, F0);
-                /* DECODE_0 */
-                decode_instruction(&program->instruction, program);
-                /* EXECUTE_1 */
-                execute_instruction(&program->instruction, program, E1);
-                program->cycle_state = CYCLE_WAIT_0;
-                /* Copy stage to program context for debug logging */
-                if(program->debug_mode)
-                {
-                    sprintf_s(program->instruction_decode, MAX_STAGE_LENGTH, "D0: %04x", program->instruction.opcode);
-                }
-                break;
-            case CYCLE_WAIT_0:
-                /* Set Current Instruction Address for Debugging */
-                program->instruction.address = program->PROGRAM_COUNTER - 2 * WORD_LENGTH;
-                /* FETCH_1 */
-                fetch_instruction(program, F1);
-                /* EXECUTE_0 */
-                execute_instruction(&program->instruction, program, E0);
-                program->cycle_state = CYCLE_WAIT_1;
-
-                /* Copy stage to program context for debug logging */
-                if(program->debug_mode)
-                {
-                    /* Clear Decode Stage */
-                    sprintf_s(program->instruction_decode, MAX_STAGE_LENGTH, "\t");
-                }
-
-                /* Check for Breakpoint - PC Incremented in previous cycle */
-                if(program->PROGRAM_COUNTER - 2 * WORD_LENGTH == (program->breakpoint & 0xFFFE))
-                {
-                    pause_cycle = 1;
-                    /* Decrement PC for resuming execution */
-                    program->PROGRAM_COUNTER -= 2 * WORD_LENGTH;
-                    continue;
-                }
-                break;
-            default:
-                break;
+            status = CYCLE_BREAKPOINT;
         }
-        if(program->debug_mode == 1)
+        else if(program->cycle_state == CYCLE_WAIT_1 && pipeline_drained(program)
+            && ++boundaries == instruction_count)
         {
-            printf("%04d\t\t%04x\t\t%04x\t\t%s\t%s\t%s\tCVNZ: %d%d%d%d\n", 
-            program->clock_cycles, program->PROGRAM_COUNTER - WORD_LENGTH, 
-            program->instruction_register, program->instruction_fetch, 
-            program->instruction_decode, program->instruction_execute,
-            program->program_status_word.carry, program->program_status_word.overflow,
-            program->program_status_word.negative, program->program_status_word.zero);
+            /* Resume at the fetched instruction */
+            program->PROGRAM_COUNTER -= WORD_LENGTH;
+            status = CYCLE_LIMIT;
         }
-        program->clock_cycles++;
     }
+    program->settings.fusion_disabled = fusion_disabled;
+    flush_console(program);
+    return status;
+}
+
+/**
+ * @brief Run Utility - Start the pipelined instruction execution
+ * 
+ * @param program - Program context struct
+ */
+void run(program_t *program)
+{
+    printf("Run Utility\n");
+    /* Loop Until Breakpoint Reached */
+    (void) run_cycles(program, NO_CYCLE_LIMIT);
     printf("Breakpoint Reached. CVNZ: %d%d%d%d\n", 
-        program->program_status_word.carry, program->program_status_word.overflow, 
-        program->program_status_word.negative, program->program_status_word.zero);
+        PSW_BIT(program->program_status_word, PSW_CARRY_BIT), PSW_BIT(program->program_status_word, PSW_OVERFLOW_BIT), 
+        PSW_BIT(program->program_status_word, PSW_NEGATIVE_BIT), PSW_BIT(program->program_status_word, PSW_ZERO_BIT));
 }
 
 /**
@@ -256,20 +346,123 @@ void restart_program(program_t *program)
 {
     memset(program->register_file, 0, sizeof(word_t) * REGISTER_FILE_LENGTH);
     program->PROGRAM_COUNTER = (word_t)program->starting_address;
+    /* Logged before the clock returns to 0 */
+    restart_input_log(program);
     program->clock_cycles = 0;
+    initialize_devices(program);
+    reset_interrupts(program);
+    reset_statistics(program);
+    reset_branch_predictor(program);
+    reset_caches(program);
+    reset_data_profile(program);
+    reset_metrics(program);
+}
+
+/**
+ * @brief Load one S-Record into the program
+ * 
+ * @param program Program context struct
+ * @param s_record Parsed record
+ * @return int [0 = Success, < 0 = Failure]
+ */
+static int load_record(program_t *program, s_record_t *s_record)
+{
+    int error_status = 0;
+    switch (s_record->type)
+    {
+    case NAME_TYPE:
+        /* Load name from record data into executable name */
+        error_status = load_record_name(s_record, program->executable_name);
+        if(error_status != 0)
+        {
+            printf("Error loading data into executable_name");
+        }
+        break;
+    case INSTRUCTION_TYPE:
+        /* Load Instructions from record data to instruction memory */
+        error_status = load_record_data(s_record, program->instruction_memory);
+        if(error_status != 0)
+        {
+            printf("Error loading data into instruction_memory");
+        }
+        break;
+    case DATA_TYPE:
+        /* Load Data from record data into data memory */
+        error_status = load_record_data(s_record, program->data_memory);
+        if(error_status != 0)
+        {
+            printf("Error loading data into data_memory");
+        }
+        break;
+
+    case ADDRESS_TYPE:
+        /* Load Starting Address from record address 
+            into starting_address */
+        error_status = load_record_address(s_record, &program->starting_address);
+
+        if(error_status != 0)
+        {
+            printf("Error loading data into starting_address");
+        }
+        break;
+
+    default:
+        /* If invalid type, print warning and move to next record */
+        printf("Invalid Record Type: %c", s_record->type);
+        error_status = -1;
+        break;
+    }
+    return error_status;
 }
 
 /**
- * @brief Load Memory Utility - Loads data and instructions from xme file into memory
+ * @brief Assemble a source file and load its records
+ * 
+ * @param program Program context struct
+ * @param path Assembly source path
+ * @return int [0 = Success, < 0 = Failure]
+ */
+static int load_assembly(program_t *program, char *path)
+{
+    assembly_t assembly;
+    memset(&assembly, 0, sizeof(assembly_t));
+    int errors = assemble_file(&assembly, path);
+    if(errors != 0)
+    {
+        if(errors < 0)
+        {
+            printf("Error Opening File\n");
+        }
+        print_assembly_errors(&assembly);
+        release_assembly(&assembly);
+        return -1;
+    }
+    for(int index = 0; index < assembly.record_count; index++)
+    {
+        load_record(program, &assembly.records[index]);
+    }
+    printf("Assembled %d Records\n", assembly.record_count);
+    release_assembly(&assembly);
+    return 0;
+}
+
+/**
+ * @brief Load Memory Utility - Loads data and instructions from xme file into memory,
+ *        or assembles an asm file straight into memory
  * 
  * @param program Context struct for the program
  * @param supplied_path Path to the xme file - NULL if not supplied
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
  */
-void load_memory(program_t *program, char *supplied_path)
+int load_memory(program_t *program, char *supplied_path)
 {
     printf("Load Memory Utility\n");
-    /* Clear Program */
+    double load_start = host_seconds();
+    /* Clear Program - Session Settings Preserved */
+    flush_console(program);
+    emulator_settings_t settings = program->settings;
     memset(program, 0, sizeof(program_t));
+    program->settings = settings;
     initialize_register_file(program->register_file);
     int error_status = 0;
     char program_path[MAX_PATH_LENGTH];
@@ -291,68 +484,267 @@ void load_memory(program_t *program, char *supplied_path)
         printf("Loading Program From: %s\n", program_path);
     }
 
-    /* Check for errors opening file */
-    if(fopen_s(&file, program_path, "r") != 0)
-    {
-        printf("Error Opening File\n");
-        return;
-    }
-
-    /* Parse Each Record in File*/
-    while(fgets(input_record, sizeof(input_record), file))
+    /* Assembly source is assembled straight into memory */
+    if(is_assembly_path(program_path))
     {
-        error_status = parse_record(input_record, &s_record);
+        error_status = load_assembly(program, program_path);
         if(error_status != 0)
         {
-            printf("Invalid Line: %s", input_record);
-            continue;
+            return error_status;
         }
-        switch (s_record.type)
+    }
+    else
+    {
+        /* Check for errors opening file */
+        if(fopen_s(&file, program_path, "r") != 0)
         {
-        case NAME_TYPE:
-            /* Load name from record data into executable name */
-            error_status = load_record_name(&s_record, program->executable_name);
-            if(error_status != 0)
-            {
-                printf("Error loading data into executable_name");
-            }
-            break;
-        case INSTRUCTION_TYPE:
-            /* Load Instructions from record data to instruction memory */
-            error_status = load_record_data(&s_record, program->instruction_memory);
-            if(error_status != 0)
-            {
-                printf("Error loading data into instruction_memory");
-            }
-            break;
-        case DATA_TYPE:
-            /* Load Data from record data into data memory */
-            error_status = load_record_data(&s_record, program->data_memory);
-            if(error_status != 0)
-            {
-                printf("Error loading data into data_memory");
-            }
-            break;
-
-        case ADDRESS_TYPE:
-            /* Load Starting Address from record address 
-                into starting_address */
-            error_status = load_record_address(&s_record, &program->starting_address);
+            printf("Error Opening File\n");
+            return -1;
+        }
 
+        /* Parse Each Record in File*/
+        while(fgets(input_record, sizeof(input_record), file))
+        {
+            error_status = parse_record(input_record, &s_record);
             if(error_status != 0)
             {
-                printf("Error loading data into starting_address");
+                printf("Invalid Line: %s", input_record);
+                continue;
             }
-            break;
-
-        default:
-            /* If invalid type, print warning and move to next record */
-            printf("Invalid Record Type: %c", s_record.type);
-            continue;
-            break;
+            load_record(program, &s_record);
         }
+        fclose(file);
+    }
+    if(program->settings.control_flow != NULL)
+    {
+        build_control_flow(program);
     }
-    fclose(file);
     /* Load Starting Address into Program Counter */
     restart_program(program);
-}
\ No newline at end of file
+    if(program->settings.metrics != NULL)
+    {
+        program->settings.metrics->load_seconds = host_seconds() - load_start;
+    }
+    return 0;
+}
+
+/**
+ * @brief Console Output Utility - Select file receiving console device output
+ * 
+ * @param program - Program context struct
+ */
+void console_output(program_t *program)
+{
+    printf("Console Output Utility\n");
+    printf("Enter Output Path (- for Console): ");
+    char output_path[MAX_PATH_LENGTH];
+    scanf_s("%s", output_path, MAX_PATH_LENGTH);
+    if(set_console_output(program, output_path) != 0)
+    {
+        printf("Error Opening File\n");
+    }
+}
+
+/**
+ * @brief Branch Predictor Utility - Select the branch prediction model
+ * 
+ * @param program - Program context struct
+ */
+void branch_predictor(program_t *program)
+{
+    printf("Branch Predictor Utility\n");
+    printf("none | nottaken | btfn | bimodal | gshare | btb\n");
+    printf("Select Predictor: ");
+    char name[MAX_PATH_LENGTH];
+    scanf_s("%s", name, MAX_PATH_LENGTH);
+    if(set_branch_predictor(program, name) != 0)
+    {
+        printf("Invalid Predictor\n");
+    }
+}
+
+/**
+ * @brief Cache Configuration Utility - Configure or disable the instruction or data cache model
+ * 
+ * @param program - Program context struct
+ */
+void cache_configuration(program_t *program)
+{
+    printf("Cache Configuration Utility\n");
+    printf("Select Cache: \n");
+    printf("0 - Instruction Cache | 1 - Data Cache\n");
+    int select;
+    scanf_s("%d", &select);
+    printf("Enter Size in Bytes (0 to Disable): ");
+    cache_config_t config;
+    scanf_s("%d", &config.size);
+    if(config.size == 0)
+    {
+        set_cache(program, select ? DATA_CACHE : INSTRUCTION_CACHE, NULL);
+        return;
+    }
+    printf("Enter Associativity: ");
+    scanf_s("%d", &config.associativity);
+    printf("Enter Line Size in Bytes: ");
+    scanf_s("%d", &config.line_size);
+    printf("Select Replacement Policy (lru | fifo | random): ");
+    char policy[MAX_PATH_LENGTH];
+    scanf_s("%s", policy, MAX_PATH_LENGTH);
+    config.policy = (cache_policy_t)parse_cache_policy(policy);
+    printf("Enter Miss Penalty in Cycles: ");
+    scanf_s("%d", &config.miss_penalty);
+    if(set_cache(program, select ? DATA_CACHE : INSTRUCTION_CACHE, &config) != 0)
+    {
+        printf("Invalid Cache Configuration\n");
+    }
+}
+
+/**
+ * @brief Data Profile Utility - Configure or disable the data memory access profile
+ * 
+ * @param program - Program context struct
+ */
+void data_profile_configuration(program_t *program)
+{
+    printf("Data Profile Utility\n");
+    printf("Enter Block Size in Bytes (0 to Disable): ");
+    int block_size;
+    scanf_s("%d", &block_size);
+    if(block_size == 0)
+    {
+        set_data_profile(program, 0, 0);
+        return;
+    }
+    printf("Enter Working Set Window in Cycles: ");
+    int window_cycles;
+    scanf_s("%d", &window_cycles);
+    if(set_data_profile(program, block_size, window_cycles) != 0)
+    {
+        printf("Invalid Data Profile Configuration\n");
+    }
+}
+
+/**
+ * @brief Memory Export Utility - Prompts for memory type, format, address range and path,
+ * then writes the range to the file in a single pass.
+ * 
+ * @param program - Program context struct
+ */
+void memory_export(program_t *program)
+{
+    printf("Memory Export Utility\n");
+    (void) getchar();
+    printf("Select Memory Type: \n");
+    printf("0 - Program Memory | 1 - Data Memory\n");
+    char memory_type;
+    scanf_s("%c", &memory_type, 1);
+    printf("Select Format: \n");
+    printf("b - Binary | i - Intel HEX | s - S-Record | d - Diff\n");
+    char format;
+    scanf_s(" %c", &format, 1);
+    printf("Enter Memory Start Address: ");
+    int start_address;
+    scanf_s("%x", &start_address);
+    printf("Enter Memory End Address: ");
+    int end_address;
+    scanf_s("%x", &end_address);
+    printf("Enter Output Path: ");
+    char output_path[MAX_PATH_LENGTH];
+    scanf_s("%s", output_path, MAX_PATH_LENGTH);
+
+    byte_t *memory;
+    record_type_t record_type;
+    switch(memory_type)
+    {
+    case INSTRUCTION_MEMORY:
+        memory = program->instruction_memory;
+        record_type = INSTRUCTION_TYPE;
+        break;
+    case DATA_MEMORY:
+        memory = program->data_memory;
+        record_type = DATA_TYPE;
+        break;
+    default:
+        printf("Invalid Memory Type\n");
+        return;
+    }
+
+    char baseline_path[MAX_PATH_LENGTH] = "";
+    if(format == FORMAT_DIFF)
+    {
+        printf("Enter Baseline Path: ");
+        scanf_s("%s", baseline_path, MAX_PATH_LENGTH);
+    }
+
+    int error_status = export_memory_file(memory, start_address, end_address,
+        (export_format_t)format, record_type, output_path, baseline_path);
+    if(error_status == EXPORT_FILE_ERROR)
+    {
+        printf("Error Opening File\n");
+    }
+    else if(error_status < 0)
+    {
+        printf("Invalid Export\n");
+    }
+}
+
+/**
+ * @brief Memory Import Utility - Prompts for memory type, format, address range and path,
+ * then writes the file contents into the range.
+ * 
+ * @param program - Program context struct
+ */
+void memory_import(program_t *program)
+{
+    printf("Memory Import Utility\n");
+    (void) getchar();
+    printf("Select Memory Type: \n");
+    printf("0 - Program Memory | 1 - Data Memory\n");
+    char memory_type;
+    scanf_s("%c", &memory_type, 1);
+    printf("Select Format: \n");
+    printf("b - Binary | i - Intel HEX | s - S-Record | d - Diff\n");
+    char format;
+    scanf_s(" %c", &format, 1);
+    printf("Enter Memory Start Address: ");
+    int start_address;
+    scanf_s("%x", &start_address);
+    printf("Enter Memory End Address: ");
+    int end_address;
+    scanf_s("%x", &end_address);
+    printf("Enter Input Path: ");
+    char input_path[MAX_PATH_LENGTH];
+    scanf_s("%s", input_path, MAX_PATH_LENGTH);
+
+    byte_t *memory;
+    switch(memory_type)
+    {
+    case INSTRUCTION_MEMORY:
+        memory = program->instruction_memory;
+        break;
+    case DATA_MEMORY:
+        memory = program->data_memory;
+        break;
+    default:
+        printf("Invalid Memory Type\n");
+        return;
+    }
+
+    int imported_bytes = import_memory_file(memory, start_address, end_address, (export_format_t)format, input_path);
+    if(imported_bytes == EXPORT_FILE_ERROR)
+    {
+        printf("Error Opening File\n");
+    }
+    else if(imported_bytes == IMPORT_RECORD_ERROR)
+    {
+        printf("Invalid Record - Nothing Imported\n");
+    }
+    else if(imported_bytes < 0)
+    {
+        printf("Invalid Import\n");
+    }
+    else
+    {
+        printf("Imported %d Bytes\n", imported_bytes);
+    }
+}
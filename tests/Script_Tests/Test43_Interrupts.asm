@@ -0,0 +1,42 @@
+; Test 43 - SVC and timer interrupts delivered through the vector table
+TMRCTRL equ     #FF10
+TMRPER  equ     #FF12
+        data
+        org     #FFC8
+SvcVec  word    #0060           ; Vector 2 - priority 3
+        word    SvcHdl
+        org     #FFE0
+TmrVec  word    #0060           ; Vector 8 (timer) - priority 3
+        word    TmrHdl
+
+        code
+        org     #100
+Start   movl    #8000,R6       ; Stack below the vector table
+        movh    #8000,R6
+        movlz   #0,R0
+        movlz   #0,R1
+        svc     #2
+        movl    #1234,R2
+        movh    #1234,R2
+; Timer expires every 40 cycles with its interrupt enabled
+        movl    TMRPER,R3
+        movh    TMRPER,R3
+        movlz   #28,R4
+        st      R4,R3
+        movl    TMRCTRL,R3
+        movh    TMRCTRL,R3
+        movlz   #3,R4
+        st      R4,R3
+Wait    cmp     R4,R1
+        bne     Wait
+        movlz   #0,R4
+        st      R4,R3
+Halt    bra     Halt
+
+        org     #200
+SvcHdl  add     $1,R0
+        mov     R5,R7
+
+TmrHdl  add     $1,R1
+        mov     R5,R7
+        end     Start
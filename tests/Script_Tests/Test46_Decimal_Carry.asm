@@ -0,0 +1,25 @@
+; Test 46 - DADD carries between digits, out of the word and out of the byte
+; Each result depends on the carry left by the addition before it
+        code
+        org     #100
+Start   movlz   #1,R1
+; Carry ripples through three digits, none out of the word
+        movl    #0999,R0
+        movh    #0999,R0
+        dadd    R1,R0
+; Carry out of every digit and the word - result zero
+        movl    #9999,R2
+        movh    #9999,R2
+        dadd    R1,R2
+; Carry in from the previous addition
+        movl    #1234,R3
+        movh    #1234,R3
+        movl    #4321,R4
+        movh    #4321,R4
+        dadd    R4,R3
+; Byte carry out of the low two digits, high byte kept
+        movl    #AB99,R5
+        movh    #AB99,R5
+        dadd.b  R1,R5
+Halt    bra     Halt
+        end     Start
@@ -0,0 +1,14 @@
+; Test 47 - Word accesses at #FFFF wrap their high byte to #0000
+        code
+        org     #100
+Start   movl    #FFFF,R0
+        movh    #FFFF,R0
+        movl    #BEEF,R1
+        movh    #BEEF,R1
+        st      R1,R0
+        ld      R0,R2
+; Byte access at #FFFF stays in its own byte
+        movlz   #0,R3
+        ld.b    R0,R3
+Halt    bra     Halt
+        end     Start
@@ -0,0 +1,24 @@
+; Test 48 - Console input read by polling, summed as it arrives
+CONDATA equ     #FF00
+CONSTAT equ     #FF02
+        code
+        org     #100
+Start   movl    CONDATA,R2
+        movh    CONDATA,R2
+        movl    CONSTAT,R3
+        movh    CONSTAT,R3
+        movlz   #0,R0
+        movlz   #0,R1
+        movlz   #4,R5
+; Wait for receive ready, then add the byte to the sum
+Poll    ld      R3,R4
+        and     $2,R4
+        beq     Poll
+        ld.b    R2,R4
+        add     R4,R0
+        add     $1,R1
+        cmp     R5,R1
+        bne     Poll
+Done    mov     R0,R0           ; Breakpoint - all input received
+Halt    bra     Halt
+        end     Start
@@ -0,0 +1,28 @@
+; Test 49 - Known loads and stores counted by the data profiler
+        code
+        org     #100
+Start   movl    #2000,R3
+        movh    #2000,R3
+        movl    #3000,R5
+        movh    #3000,R5
+        movlz   #10,R0
+; Sixteen word stores - two 16 byte blocks at #2000
+Fill    st      R0,R3
+        add     $2,R3
+        sub     $1,R0
+        cmp     $0,R0
+        bne     Fill
+        movl    #2000,R3
+        movh    #2000,R3
+        movlz   #10,R0
+; Sixteen word loads of the array, each added to the total at #3000
+Sum     ld      R3+,R4
+        ld      R5,R2
+        add     R4,R2
+        st      R2,R5
+        sub     $1,R0
+        cmp     $0,R0
+        bne     Sum
+Done    movlz   #1,R1           ; Breakpoint - loops complete
+Halt    bra     Halt
+        end     Start
@@ -0,0 +1,18 @@
+; Test 50 - Backward taken/forward not-taken prediction
+        code
+        org     #100
+Start   movlz   #3,R0
+; Backward loop branch - predicted taken, wrong once on exit
+Loop    sub     $1,R0
+        cmp     $0,R0
+        bne     Loop
+; Forward unconditional branch - always predicted taken
+        bra     Skip
+        movlz   #1,R1
+; Forward conditional branch - predicted not taken, wrong when taken
+Skip    cmp     $0,R0
+        beq     Ahead
+        movlz   #2,R1
+Ahead   movlz   #7,R2           ; Breakpoint - branches complete
+Halt    bra     Halt
+        end     Start
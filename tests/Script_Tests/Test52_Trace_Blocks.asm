@@ -0,0 +1,21 @@
+; Test 52 - A long store loop to #2000 filling several trace blocks, then one store to #5000
+        code
+        org     #100
+Start   movl    #2000,R3
+        movh    #2000,R3
+        movl    #4000,R0
+        movh    #4000,R0
+Fill    st      R0,R3
+        sub     $1,R0
+        cmp     $0,R0
+        bne     Fill
+        bra     Tail
+; Only the last block executes or writes these regions
+        org     #400
+Tail    movl    #5000,R4
+        movh    #5000,R4
+        movlz   #5A,R1
+Last    st      R1,R4
+Done    movlz   #1,R2           ; Breakpoint - stores complete
+Halt    bra     Halt
+        end     Start
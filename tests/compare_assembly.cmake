@@ -0,0 +1,12 @@
+# Assemble a source and compare the records with a checked-in .xme
+# cmake -DASSEMBLER=<assemble> -DSOURCE=<.asm> -DEXPECTED=<.xme> -DOUTPUT=<.xme> -P compare_assembly.cmake
+# Listing beside the output - the default is beside the source
+string(REGEX REPLACE "\\.xme$" ".lis" LISTING "${OUTPUT}")
+execute_process(COMMAND "${ASSEMBLER}" "${SOURCE}" -o "${OUTPUT}" -l "${LISTING}" RESULT_VARIABLE ASSEMBLE_RESULT)
+if(NOT ASSEMBLE_RESULT EQUAL 0)
+    message(FATAL_ERROR "Assembly of ${SOURCE} failed")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files "${OUTPUT}" "${EXPECTED}" RESULT_VARIABLE COMPARE_RESULT)
+if(NOT COMPARE_RESULT EQUAL 0)
+    message(FATAL_ERROR "${OUTPUT} differs from ${EXPECTED}")
+endif()
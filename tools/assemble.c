@@ -0,0 +1,141 @@
+/**
+ * @file assemble.c
+ * @brief Command line XM23P assembler
+ *
+ * Assembles a source file into an S-Record (.xme) file and a listing
+ * (.lis) file, by default beside the source.
+ *
+ *     assemble <source.asm> [-o <records.xme>] [-l <listing.lis>]
+ *
+ * @author Zach Fraser
+ * @date 2024-09-11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assembler.h"
+
+/**
+ * @brief Replace the extension of a path
+ *
+ * @param path Source path
+ * @param extension New extension including the dot
+ * @param destination Path with the new extension
+ */
+static void replace_extension(const char *path, const char *extension, char *destination)
+{
+    snprintf(destination, MAX_PATH_LENGTH, "%s", path);
+    char *dot = strrchr(destination, '.');
+    char *separator = strrchr(destination, '/');
+    char *windows_separator = strrchr(destination, '\\');
+    if(windows_separator > separator)
+    {
+        separator = windows_separator;
+    }
+    if(dot != NULL && (separator == NULL || dot > separator))
+    {
+        *dot = '\0';
+    }
+    size_t length = strlen(destination);
+    snprintf(&destination[length], MAX_PATH_LENGTH - length, "%s", extension);
+}
+
+/**
+ * @brief Write an output file
+ *
+ * @param assembly Assembly
+ * @param path Output path
+ * @param records_path S-Record path named by the listing - NULL to write the records
+ * @return int [0 = SUCCESS, < 0 = FAILURE]
+ */
+static int write_output(assembly_t *assembly, const char *path, const char *records_path)
+{
+    FILE *file = fopen(path, "w");
+    if(file == NULL)
+    {
+        printf("Unable to open %s\n", path);
+        return -1;
+    }
+    int error_status = (records_path == NULL) ? write_assembly_records(assembly, file)
+        : write_assembly_listing(assembly, file, records_path);
+    if(fclose(file) != 0 || error_status != 0)
+    {
+        printf("Error writing %s\n", path);
+        return -2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Assemble the source named by the arguments
+ *
+ * @param argc Argument count
+ * @param argv Source path and output options
+ * @return int [0 = SUCCESS, 1 = FAILURE]
+ */
+int main(int argc, char *argv[])
+{
+    char records_path[MAX_PATH_LENGTH] = {0};
+    char listing_path[MAX_PATH_LENGTH] = {0};
+    char *path = NULL;
+    int valid = 1;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            snprintf(records_path, MAX_PATH_LENGTH, "%s", argv[++i]);
+        }
+        else if(strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+        {
+            snprintf(listing_path, MAX_PATH_LENGTH, "%s", argv[++i]);
+        }
+        else if(path == NULL && argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            valid = 0;
+        }
+    }
+    if(path == NULL || !valid)
+    {
+        printf("Usage: assemble <source.asm> [-o <records.xme>] [-l <listing.lis>]\n");
+        return 1;
+    }
+    if(records_path[0] == '\0')
+    {
+        replace_extension(path, ".xme", records_path);
+    }
+    if(listing_path[0] == '\0')
+    {
+        replace_extension(path, ".lis", listing_path);
+    }
+
+    assembly_t assembly;
+    memset(&assembly, 0, sizeof(assembly_t));
+    int errors = assemble_file(&assembly, path);
+    if(errors < 0)
+    {
+        printf("Unable to read %s\n", path);
+        return 1;
+    }
+    print_assembly_errors(&assembly);
+
+    /* The listing shows the errors - records are only written for a clean assembly */
+    int error_status = write_output(&assembly, listing_path, records_path);
+    if(errors == 0)
+    {
+        error_status |= write_output(&assembly, records_path, NULL);
+        printf("Assembled %s: %d Records, Starting Address #%04X\n", assembly.name, assembly.record_count,
+            assembly.starting_address);
+    }
+    else
+    {
+        printf("%d Errors - see %s\n", errors, listing_path);
+    }
+    release_assembly(&assembly);
+    return (errors != 0 || error_status != 0);
+}
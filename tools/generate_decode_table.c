@@ -0,0 +1,67 @@
+/**
+ * @file generate_decode_table.c
+ * @brief Build time generator for the opcode decode table
+ *
+ * Runs the reference decoder over every instruction word and writes the
+ * results as a constant table, so the emulator decodes with one lookup.
+ *
+ *     generate_decode_table <output.c>
+ *
+ * @author Zach Fraser
+ * @date 2024-08-30
+ */
+
+#include <stdio.h>
+
+#include "decode_table.h"
+
+#define ENTRIES_PER_LINE 4
+
+/**
+ * @brief Write the decode table source file
+ *
+ * @param argc Argument count
+ * @param argv Output path
+ * @return int [0 = SUCCESS, 1 = FAILURE]
+ */
+int main(int argc, char *argv[])
+{
+    if(argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+    FILE *file = fopen(argv[1], "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "Error Opening File: %s\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(file, "/* Generated by generate_decode_table - do not edit */\n\n");
+    fprintf(file, "#include \"decode_table.h\"\n\n");
+    fprintf(file, "/* { type, source, destination, flags, argument } for each instruction word */\n");
+    fprintf(file, "const decoded_opcode_t decode_table[OPCODE_COUNT] =\n{\n");
+    for(long opcode = 0; opcode < OPCODE_COUNT; opcode++)
+    {
+        decoded_opcode_t decoded;
+        decode_opcode((word_t)opcode, &decoded);
+        if(opcode % ENTRIES_PER_LINE == 0)
+        {
+            fprintf(file, "    /* %04lx */", opcode);
+        }
+        fprintf(file, " {%u, %u, %u, %u, 0x%04x},", decoded.type, decoded.source, decoded.destination,
+            decoded.flags, decoded.argument);
+        if(opcode % ENTRIES_PER_LINE == ENTRIES_PER_LINE - 1)
+        {
+            fprintf(file, "\n");
+        }
+    }
+    fprintf(file, "};\n");
+
+    if(fclose(file) != 0)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,322 @@
+/**
+ * @file trace_query.c
+ * @brief Query tool for compressed execution traces
+ *
+ * Prints the records of a trace written with the emulator's -t option,
+ * optionally limited to a clock cycle range and to the instructions
+ * executed at, or the data read from or written to, given addresses.
+ * Blocks whose index entry cannot match are skipped without being read.
+ *
+ *     trace_query <trace> [-c <first cycle> <last cycle>] [-pc <address>]
+ *                 [-r <address>] [-w <address>] [-i]
+ *
+ * Addresses are hexadecimal. -i prints the block index instead of records.
+ *
+ * @author Zach Fraser
+ * @date 2024-09-07
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace_format.h"
+
+#define NO_ADDRESS -1
+
+/* Memory record access names - indexed by control_state_t */
+static const char *control_names[] = {"RD.B", "RD.W", "WR.B", "WR.W"};
+
+/**
+ * @brief Query selection
+ */
+typedef struct trace_query_t
+{
+    uint32_t first_cycle;
+    uint32_t last_cycle;
+    int pc;                 /* Execute address - NO_ADDRESS for any */
+    int read;               /* Read address - NO_ADDRESS for any */
+    int write;              /* Write address - NO_ADDRESS for any */
+} trace_query_t;
+
+/**
+ * @brief Check a memory record accessed an address
+ *
+ * @param record Memory record
+ * @param address Byte address
+ * @return int [1 = Accessed, 0 = Otherwise]
+ */
+static int record_covers(trace_record_t *record, int address)
+{
+    int word = (record->control == READ_WORD || record->control == WRITE_WORD);
+    return record->address == address || (word && (word_t)(record->address + 1) == address);
+}
+
+/**
+ * @brief Check a record is selected by the query
+ *
+ * @param query Query selection
+ * @param record Record decoded
+ * @return int [1 = Selected, 0 = Otherwise]
+ */
+static int record_selected(trace_query_t *query, trace_record_t *record)
+{
+    if(record->cycle < query->first_cycle || record->cycle > query->last_cycle)
+    {
+        return 0;
+    }
+    if(query->pc == NO_ADDRESS && query->read == NO_ADDRESS && query->write == NO_ADDRESS)
+    {
+        return 1;
+    }
+    if(record->type == TRACE_EXECUTE)
+    {
+        return record->address == query->pc;
+    }
+    if(record->control == READ_BYTE || record->control == READ_WORD)
+    {
+        return query->read != NO_ADDRESS && record_covers(record, query->read);
+    }
+    return query->write != NO_ADDRESS && record_covers(record, query->write);
+}
+
+/**
+ * @brief Check a block can hold a selected record
+ *
+ * @param query Query selection
+ * @param block Index entry
+ * @return int [1 = Read block, 0 = Skip block]
+ */
+static int block_selected(trace_query_t *query, trace_block_t *block)
+{
+    if(block->last_cycle < query->first_cycle || block->first_cycle > query->last_cycle)
+    {
+        return 0;
+    }
+    if(query->pc == NO_ADDRESS && query->read == NO_ADDRESS && query->write == NO_ADDRESS)
+    {
+        return 1;
+    }
+    return (query->pc != NO_ADDRESS && TRACE_REGION_TEST(block->pc_regions, query->pc))
+        || (query->read != NO_ADDRESS && TRACE_REGION_TEST(block->read_regions, query->read))
+        || (query->write != NO_ADDRESS && TRACE_REGION_TEST(block->write_regions, query->write));
+}
+
+/**
+ * @brief Print one record
+ *
+ * @param record Record decoded
+ */
+static void print_record(trace_record_t *record)
+{
+    if(record->type == TRACE_EXECUTE)
+    {
+        printf("%10u  #%04x  EX   %04x", record->cycle, record->address, record->value);
+    }
+    else
+    {
+        printf("%10u  #%04x  %s %04x", record->cycle, record->address, control_names[record->control], record->value);
+    }
+    for(int index = 0; index < TRACE_REGISTER_COUNT; index++)
+    {
+        if(record->register_mask & (1 << index))
+        {
+            printf("  R%d=%04x", index, record->registers[index]);
+        }
+    }
+    if(record->psw_changed)
+    {
+        printf("  PSW=%04x", record->psw);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Read the block index from the end of the trace
+ *
+ * @param file Trace file
+ * @param block_count Number of blocks read
+ * @return trace_block_t* Index - NULL on failure
+ */
+static trace_block_t *read_index(FILE *file, uint32_t *block_count)
+{
+    byte_t header[TRACE_HEADER_LENGTH];
+    byte_t trailer[TRACE_TRAILER_LENGTH];
+    if(fread(header, 1, TRACE_HEADER_LENGTH, file) != TRACE_HEADER_LENGTH
+        || memcmp(header, TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0 || header[TRACE_MAGIC_LENGTH] != TRACE_VERSION
+        || fseek(file, -TRACE_TRAILER_LENGTH, SEEK_END) != 0
+        || fread(trailer, 1, TRACE_TRAILER_LENGTH, file) != TRACE_TRAILER_LENGTH
+        || memcmp(&trailer[12], TRACE_MAGIC, TRACE_MAGIC_LENGTH) != 0)
+    {
+        return NULL;
+    }
+    *block_count = read_trace_u32(&trailer[8]);
+    trace_block_t *index = malloc((*block_count + 1) * sizeof(trace_block_t));
+    if(index == NULL || fseek(file, (long)read_trace_u64(trailer), SEEK_SET) != 0)
+    {
+        free(index);
+        return NULL;
+    }
+    byte_t entry[TRACE_INDEX_ENTRY_LENGTH];
+    for(uint32_t block = 0; block < *block_count; block++)
+    {
+        if(fread(entry, 1, TRACE_INDEX_ENTRY_LENGTH, file) != TRACE_INDEX_ENTRY_LENGTH)
+        {
+            free(index);
+            return NULL;
+        }
+        read_trace_index_entry(entry, &index[block]);
+    }
+    return index;
+}
+
+/**
+ * @brief Parse a hexadecimal address argument
+ *
+ * @param text Argument
+ * @return int [>= 0 = Address, NO_ADDRESS = Invalid]
+ */
+static int parse_address(char *text)
+{
+    char *end;
+    long address = strtol(text, &end, 16);
+    return (*end == '\0' && address >= 0 && address <= 0xFFFF) ? (int)address : NO_ADDRESS;
+}
+
+/**
+ * @brief Print the records, or the index, selected by the arguments
+ *
+ * @param argc Argument count
+ * @param argv Trace path and query options
+ * @return int [0 = SUCCESS, 1 = FAILURE]
+ */
+int main(int argc, char *argv[])
+{
+    trace_query_t query = {0, UINT32_MAX, NO_ADDRESS, NO_ADDRESS, NO_ADDRESS};
+    char *path = NULL;
+    int show_index = 0;
+    int valid = 1;
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-c") == 0 && i + 2 < argc)
+        {
+            query.first_cycle = (uint32_t)strtoul(argv[++i], NULL, 10);
+            query.last_cycle = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if(strcmp(argv[i], "-pc") == 0 && i + 1 < argc)
+        {
+            valid &= (query.pc = parse_address(argv[++i])) != NO_ADDRESS;
+        }
+        else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+        {
+            valid &= (query.read = parse_address(argv[++i])) != NO_ADDRESS;
+        }
+        else if(strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            valid &= (query.write = parse_address(argv[++i])) != NO_ADDRESS;
+        }
+        else if(strcmp(argv[i], "-i") == 0)
+        {
+            show_index = 1;
+        }
+        else if(path == NULL && argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            valid = 0;
+        }
+    }
+    if(path == NULL || !valid)
+    {
+        printf("Usage: trace_query <trace> [-c <first cycle> <last cycle>] [-pc <address>] [-r <address>] [-w <address>] [-i]\n");
+        return 1;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        printf("Unable to open %s\n", path);
+        return 1;
+    }
+    uint32_t block_count = 0;
+    trace_block_t *index = read_index(file, &block_count);
+    if(index == NULL)
+    {
+        printf("Invalid trace file\n");
+        fclose(file);
+        return 1;
+    }
+
+    if(show_index)
+    {
+        uint64_t length = 0;
+        uint64_t compressed_length = 0;
+        uint64_t records = 0;
+        for(uint32_t block = 0; block < block_count; block++)
+        {
+            trace_block_t *entry = &index[block];
+            printf("Block %u: Cycles %u - %u, %u Records, %u Bytes, %u Compressed\n", block, entry->first_cycle,
+                entry->last_cycle, entry->records, entry->length, entry->compressed_length);
+            length += entry->length;
+            compressed_length += entry->compressed_length;
+            records += entry->records;
+        }
+        printf("Total: %u Blocks, %llu Records, %llu Bytes, %llu Compressed\n", block_count,
+            (unsigned long long)records, (unsigned long long)length, (unsigned long long)compressed_length);
+        free(index);
+        fclose(file);
+        return 0;
+    }
+
+    byte_t *compressed = malloc(TRACE_COMPRESSED_MAX(TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX));
+    byte_t *buffer = malloc(TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX);
+    uint32_t blocks_read = 0;
+    uint64_t matches = 0;
+    int error_status = (compressed == NULL || buffer == NULL);
+    for(uint32_t block = 0; block < block_count && error_status == 0; block++)
+    {
+        trace_block_t *entry = &index[block];
+        if(!block_selected(&query, entry))
+        {
+            continue;
+        }
+        blocks_read++;
+        if(entry->compressed_length > TRACE_COMPRESSED_MAX(TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX)
+            || fseek(file, (long)entry->offset, SEEK_SET) != 0
+            || fread(compressed, 1, entry->compressed_length, file) != entry->compressed_length
+            || decompress_trace_block(compressed, (int)entry->compressed_length, buffer,
+                TRACE_BLOCK_LENGTH + TRACE_RECORD_MAX) != (int)entry->length)
+        {
+            printf("Corrupt block %u\n", block);
+            error_status = 1;
+            break;
+        }
+        trace_state_t state;
+        memset(&state, 0, sizeof(trace_state_t));
+        trace_record_t record;
+        for(int position = 0; position < (int)entry->length; )
+        {
+            int read = decode_trace_record(&state, &buffer[position], (int)entry->length - position, &record);
+            if(read < 0)
+            {
+                printf("Corrupt record in block %u\n", block);
+                error_status = 1;
+                break;
+            }
+            position += read;
+            if(record_selected(&query, &record))
+            {
+                print_record(&record);
+                matches++;
+            }
+        }
+    }
+    printf("Matched %llu Records, Read %u of %u Blocks\n", (unsigned long long)matches, blocks_read, block_count);
+    free(compressed);
+    free(buffer);
+    free(index);
+    fclose(file);
+    return error_status;
+}